@@ -0,0 +1,733 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "cacheinfo.h"
+#include "referencesemantics_examples.h"
+#include "rng.h"
+#include "simd.h"
+#include "snapshot.h"
+#include "streaming_examples.h"
+#include "variantsemantics_examples.h"
+
+namespace Adaptive
+{
+    using Snapshot::StrategyId;
+    using Template::ValueRecord;
+
+    constexpr bool IsIntValue(const StrategyId strategyId)
+    {
+        return strategyId == StrategyId::IncrementInt || strategyId == StrategyId::DecrementInt;
+    }
+
+    constexpr bool IsIncrement(const StrategyId strategyId)
+    {
+        return strategyId == StrategyId::IncrementInt || strategyId == StrategyId::IncrementFloat;
+    }
+
+    constexpr StrategyId GetStrategyId(const bool isIntValue, const bool isIncrement)
+    {
+        if(isIntValue)
+            return isIncrement ? StrategyId::IncrementInt : StrategyId::DecrementInt;
+
+        return isIncrement ? StrategyId::IncrementFloat : StrategyId::DecrementFloat;
+    }
+
+    std::vector<ValueRecord> CreateRandomRecords(const size_t count, Rng::Generator& generator)
+    {
+        std::vector<ValueRecord> records(count);
+        for(ValueRecord& record: records)
+        {
+            const bool isIntValue{generator.NextBool()};
+            const bool isIncrement{generator.NextBool()};
+            record.m_StrategyId = GetStrategyId(isIntValue, isIncrement);
+        }
+
+        return records;
+    }
+
+    enum class BackendId : uint8_t
+    {
+        Virtual,
+        Variant,
+        Partitioned,
+        Simd,
+        Count
+    };
+
+    constexpr std::array<BackendId, 4> BackendIds{
+        BackendId::Virtual, BackendId::Variant, BackendId::Partitioned, BackendId::Simd};
+
+    std::string GetName(const BackendId backendId)
+    {
+        switch(backendId)
+        {
+        case BackendId::Virtual:
+            return "Virtual";
+        case BackendId::Variant:
+            return "Variant";
+        case BackendId::Partitioned:
+            return "Partitioned";
+        case BackendId::Simd:
+            return "SIMD";
+        case BackendId::Count:
+            break;
+        }
+
+        return "Unknown";
+    }
+
+    // One engine holding a population. The canonical form of a population is a span of ValueRecord,
+    // Export() writes the payloads back in the order of the records passed to Import(), every record must
+    // hold a valid StrategyId.
+    class Backend
+    {
+    public:
+        virtual ~Backend() = default;
+        virtual void Import(std::span<const ValueRecord> records) = 0;
+        virtual void Export(std::span<ValueRecord> records) const = 0;
+        virtual void Operation() = 0;
+    };
+
+    // ReferenceSemantics, one virtual call per value and strategy
+    class VirtualBackend final : public Backend
+    {
+    public:
+        void Import(const std::span<const ValueRecord> records) override
+        {
+            m_Values.clear();
+            m_Values.reserve(records.size());
+            for(const ValueRecord& record: records)
+            {
+                std::unique_ptr<ReferenceSemantics::Value>& value{m_Values.emplace_back(
+                    ReferenceSemantics::CreateValue(
+                        IsIntValue(record.m_StrategyId), IsIncrement(record.m_StrategyId)))};
+                if(IsIntValue(record.m_StrategyId))
+                {
+                    static_cast<ReferenceSemantics::IntValue&>(*value).SetValue(
+                        std::bit_cast<int32_t>(record.m_Payload));
+                }
+                else
+                {
+                    static_cast<ReferenceSemantics::FloatValue&>(*value).SetValue(
+                        std::bit_cast<float_t>(record.m_Payload));
+                }
+            }
+        }
+
+        void Export(const std::span<ValueRecord> records) const override
+        {
+            for(size_t i{0}; i != records.size(); ++i)
+            {
+                const ReferenceSemantics::Value& value{*m_Values[i]};
+                records[i].m_Payload = IsIntValue(records[i].m_StrategyId) ?
+                    std::bit_cast<uint32_t>(
+                        static_cast<const ReferenceSemantics::IntValue&>(value).GetValue()) :
+                    std::bit_cast<uint32_t>(
+                        static_cast<const ReferenceSemantics::FloatValue&>(value).GetValue());
+            }
+        }
+
+        void Operation() override
+        {
+            for(const std::unique_ptr<ReferenceSemantics::Value>& value: m_Values)
+            {
+                value->Operation();
+            }
+        }
+    private:
+        std::vector<std::unique_ptr<ReferenceSemantics::Value>> m_Values{};
+    };
+
+    // VariantSemantics, values stored contiguously and dispatched by std::visit
+    class VariantBackend final : public Backend
+    {
+    public:
+        void Import(const std::span<const ValueRecord> records) override
+        {
+            m_Values.clear();
+            m_Values.reserve(records.size());
+            for(const ValueRecord& record: records)
+            {
+                VariantSemantics::Value& value{m_Values.emplace_back(
+                    VariantSemantics::CreateValue(
+                        IsIntValue(record.m_StrategyId), IsIncrement(record.m_StrategyId)))};
+                if(IsIntValue(record.m_StrategyId))
+                {
+                    std::get<VariantSemantics::IntValue>(value).SetValue(
+                        std::bit_cast<int32_t>(record.m_Payload));
+                }
+                else
+                {
+                    std::get<VariantSemantics::FloatValue>(value).SetValue(
+                        std::bit_cast<float_t>(record.m_Payload));
+                }
+            }
+        }
+
+        void Export(const std::span<ValueRecord> records) const override
+        {
+            for(size_t i{0}; i != records.size(); ++i)
+            {
+                records[i].m_Payload = IsIntValue(records[i].m_StrategyId) ?
+                    std::bit_cast<uint32_t>(std::get<VariantSemantics::IntValue>(m_Values[i]).GetValue()) :
+                    std::bit_cast<uint32_t>(std::get<VariantSemantics::FloatValue>(m_Values[i]).GetValue());
+            }
+        }
+
+        void Operation() override
+        {
+            for(VariantSemantics::Value& value: m_Values)
+            {
+                VariantSemantics::Operation(value);
+            }
+        }
+    private:
+        std::vector<VariantSemantics::Value> m_Values{};
+    };
+
+    // Structure of Arrays, one payload column per StrategyId applied with the given instruction set
+    // (Scalar for the Partitioned backend, the best supported one for the SIMD backend)
+    class PartitionedBackend final : public Backend
+    {
+    public:
+        explicit PartitionedBackend(const Simd::InstructionSet instructionSet)
+            : m_InstructionSet{instructionSet}
+        {
+        }
+
+        void Import(const std::span<const ValueRecord> records) override
+        {
+            for(std::vector<int32_t>& partition: m_IntPartitions)
+            {
+                partition.clear();
+            }
+
+            for(std::vector<float_t>& partition: m_FloatPartitions)
+            {
+                partition.clear();
+            }
+
+            for(const ValueRecord& record: records)
+            {
+                if(IsIntValue(record.m_StrategyId))
+                    GetIntPartition(record.m_StrategyId).push_back(std::bit_cast<int32_t>(record.m_Payload));
+                else
+                    GetFloatPartition(record.m_StrategyId).push_back(
+                        std::bit_cast<float_t>(record.m_Payload));
+            }
+        }
+
+        void Export(const std::span<ValueRecord> records) const override
+        {
+            std::array<size_t, static_cast<size_t>(StrategyId::Count)> offsets{};
+            for(ValueRecord& record: records)
+            {
+                const size_t offset{offsets[static_cast<size_t>(record.m_StrategyId)]++};
+                record.m_Payload = IsIntValue(record.m_StrategyId) ?
+                    std::bit_cast<uint32_t>(GetIntPartition(record.m_StrategyId)[offset]) :
+                    std::bit_cast<uint32_t>(GetFloatPartition(record.m_StrategyId)[offset]);
+            }
+        }
+
+        void Operation() override
+        {
+            Simd::Add(std::span<int32_t>{GetIntPartition(StrategyId::IncrementInt)}, 1, m_InstructionSet);
+            Simd::Add(std::span<int32_t>{GetIntPartition(StrategyId::DecrementInt)}, -1, m_InstructionSet);
+            Simd::Add(
+                std::span<float_t>{GetFloatPartition(StrategyId::IncrementFloat)}, 1.0f, m_InstructionSet);
+            Simd::Add(
+                std::span<float_t>{GetFloatPartition(StrategyId::DecrementFloat)}, -1.0f, m_InstructionSet);
+        }
+    private:
+        // Typed columns, payload bits are only reinterpreted with std::bit_cast at the ValueRecord boundary
+        std::vector<int32_t>& GetIntPartition(const StrategyId strategyId)
+        {
+            return m_IntPartitions[strategyId == StrategyId::IncrementInt ? 0 : 1];
+        }
+
+        const std::vector<int32_t>& GetIntPartition(const StrategyId strategyId) const
+        {
+            return m_IntPartitions[strategyId == StrategyId::IncrementInt ? 0 : 1];
+        }
+
+        std::vector<float_t>& GetFloatPartition(const StrategyId strategyId)
+        {
+            return m_FloatPartitions[strategyId == StrategyId::IncrementFloat ? 0 : 1];
+        }
+
+        const std::vector<float_t>& GetFloatPartition(const StrategyId strategyId) const
+        {
+            return m_FloatPartitions[strategyId == StrategyId::IncrementFloat ? 0 : 1];
+        }
+
+        Simd::InstructionSet m_InstructionSet{Simd::InstructionSet::Scalar};
+        std::array<std::vector<int32_t>, 2> m_IntPartitions{};
+        std::array<std::vector<float_t>, 2> m_FloatPartitions{};
+    };
+
+    std::unique_ptr<Backend> CreateBackend(const BackendId backendId)
+    {
+        switch(backendId)
+        {
+        case BackendId::Virtual:
+            return std::make_unique<VirtualBackend>();
+        case BackendId::Variant:
+            return std::make_unique<VariantBackend>();
+        case BackendId::Partitioned:
+            return std::make_unique<PartitionedBackend>(Simd::InstructionSet::Scalar);
+        case BackendId::Simd:
+            return std::make_unique<PartitionedBackend>(Simd::GetInstructionSet());
+        case BackendId::Count:
+            break;
+        }
+
+        return nullptr;
+    }
+
+    // Populations with the same ProfileKey are expected to prefer the same backend:
+    // the share of every StrategyId in eighths, and the population size rounded down to a power of 2
+    struct ProfileKey
+    {
+        std::array<uint8_t, static_cast<size_t>(StrategyId::Count)> m_Mix{};
+        uint8_t m_SizeBucket{0};
+
+        auto operator<=>(const ProfileKey&) const = default;
+    };
+
+    ProfileKey GetProfileKey(const std::span<const ValueRecord> records)
+    {
+        std::array<size_t, static_cast<size_t>(StrategyId::Count)> counts{};
+        for(const ValueRecord& record: records)
+        {
+            ++counts[static_cast<size_t>(record.m_StrategyId)];
+        }
+
+        ProfileKey key{};
+        for(size_t i{0}; i != counts.size(); ++i)
+        {
+            key.m_Mix[i] = static_cast<uint8_t>(
+                (counts[i] * 8 + records.size() / 2) / std::max<size_t>(records.size(), 1));
+        }
+
+        key.m_SizeBucket = static_cast<uint8_t>(std::bit_width(records.size()));
+        return key;
+    }
+
+    // Winning backend per ProfileKey, shared by all executors of a process.
+    // Thread safe, a concurrent probe of the same key keeps the result stored last.
+    class ProfileCache
+    {
+    public:
+        std::optional<BackendId> Find(const ProfileKey& key) const
+        {
+            const std::scoped_lock lock{m_Mutex};
+            if(const auto iterator{m_ForcedBackends.find(key)}; iterator != m_ForcedBackends.end())
+                return iterator->second;
+
+            const auto iterator{m_Backends.find(key)};
+            if(iterator == m_Backends.end())
+                return std::nullopt;
+
+            return iterator->second;
+        }
+
+        std::optional<BackendId> FindForced(const ProfileKey& key) const
+        {
+            const std::scoped_lock lock{m_Mutex};
+            const auto iterator{m_ForcedBackends.find(key)};
+            if(iterator == m_ForcedBackends.end())
+                return std::nullopt;
+
+            return iterator->second;
+        }
+
+        // Executors of the key use backendId instead of probing, from their next construction or re-probe.
+        // std::nullopt returns the key to probing.
+        void Force(const ProfileKey& key, const std::optional<BackendId> backendId)
+        {
+            const std::scoped_lock lock{m_Mutex};
+            if(backendId)
+                m_ForcedBackends.insert_or_assign(key, *backendId);
+            else
+                m_ForcedBackends.erase(key);
+        }
+
+        void Store(const ProfileKey& key, const BackendId backendId)
+        {
+            const std::scoped_lock lock{m_Mutex};
+            m_Backends.insert_or_assign(key, backendId);
+            ++m_ProbeCount;
+        }
+
+        size_t GetProbeCount() const
+        {
+            const std::scoped_lock lock{m_Mutex};
+            return m_ProbeCount;
+        }
+    private:
+        mutable std::mutex m_Mutex{};
+        std::map<ProfileKey, BackendId> m_Backends{};
+        std::map<ProfileKey, BackendId> m_ForcedBackends{};
+        size_t m_ProbeCount{0};
+    };
+
+    ProfileCache& GetDefaultProfileCache()
+    {
+        static ProfileCache profileCache{};
+        return profileCache;
+    }
+
+    struct AdaptiveOptions
+    {
+        // Every backend is timed on an evenly strided sample of the population size rounded down to a power
+        // of 2, the lower bound of its size bucket. A population beyond the last level cache is probed on a
+        // sample just beyond it (twice its size in payloads) rather than on its whole size bucket,
+        // m_MaxSampleSize bounds the probe cost and memory on top of that.
+        size_t m_MaxSampleSize{size_t{1} << 22};
+        // Operation() calls per timed repetition, the fastest of m_ProbeRepetitionCount repetitions counts
+        uint32_t m_ProbeOperationCount{4};
+        uint32_t m_ProbeRepetitionCount{3};
+        // Operation() calls between re-probes of the current backend against one challenger, 0 keeps the
+        // first backend
+        uint32_t m_ReprobeInterval{1'024};
+    };
+
+    size_t GetSampleSize(const size_t recordCount, const AdaptiveOptions& options,
+        const CacheInfo::CacheSizes& cacheSizes = CacheInfo::GetCacheSizes())
+    {
+        const size_t beyondLastLevelCount{
+            std::bit_ceil(2 * cacheSizes.m_LastLevel / sizeof(ValueRecord::m_Payload))};
+        return std::min({std::bit_floor(recordCount), beyondLastLevelCount, options.m_MaxSampleSize});
+    }
+
+    // Runs a population on the backend that was fastest for its ProfileKey on this machine.
+    // An unknown key is probed on first use: every backend imports the same sample and the one with the
+    // lowest Operation() time wins. Every m_ReprobeInterval operations the current backend is timed against
+    // one challenger, the other backends in turn, if the challenger wins the population is exported from the
+    // current backend and imported into it. The backends holding the sample are kept, so a re-probe imports
+    // nothing after each backend was timed once. A backend forced in the ProfileCache replaces the probe.
+    class AdaptiveExecutor
+    {
+    public:
+        explicit AdaptiveExecutor(
+            const std::span<const ValueRecord> records,
+            const AdaptiveOptions& options = {},
+            ProfileCache& profileCache = GetDefaultProfileCache())
+            : m_Options{options}
+            , m_ProfileCache{profileCache}
+            , m_Records{records.begin(), records.end()}
+            , m_ProfileKey{Adaptive::GetProfileKey(records)}
+        {
+            // Only the strategy ids of the sample matter for the timing, stale payloads are fine
+            const size_t sampleSize{GetSampleSize(m_Records.size(), m_Options)};
+            m_Sample.resize(sampleSize);
+            for(size_t i{0}; i != sampleSize; ++i)
+            {
+                m_Sample[i] = m_Records[i * m_Records.size() / sampleSize];
+            }
+
+            const std::optional<BackendId> backendId{m_ProfileCache.Find(m_ProfileKey)};
+            SetBackend(backendId ? *backendId : Probe());
+        }
+
+        void Operation()
+        {
+            m_Backend->Operation();
+            if(m_Options.m_ReprobeInterval != 0 && ++m_OperationCount % m_Options.m_ReprobeInterval == 0)
+            {
+                const std::optional<BackendId> forcedBackendId{m_ProfileCache.FindForced(m_ProfileKey)};
+                const BackendId backendId{forcedBackendId ? *forcedBackendId : Reprobe()};
+                if(backendId != m_BackendId)
+                {
+                    m_Backend->Export(m_Records);
+                    SetBackend(backendId);
+                }
+            }
+        }
+
+        // The population in its canonical form, in the order it was passed in
+        std::span<const ValueRecord> Export()
+        {
+            m_Backend->Export(m_Records);
+            return m_Records;
+        }
+
+        BackendId GetBackendId() const { return m_BackendId; }
+        const ProfileKey& GetProfileKey() const { return m_ProfileKey; }
+    private:
+        void SetBackend(const BackendId backendId)
+        {
+            m_BackendId = backendId;
+            m_Backend = CreateBackend(backendId);
+            m_Backend->Import(m_Records);
+        }
+
+        // Backend holding the sample, imported and warmed up on first use
+        Backend& GetProbeBackend(const BackendId backendId)
+        {
+            std::unique_ptr<Backend>& backend{m_ProbeBackends[static_cast<size_t>(backendId)]};
+            if(!backend)
+            {
+                backend = CreateBackend(backendId);
+                backend->Import(m_Sample);
+                backend->Operation();
+            }
+
+            return *backend;
+        }
+
+        // Fastest of m_ProbeRepetitionCount timed repetitions
+        std::chrono::steady_clock::duration Time(Backend& backend) const
+        {
+            auto fastestDuration{std::chrono::steady_clock::duration::max()};
+            for(uint32_t repetition{0}; repetition != m_Options.m_ProbeRepetitionCount; ++repetition)
+            {
+                const auto start{std::chrono::steady_clock::now()};
+                for(uint32_t operation{0}; operation != m_Options.m_ProbeOperationCount; ++operation)
+                {
+                    backend.Operation();
+                }
+
+                fastestDuration = std::min(fastestDuration, std::chrono::steady_clock::now() - start);
+            }
+
+            return fastestDuration;
+        }
+
+        BackendId Probe()
+        {
+            BackendId fastestBackendId{BackendId::Simd};
+            auto fastestDuration{std::chrono::steady_clock::duration::max()};
+            for(const BackendId backendId: BackendIds)
+            {
+                const auto duration{Time(GetProbeBackend(backendId))};
+                if(duration < fastestDuration)
+                {
+                    fastestDuration = duration;
+                    fastestBackendId = backendId;
+                }
+            }
+
+            m_ProfileCache.Store(m_ProfileKey, fastestBackendId);
+            return fastestBackendId;
+        }
+
+        BackendId Reprobe()
+        {
+            m_ChallengerIndex = (m_ChallengerIndex + 1) % BackendIds.size();
+            if(BackendIds[m_ChallengerIndex] == m_BackendId)
+                m_ChallengerIndex = (m_ChallengerIndex + 1) % BackendIds.size();
+
+            const BackendId challengerId{BackendIds[m_ChallengerIndex]};
+            const bool isChallengerFaster{
+                Time(GetProbeBackend(challengerId)) < Time(GetProbeBackend(m_BackendId))};
+            const BackendId fastestBackendId{isChallengerFaster ? challengerId : m_BackendId};
+            m_ProfileCache.Store(m_ProfileKey, fastestBackendId);
+            return fastestBackendId;
+        }
+
+        const AdaptiveOptions m_Options;
+        ProfileCache& m_ProfileCache;
+        std::vector<ValueRecord> m_Records{};
+        const ProfileKey m_ProfileKey;
+        BackendId m_BackendId{BackendId::Simd};
+        std::unique_ptr<Backend> m_Backend{};
+        uint32_t m_OperationCount{0};
+        // Evenly strided sample of m_Records and the backends holding it, indexed by BackendId
+        std::vector<ValueRecord> m_Sample{};
+        std::array<std::unique_ptr<Backend>, BackendIds.size()> m_ProbeBackends{};
+        size_t m_ChallengerIndex{0};
+    };
+
+    TEST_CASE("Strategy - Adaptive - Unit Tests")
+    {
+        Rng::Generator generator{};
+        const std::vector<ValueRecord> records{CreateRandomRecords(1'000, generator)};
+
+        // Reference: Template::ValueCollection keeps one partition per StrategyId
+        Template::ValueCollection collection{};
+        for(const ValueRecord& record: records)
+        {
+            Template::AddRecord(collection, record);
+        }
+
+        collection.Operation();
+        collection.Operation();
+        collection.Operation();
+        const auto requireExpected{
+            [&collection](const std::span<const ValueRecord> actual)
+            {
+                Template::ValueCollection actualCollection{};
+                for(const ValueRecord& record: actual)
+                {
+                    Template::AddRecord(actualCollection, record);
+                }
+
+                Template::SumValueSink expected{};
+                expected.Write(collection);
+                Template::SumValueSink sink{};
+                sink.Write(actualCollection);
+                REQUIRE(sink.GetSum() == expected.GetSum());
+
+                using DecrementFloatValue =
+                    Template::FloatValue<Template::DecrementFloatValueOperationStrategy>;
+                const auto expectedValues{collection.GetPartition<DecrementFloatValue>().GetValues()};
+                const auto actualValues{actualCollection.GetPartition<DecrementFloatValue>().GetValues()};
+                REQUIRE(std::ranges::equal(expectedValues, actualValues));
+            }};
+
+        SECTION("Every backend computes the same values")
+        {
+            for(const BackendId backendId: BackendIds)
+            {
+                const std::unique_ptr<Backend> backend{CreateBackend(backendId)};
+                backend->Import(records);
+                backend->Operation();
+                backend->Operation();
+                backend->Operation();
+
+                std::vector<ValueRecord> exported{records};
+                backend->Export(exported);
+                requireExpected(exported);
+            }
+        }
+
+        SECTION("Switching backends keeps the values")
+        {
+            ProfileCache profileCache{};
+            const ProfileKey key{GetProfileKey(records)};
+            profileCache.Force(key, BackendId::Virtual);
+            AdaptiveExecutor executor{records, AdaptiveOptions{.m_ReprobeInterval = 1}, profileCache};
+            REQUIRE(executor.GetBackendId() == BackendId::Virtual);
+
+            // Every Operation() re-probes and switches to the backend forced before it
+            for(const BackendId backendId: {BackendId::Variant, BackendId::Partitioned, BackendId::Simd})
+            {
+                profileCache.Force(key, backendId);
+                executor.Operation();
+                REQUIRE(executor.GetBackendId() == backendId);
+            }
+
+            REQUIRE(profileCache.GetProbeCount() == 0);
+            requireExpected(executor.Export());
+
+            profileCache.Force(key, std::nullopt);
+            REQUIRE(profileCache.FindForced(key) == std::nullopt);
+        }
+
+        SECTION("Re-probing keeps the values")
+        {
+            ProfileCache profileCache{};
+            AdaptiveExecutor executor{
+                records, AdaptiveOptions{.m_MaxSampleSize = 64, .m_ReprobeInterval = 1}, profileCache};
+            executor.Operation();
+            executor.Operation();
+            executor.Operation();
+            REQUIRE(profileCache.GetProbeCount() == 4);
+            requireExpected(executor.Export());
+        }
+
+        SECTION("Winners are cached per ProfileKey")
+        {
+            ProfileCache profileCache{};
+            const AdaptiveOptions options{.m_ReprobeInterval = 0};
+            const AdaptiveExecutor executor{records, options, profileCache};
+            REQUIRE(profileCache.Find(executor.GetProfileKey()) == executor.GetBackendId());
+
+            // Same mix and size bucket, different order
+            std::vector<ValueRecord> reversedRecords{records.rbegin(), records.rend()};
+            const AdaptiveExecutor reversedExecutor{reversedRecords, options, profileCache};
+            REQUIRE(reversedExecutor.GetBackendId() == executor.GetBackendId());
+            REQUIRE(profileCache.GetProbeCount() == 1);
+
+            const std::vector<ValueRecord> largerRecords{CreateRandomRecords(10'000, generator)};
+            const AdaptiveExecutor largerExecutor{largerRecords, options, profileCache};
+            REQUIRE(largerExecutor.GetProfileKey() != executor.GetProfileKey());
+            REQUIRE(profileCache.GetProbeCount() == 2);
+        }
+
+        SECTION("ProfileKey")
+        {
+            const std::vector<ValueRecord> intRecords(
+                100, ValueRecord{.m_StrategyId = StrategyId::IncrementInt});
+            const ProfileKey key{GetProfileKey(intRecords)};
+            REQUIRE(key.m_Mix == std::array<uint8_t, 4>{8, 0, 0, 0});
+            REQUIRE(key.m_SizeBucket == 7);
+            REQUIRE(GetProfileKey(std::span<const ValueRecord>{}).m_SizeBucket == 0);
+        }
+
+        SECTION("The probe sample scales with the size bucket")
+        {
+            const CacheInfo::CacheSizes cacheSizes{.m_LastLevel = 32 * 1024 * 1024};
+            REQUIRE(GetSampleSize(1'000'000, {}, cacheSizes) == 512 * 1024);
+            REQUIRE(GetSampleSize(1'000, {}, cacheSizes) == 512);
+            REQUIRE(GetSampleSize(0, {}, cacheSizes) == 0);
+            REQUIRE(GetSampleSize(1'000'000, {.m_MaxSampleSize = 64}, cacheSizes) == 64);
+
+            // Beyond the last level cache the sample only needs to be beyond it as well
+            const CacheInfo::CacheSizes smallCacheSizes{.m_LastLevel = 1024 * 1024};
+            const CacheInfo::CacheSizes tinyCacheSizes{.m_LastLevel = 256 * 1024};
+            REQUIRE(GetSampleSize(1'000'000, {}, smallCacheSizes) == 512 * 1024);
+            REQUIRE(GetSampleSize(1'000'000, {}, tinyCacheSizes) == 128 * 1024);
+            REQUIRE(GetSampleSize(100'000'000, {}, cacheSizes) == size_t{1} << 22);
+        }
+    }
+
+    TEST_CASE("Strategy - Adaptive - Benchmark")
+    {
+        constexpr uint32_t operationCount{16};
+        for(const size_t valueCount: {1'000u, 100'000u, 1'000'000u})
+        {
+            Rng::Generator generator{};
+            const std::vector<ValueRecord> records{CreateRandomRecords(valueCount, generator)};
+            const std::string suffix{" - " + std::to_string(valueCount)};
+
+            for(const BackendId backendId: BackendIds)
+            {
+                BENCHMARK_ADVANCED(GetName(backendId) + suffix)(Catch::Benchmark::Chronometer meter)
+                {
+                    const std::unique_ptr<Backend> backend{CreateBackend(backendId)};
+                    backend->Import(records);
+                    meter.measure(
+                        [&backend]()
+                        {
+                            for(uint32_t operation{0}; operation != operationCount; ++operation)
+                            {
+                                backend->Operation();
+                            }
+                        });
+                };
+            }
+
+            BENCHMARK_ADVANCED("Adaptive" + suffix)(Catch::Benchmark::Chronometer meter)
+            {
+                AdaptiveExecutor executor{records};
+                meter.measure(
+                    [&executor]()
+                    {
+                        for(uint32_t operation{0}; operation != operationCount; ++operation)
+                        {
+                            executor.Operation();
+                        }
+                    });
+            };
+        }
+    }
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Counts heap allocations made through the global operator new/delete.
+// Tracking is compiled in when STRATEGY_PATTERN_TRACK_ALLOCATIONS is defined (the Debug configurations),
+// main.cpp then replaces the global operators with ones that forward to Detail::Allocate/Deallocate.
+// Every allocation carries a small header with its size, so live bytes are exact even for unsized deletes.
+namespace AllocationTracking
+{
+#if defined(STRATEGY_PATTERN_TRACK_ALLOCATIONS)
+    constexpr bool IsEnabled{true};
+#else
+    constexpr bool IsEnabled{false};
+#endif
+
+    struct AllocationStats
+    {
+        uint64_t m_AllocationCount{0};
+        uint64_t m_DeallocationCount{0};
+        uint64_t m_AllocatedBytes{0};
+        // Highest number of bytes allocated in the scope and alive at the same time
+        uint64_t m_PeakLiveBytes{0};
+    };
+
+    namespace Detail
+    {
+        struct Header
+        {
+            void* m_Allocation;
+            size_t m_Size;
+        };
+
+        inline std::atomic<uint64_t> AllocationCount{0};
+        inline std::atomic<uint64_t> DeallocationCount{0};
+        inline std::atomic<uint64_t> AllocatedBytes{0};
+        inline std::atomic<uint64_t> LiveBytes{0};
+        inline std::atomic<uint64_t> PeakLiveBytes{0};
+
+        // [padding][Header][object aligned to alignment]
+        inline void* Allocate(const size_t size, const size_t alignment)
+        {
+            const size_t objectAlignment{std::max(alignment, alignof(std::max_align_t))};
+            void* const allocation{std::malloc(size + sizeof(Header) + objectAlignment)};
+            if(!allocation)
+                return nullptr;
+
+            const uintptr_t object{(reinterpret_cast<uintptr_t>(allocation) + sizeof(Header) + objectAlignment - 1) &
+                ~static_cast<uintptr_t>(objectAlignment - 1)};
+            Header* const header{reinterpret_cast<Header*>(object) - 1};
+            header->m_Allocation = allocation;
+            header->m_Size = size;
+
+            AllocationCount.fetch_add(1, std::memory_order_relaxed);
+            AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+            const uint64_t liveBytes{LiveBytes.fetch_add(size, std::memory_order_relaxed) + size};
+            uint64_t peakLiveBytes{PeakLiveBytes.load(std::memory_order_relaxed)};
+            while(liveBytes > peakLiveBytes &&
+                !PeakLiveBytes.compare_exchange_weak(peakLiveBytes, liveBytes, std::memory_order_relaxed))
+            {
+            }
+
+            return reinterpret_cast<void*>(object);
+        }
+
+        inline void Deallocate(void* const object)
+        {
+            if(!object)
+                return;
+
+            const Header* const header{static_cast<const Header*>(object) - 1};
+            DeallocationCount.fetch_add(1, std::memory_order_relaxed);
+            LiveBytes.fetch_sub(header->m_Size, std::memory_order_relaxed);
+            std::free(header->m_Allocation);
+        }
+    }
+
+    // Allocations of all threads between construction and GetStats().
+    // Scopes do not nest, a scope restarts the peak live bytes measurement of any enclosing scope.
+    class Scope
+    {
+    public:
+        Scope()
+            : m_AllocationCount{Detail::AllocationCount.load(std::memory_order_relaxed)}
+            , m_DeallocationCount{Detail::DeallocationCount.load(std::memory_order_relaxed)}
+            , m_AllocatedBytes{Detail::AllocatedBytes.load(std::memory_order_relaxed)}
+            , m_LiveBytes{Detail::LiveBytes.load(std::memory_order_relaxed)}
+        {
+            Detail::PeakLiveBytes.store(m_LiveBytes, std::memory_order_relaxed);
+        }
+
+        AllocationStats GetStats() const
+        {
+            const uint64_t peakLiveBytes{Detail::PeakLiveBytes.load(std::memory_order_relaxed)};
+            return AllocationStats{
+                .m_AllocationCount = Detail::AllocationCount.load(std::memory_order_relaxed) - m_AllocationCount,
+                .m_DeallocationCount = Detail::DeallocationCount.load(std::memory_order_relaxed) - m_DeallocationCount,
+                .m_AllocatedBytes = Detail::AllocatedBytes.load(std::memory_order_relaxed) - m_AllocatedBytes,
+                .m_PeakLiveBytes = peakLiveBytes > m_LiveBytes ? peakLiveBytes - m_LiveBytes : 0};
+        }
+    private:
+        uint64_t m_AllocationCount{0};
+        uint64_t m_DeallocationCount{0};
+        uint64_t m_AllocatedBytes{0};
+        uint64_t m_LiveBytes{0};
+    };
+
+    // Allocations per run of each benchmark of a test case, printed next to the benchmark names when the report
+    // goes out of scope. Catch2 runs a benchmark many times and every run opens its own Scope through Track(),
+    // so counts and bytes are averages per run and the peak is the highest of any run.
+    // Without STRATEGY_PATTERN_TRACK_ALLOCATIONS nothing is measured or printed.
+    class BenchmarkReport
+    {
+    public:
+        class RunScope
+        {
+        public:
+            RunScope(BenchmarkReport& report, const std::string_view name)
+                : m_Report{report}
+                , m_Name{name}
+            {
+                if constexpr(IsEnabled)
+                    m_Scope.emplace();
+            }
+
+            RunScope(const RunScope&) = delete;
+            RunScope& operator=(const RunScope&) = delete;
+
+            ~RunScope()
+            {
+                if(m_Scope)
+                    m_Report.Add(m_Name, m_Scope->GetStats());
+            }
+        private:
+            BenchmarkReport& m_Report;
+            std::string_view m_Name{};
+            std::optional<Scope> m_Scope{};
+        };
+
+        BenchmarkReport() = default;
+        BenchmarkReport(const BenchmarkReport&) = delete;
+        BenchmarkReport& operator=(const BenchmarkReport&) = delete;
+
+        ~BenchmarkReport()
+        {
+            if(m_Entries.empty())
+                return;
+
+            std::cout << "\nAllocations per benchmark run:\n";
+            for(const Entry& entry: m_Entries)
+            {
+                const double runCount{static_cast<double>(entry.m_RunCount)};
+                std::cout << std::left << std::setw(32) << entry.m_Name << std::fixed << std::setprecision(2)
+                    << "allocations/run " << entry.m_Stats.m_AllocationCount / runCount
+                    << ", bytes/run " << entry.m_Stats.m_AllocatedBytes / runCount
+                    << ", peak live bytes " << entry.m_Stats.m_PeakLiveBytes << '\n';
+            }
+        }
+
+        // Measures the rest of the enclosing block as one run of the benchmark name
+        [[nodiscard]] RunScope Track(const std::string_view name)
+        {
+            return RunScope{*this, name};
+        }
+    private:
+        struct Entry
+        {
+            std::string m_Name{};
+            uint64_t m_RunCount{0};
+            // Sums over all runs, except the peak which is the highest of a single run
+            AllocationStats m_Stats{};
+        };
+
+        void Add(const std::string_view name, const AllocationStats& stats)
+        {
+            auto it{std::ranges::find(m_Entries, name, &Entry::m_Name)};
+            if(it == m_Entries.end())
+                it = m_Entries.insert(m_Entries.end(), Entry{.m_Name = std::string{name}});
+
+            ++it->m_RunCount;
+            it->m_Stats.m_AllocationCount += stats.m_AllocationCount;
+            it->m_Stats.m_DeallocationCount += stats.m_DeallocationCount;
+            it->m_Stats.m_AllocatedBytes += stats.m_AllocatedBytes;
+            it->m_Stats.m_PeakLiveBytes = std::max(it->m_Stats.m_PeakLiveBytes, stats.m_PeakLiveBytes);
+        }
+
+        std::vector<Entry> m_Entries{};
+    };
+}
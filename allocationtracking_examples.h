@@ -0,0 +1,135 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <vector>
+
+#include "allocationtracking.h"
+#include "benchmarksuite_examples.h"
+
+namespace AllocationTracking
+{
+    template<typename TCallable>
+    AllocationStats Track(TCallable&& callable)
+    {
+        const Scope scope{};
+        callable();
+        return scope.GetStats();
+    }
+
+    // Allocations of creating a single value of every kind through the factory function
+    template<typename TValue>
+    AllocationStats TrackCreateValue(TValue (*const createValue)(bool, bool))
+    {
+        return Track(
+            [createValue]()
+            {
+                for(const bool isIntValue: {true, false})
+                {
+                    for(const bool isIncrement: {true, false})
+                    {
+                        const TValue value{createValue(isIntValue, isIncrement)};
+                    }
+                }
+            });
+    }
+
+    template<typename TEngine>
+    void ReportEngine(const std::vector<BenchmarkSuite::ValueKind>& valueKinds)
+    {
+        const AllocationStats stats{Track(
+            [&valueKinds]()
+            {
+                const typename TEngine::Population population{TEngine::Create(valueKinds)};
+            })};
+
+        const double valueCount{static_cast<double>(valueKinds.size())};
+        std::cout << std::left << std::setw(24) << TEngine::Name << std::fixed << std::setprecision(2)
+            << "allocations/value " << stats.m_AllocationCount / valueCount
+            << ", bytes/value " << stats.m_AllocatedBytes / valueCount
+            << ", peak live bytes " << stats.m_PeakLiveBytes << '\n';
+    }
+
+    TEST_CASE("Strategy - Allocation Tracking - Unit Tests")
+    {
+        if constexpr(!IsEnabled)
+        {
+            // Without STRATEGY_PATTERN_TRACK_ALLOCATIONS nothing is counted
+            const AllocationStats stats{Track([](){ const std::vector<int32_t> values(100); })};
+            REQUIRE(stats.m_AllocationCount == 0);
+            REQUIRE(stats.m_PeakLiveBytes == 0);
+            return;
+        }
+
+        SECTION("Scope")
+        {
+            const AllocationStats stats{Track(
+                []()
+                {
+                    const std::vector<int32_t> first(100);
+                    {
+                        const std::vector<int32_t> second(50);
+                    }
+
+                    const std::vector<int32_t> third(10);
+                })};
+
+            REQUIRE(stats.m_AllocationCount == 3);
+            REQUIRE(stats.m_DeallocationCount == 3);
+            REQUIRE(stats.m_AllocatedBytes == 160 * sizeof(int32_t));
+            REQUIRE(stats.m_PeakLiveBytes == 150 * sizeof(int32_t));
+        }
+
+        SECTION("Factory Functions")
+        {
+            // Value and strategy
+            REQUIRE(TrackCreateValue(&ReferenceSemantics::CreateValue).m_AllocationCount == 2 * 4);
+            // Value only, both strategies are empty callables and fit into the std::function small buffer
+            REQUIRE(TrackCreateValue(&ValueSemantics::CreateValue).m_AllocationCount == 4);
+            REQUIRE(TrackCreateValue(&InlineValueSemantics::CreateValue).m_AllocationCount == 4);
+            REQUIRE(TrackCreateValue(&Template::CreateValue).m_AllocationCount == 4);
+            REQUIRE(TrackCreateValue(&ExternalPolymorphism::CreateValue).m_AllocationCount == 0);
+            REQUIRE(TrackCreateValue(&VariantSemantics::CreateValue).m_AllocationCount == 0);
+
+            REQUIRE(Track([](){ const auto value{ReferenceSemantics::CreateRandomFlyweightValue()}; })
+                .m_AllocationCount == 1);
+        }
+
+        SECTION("Arena Allocation")
+        {
+            std::array<std::byte, 1024> buffer{};
+            std::pmr::monotonic_buffer_resource memoryResource{
+                buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+            const AllocationStats stats{Track(
+                [&memoryResource]()
+                {
+                    const Arena::UniquePtr<ReferenceSemantics::Value> referenceValue{
+                        ReferenceSemantics::CreateRandomValue(memoryResource)};
+                    const Arena::UniquePtr<Template::Value> templateValue{Template::CreateRandomValue(memoryResource)};
+                })};
+
+            REQUIRE(stats.m_AllocationCount == 0);
+        }
+    }
+
+    // Prints allocations per value for every engine, build with STRATEGY_PATTERN_TRACK_ALLOCATIONS and
+    // run with "[allocations]"
+    TEST_CASE("Strategy - Allocation Tracking - Report", "[.][allocations]")
+    {
+        const std::vector<BenchmarkSuite::ValueKind> valueKinds{BenchmarkSuite::CreateValueKinds(10'000, 50)};
+        std::cout << valueKinds.size() << " values" << (IsEnabled ? "" : " (allocation tracking disabled)") << ":\n";
+
+        ReportEngine<BenchmarkSuite::ReferenceSemanticsEngine>(valueKinds);
+        ReportEngine<BenchmarkSuite::ValueSemanticsEngine>(valueKinds);
+        ReportEngine<BenchmarkSuite::InlineValueSemanticsEngine>(valueKinds);
+        ReportEngine<BenchmarkSuite::TemplateEngine>(valueKinds);
+        ReportEngine<BenchmarkSuite::ExternalPolymorphismEngine>(valueKinds);
+        ReportEngine<BenchmarkSuite::VariantSemanticsEngine>(valueKinds);
+        ReportEngine<BenchmarkSuite::StrategyCollectionEngine>(valueKinds);
+    }
+}
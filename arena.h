@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace Arena
+{
+    enum class Ownership : uint8_t
+    {
+        // Deleted with delete
+        Heap,
+        // Only destroyed, the memory is released in bulk by the memory resource
+        Arena,
+        // Owned elsewhere (e.g. flyweights), not released at all
+        Shared
+    };
+
+    // Owning pointer like std::unique_ptr<T> that releases objects either back to the heap or, for objects
+    // created from a memory resource, only destroys them and leaves the memory to the memory resource.
+    // The Ownership is kept in the two low bits of the pointer, so a UniquePtr is exactly as large as a
+    // std::unique_ptr<T> and the heap path pays nothing for arena support.
+    // Implicitly constructible from std::unique_ptr so std::make_unique results convert to UniquePtr.
+    template<typename T>
+    class UniquePtr
+    {
+    public:
+        using element_type = T;
+        using pointer = T*;
+
+        UniquePtr() = default;
+
+        UniquePtr(std::nullptr_t) noexcept
+        {
+        }
+
+        UniquePtr(T* const object, const Ownership ownership) noexcept
+            : m_Bits{reinterpret_cast<uintptr_t>(object) | static_cast<uintptr_t>(ownership)}
+        {
+            static_assert(alignof(T) > OwnershipMask, "The ownership needs two free low bits in the pointer");
+        }
+
+        template<typename U> requires std::is_convertible_v<U*, T*>
+        UniquePtr(std::unique_ptr<U>&& object) noexcept
+            : UniquePtr{object.release(), Ownership::Heap}
+        {
+        }
+
+        UniquePtr(UniquePtr&& other) noexcept
+            : m_Bits{std::exchange(other.m_Bits, 0)}
+        {
+        }
+
+        template<typename U> requires (!std::is_same_v<U, T> && std::is_convertible_v<U*, T*>)
+        UniquePtr(UniquePtr<U>&& other) noexcept
+            : UniquePtr{other.get(), other.GetOwnership()}
+        {
+            other.m_Bits = 0;
+        }
+
+        UniquePtr(const UniquePtr&) = delete;
+        UniquePtr& operator=(const UniquePtr&) = delete;
+
+        UniquePtr& operator=(UniquePtr&& other) noexcept
+        {
+            if(this != &other)
+            {
+                Destroy();
+                m_Bits = std::exchange(other.m_Bits, 0);
+            }
+
+            return *this;
+        }
+
+        template<typename U> requires std::is_convertible_v<U*, T*>
+        UniquePtr& operator=(UniquePtr<U>&& other) noexcept
+        {
+            return *this = UniquePtr{std::move(other)};
+        }
+
+        template<typename U> requires std::is_convertible_v<U*, T*>
+        UniquePtr& operator=(std::unique_ptr<U>&& object) noexcept
+        {
+            return *this = UniquePtr{std::move(object)};
+        }
+
+        UniquePtr& operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        ~UniquePtr()
+        {
+            Destroy();
+        }
+
+        void reset() noexcept
+        {
+            Destroy();
+            m_Bits = 0;
+        }
+
+        T* get() const noexcept { return reinterpret_cast<T*>(m_Bits & ~OwnershipMask); }
+        Ownership GetOwnership() const noexcept { return static_cast<Ownership>(m_Bits & OwnershipMask); }
+
+        T& operator*() const noexcept { return *get(); }
+        T* operator->() const noexcept { return get(); }
+        explicit operator bool() const noexcept { return get() != nullptr; }
+
+        friend bool operator==(const UniquePtr& object, std::nullptr_t) noexcept { return !object; }
+    private:
+        template<typename>
+        friend class UniquePtr;
+
+        static constexpr uintptr_t OwnershipMask{3};
+
+        void Destroy() noexcept
+        {
+            T* const object{get()};
+            if(!object)
+                return;
+
+            switch(GetOwnership())
+            {
+            case Ownership::Heap:
+                delete object;
+                break;
+            case Ownership::Arena:
+                std::destroy_at(object);
+                break;
+            case Ownership::Shared:
+                break;
+            }
+        }
+
+        uintptr_t m_Bits{0};
+    };
+
+    static_assert(sizeof(UniquePtr<int32_t>) == sizeof(std::unique_ptr<int32_t>));
+
+    // The memory resource must outlive the returned object, e.g. a std::pmr::monotonic_buffer_resource
+    // declared before the container holding the objects.
+    template<typename T, typename... TArgs>
+    UniquePtr<T> MakeUnique(std::pmr::memory_resource& memoryResource, TArgs&&... args)
+    {
+        std::pmr::polymorphic_allocator<> allocator{&memoryResource};
+        return UniquePtr<T>{allocator.new_object<T>(std::forward<TArgs>(args)...), Ownership::Arena};
+    }
+
+    // Non-owning UniquePtr, the object must outlive it.
+    template<typename T>
+    UniquePtr<T> MakeNonOwning(T& object)
+    {
+        return UniquePtr<T>{&object, Ownership::Shared};
+    }
+}
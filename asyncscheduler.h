@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Resumes coroutines on a fixed set of worker threads.
+// co_await Schedule() continues the awaiting coroutine on a worker, co_await Sleep(duration) suspends it
+// without blocking a thread: a timer thread hands it back to the workers once the duration has passed.
+// All coroutines must have completed before the scheduler is destroyed.
+class AsyncScheduler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit AsyncScheduler(const size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u))
+        : m_ThreadCount{std::max<size_t>(threadCount, 1)}
+    {
+        m_Workers.reserve(m_ThreadCount);
+        for(size_t workerIndex{0}; workerIndex != m_ThreadCount; ++workerIndex)
+        {
+            m_Workers.emplace_back(
+                [this]()
+                {
+                    WorkerLoop();
+                });
+        }
+
+        m_TimerThread = std::thread{
+            [this]()
+            {
+                TimerLoop();
+            }};
+    }
+
+    AsyncScheduler(const AsyncScheduler&) = delete;
+    AsyncScheduler& operator=(const AsyncScheduler&) = delete;
+
+    ~AsyncScheduler()
+    {
+        {
+            const std::scoped_lock lock{m_Mutex, m_TimerMutex};
+            m_Stop = true;
+        }
+
+        m_WorkAvailable.notify_all();
+        m_TimerChanged.notify_one();
+        for(std::thread& worker: m_Workers)
+        {
+            worker.join();
+        }
+
+        m_TimerThread.join();
+    }
+
+    // Queues handle to be resumed by a worker
+    void Post(const std::coroutine_handle<> handle)
+    {
+        {
+            const std::scoped_lock lock{m_Mutex};
+            m_Ready.push_back(handle);
+        }
+
+        m_WorkAvailable.notify_one();
+    }
+
+    auto Schedule()
+    {
+        struct Awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(const std::coroutine_handle<> handle) const
+            {
+                m_Scheduler.Post(handle);
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+
+            AsyncScheduler& m_Scheduler;
+        };
+
+        return Awaiter{*this};
+    }
+
+    auto Sleep(const Clock::duration duration)
+    {
+        struct Awaiter
+        {
+            bool await_ready() const noexcept { return m_Duration <= Clock::duration::zero(); }
+
+            void await_suspend(const std::coroutine_handle<> handle) const
+            {
+                m_Scheduler.PostAt(Clock::now() + m_Duration, handle);
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+
+            AsyncScheduler& m_Scheduler;
+            Clock::duration m_Duration;
+        };
+
+        return Awaiter{*this, duration};
+    }
+
+    size_t GetThreadCount() const { return m_ThreadCount; }
+private:
+    struct Timer
+    {
+        Clock::time_point m_Deadline{};
+        std::coroutine_handle<> m_Handle{};
+
+        // Earliest deadline on top of the std::priority_queue
+        bool operator<(const Timer& other) const { return m_Deadline > other.m_Deadline; }
+    };
+
+    void PostAt(const Clock::time_point deadline, const std::coroutine_handle<> handle)
+    {
+        bool isEarliest{false};
+        {
+            const std::scoped_lock lock{m_TimerMutex};
+            isEarliest = m_Timers.empty() || deadline < m_Timers.top().m_Deadline;
+            m_Timers.push(Timer{deadline, handle});
+        }
+
+        if(isEarliest)
+            m_TimerChanged.notify_one();
+    }
+
+    void WorkerLoop()
+    {
+        while(true)
+        {
+            std::coroutine_handle<> handle{};
+            {
+                std::unique_lock lock{m_Mutex};
+                m_WorkAvailable.wait(lock,
+                    [this]()
+                    {
+                        return m_Stop || !m_Ready.empty();
+                    });
+
+                if(m_Ready.empty())
+                    return;
+
+                handle = m_Ready.front();
+                m_Ready.pop_front();
+            }
+
+            handle.resume();
+        }
+    }
+
+    void TimerLoop()
+    {
+        std::unique_lock lock{m_TimerMutex};
+        while(!m_Stop)
+        {
+            if(m_Timers.empty())
+            {
+                m_TimerChanged.wait(lock);
+                continue;
+            }
+
+            // A copy, PostAt() may reallocate the queue while the wait has the lock released
+            const Clock::time_point deadline{m_Timers.top().m_Deadline};
+            if(m_TimerChanged.wait_until(lock, deadline) == std::cv_status::no_timeout)
+                continue;
+
+            // Post every expired timer in one pass
+            const Clock::time_point now{Clock::now()};
+            while(!m_Timers.empty() && m_Timers.top().m_Deadline <= now)
+            {
+                Post(m_Timers.top().m_Handle);
+                m_Timers.pop();
+            }
+        }
+    }
+
+    const size_t m_ThreadCount{1};
+    std::vector<std::thread> m_Workers{};
+    std::thread m_TimerThread{};
+
+    std::mutex m_Mutex{};
+    std::condition_variable m_WorkAvailable{};
+    std::deque<std::coroutine_handle<>> m_Ready{};
+    bool m_Stop{false};
+
+    std::mutex m_TimerMutex{};
+    std::condition_variable m_TimerChanged{};
+    std::priority_queue<Timer> m_Timers{};
+};
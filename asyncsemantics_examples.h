@@ -0,0 +1,487 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random/random.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asyncscheduler.h"
+#include "referencesemantics_examples.h"
+#include "rng.h"
+#include "task.h"
+
+namespace AsyncSemantics
+{
+    // Reference semantics with strategies that may suspend, e.g. to wait for I/O or another subsystem,
+    // Operation() returns a Task that completes once the Strategy has been applied.
+    class Value
+    {
+    public:
+        virtual ~Value() = default;
+        virtual Task Operation() = 0;
+    };
+
+    template<typename TValue>
+    class AsyncOperationStrategy
+    {
+    public:
+        virtual ~AsyncOperationStrategy() = default;
+        virtual Task Operation(TValue&) = 0;
+    };
+
+    // IntValue
+    class IntValue final : public Value
+    {
+    public:
+        using OperationStrategy = AsyncOperationStrategy<IntValue>;
+
+        explicit IntValue(
+            const int32_t value, std::unique_ptr<OperationStrategy>&& operationStrategy)
+            : m_OperationStrategy{std::move(operationStrategy)}
+            , m_Value{value}
+        {
+        }
+
+        Task Operation() override
+        {
+            return m_OperationStrategy->Operation(*this);
+        }
+
+        int32_t GetValue() const { return m_Value; }
+        void SetValue(const int32_t value) { m_Value = value; }
+    private:
+        std::unique_ptr<OperationStrategy> m_OperationStrategy{};
+        int32_t m_Value{0};
+    };
+
+    class IncrementIntValueOperationStrategy final : public IntValue::OperationStrategy
+    {
+    public:
+        Task Operation(IntValue& value) override
+        {
+            value.SetValue(value.GetValue() + 1);
+            co_return;
+        }
+    };
+
+    class DecrementIntValueOperationStrategy final : public IntValue::OperationStrategy
+    {
+    public:
+        Task Operation(IntValue& value) override
+        {
+            value.SetValue(value.GetValue() - 1);
+            co_return;
+        }
+    };
+
+    // FloatValue
+    class FloatValue final : public Value
+    {
+    public:
+        using OperationStrategy = AsyncOperationStrategy<FloatValue>;
+
+        explicit FloatValue(
+            const float_t value, std::unique_ptr<OperationStrategy>&& operationStrategy)
+            : m_OperationStrategy{std::move(operationStrategy)}
+            , m_Value{value}
+        {
+        }
+
+        Task Operation() override
+        {
+            return m_OperationStrategy->Operation(*this);
+        }
+
+        float_t GetValue() const { return m_Value; }
+        void SetValue(const float_t value) { m_Value = value; }
+    private:
+        std::unique_ptr<OperationStrategy> m_OperationStrategy{};
+        float_t m_Value{0.0f};
+    };
+
+    class IncrementFloatValueOperationStrategy final : public FloatValue::OperationStrategy
+    {
+    public:
+        Task Operation(FloatValue& value) override
+        {
+            value.SetValue(value.GetValue() + 1.0f);
+            co_return;
+        }
+    };
+
+    class DecrementFloatValueOperationStrategy final : public FloatValue::OperationStrategy
+    {
+    public:
+        Task Operation(FloatValue& value) override
+        {
+            value.SetValue(value.GetValue() - 1.0f);
+            co_return;
+        }
+    };
+
+    // Simulates a Strategy that waits for another subsystem, suspends for latency before applying
+    // operationStrategy. The awaiting coroutine continues on a worker of scheduler.
+    template<typename TValue>
+    class DelayedOperationStrategy final : public TValue::OperationStrategy
+    {
+    public:
+        DelayedOperationStrategy(AsyncScheduler& scheduler, const AsyncScheduler::Clock::duration latency,
+            std::unique_ptr<typename TValue::OperationStrategy>&& operationStrategy)
+            : m_Scheduler{scheduler}
+            , m_Latency{latency}
+            , m_OperationStrategy{std::move(operationStrategy)}
+        {
+        }
+
+        Task Operation(TValue& value) override
+        {
+            co_await m_Scheduler.Sleep(m_Latency);
+            co_await m_OperationStrategy->Operation(value);
+        }
+    private:
+        AsyncScheduler& m_Scheduler;
+        AsyncScheduler::Clock::duration m_Latency{};
+        std::unique_ptr<typename TValue::OperationStrategy> m_OperationStrategy{};
+    };
+
+    std::unique_ptr<Value> CreateValue(const bool isIntValue, const bool isIncrement)
+    {
+        if(isIntValue)
+        {
+            std::unique_ptr<IntValue::OperationStrategy> operationStrategy{
+                [isIncrement]() -> std::unique_ptr<IntValue::OperationStrategy>
+                {
+                    if(isIncrement)
+                        return std::make_unique<IncrementIntValueOperationStrategy>();
+
+                    return std::make_unique<DecrementIntValueOperationStrategy>();
+                }()};
+
+            return std::make_unique<IntValue>(0, std::move(operationStrategy));
+        }
+
+        std::unique_ptr<FloatValue::OperationStrategy> operationStrategy{
+            [isIncrement]() -> std::unique_ptr<FloatValue::OperationStrategy>
+            {
+                if(isIncrement)
+                    return std::make_unique<IncrementFloatValueOperationStrategy>();
+
+                return std::make_unique<DecrementFloatValueOperationStrategy>();
+            }()};
+
+        return std::make_unique<FloatValue>(0.0f, std::move(operationStrategy));
+    }
+
+    std::unique_ptr<Value> CreateRandomValue()
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    std::unique_ptr<Value> CreateRandomValue(Rng::Generator& generator)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    std::unique_ptr<Value> CreateDelayedIntValue(
+        AsyncScheduler& scheduler, const AsyncScheduler::Clock::duration latency)
+    {
+        return std::make_unique<IntValue>(0, std::make_unique<DelayedOperationStrategy<IntValue>>(
+            scheduler, latency, std::make_unique<IncrementIntValueOperationStrategy>()));
+    }
+
+    // Runs the Operation() of many values with up to concurrency of them in flight.
+    // Each of the concurrency driver coroutines takes the next value once the Operation() of its previous
+    // value has completed, so the suspension points of different values overlap instead of blocking a thread
+    // each.
+    class AsyncExecutor
+    {
+    public:
+        static constexpr size_t DefaultConcurrency{256};
+
+        explicit AsyncExecutor(AsyncScheduler& scheduler, const size_t concurrency = DefaultConcurrency)
+            : m_Scheduler{scheduler}
+            , m_Concurrency{std::max<size_t>(concurrency, 1)}
+        {
+        }
+
+        // Blocks until every Operation() has completed, rethrows the first exception of an Operation().
+        // Must not be called from a worker of the scheduler.
+        void Run(const std::span<const std::unique_ptr<Value>> values)
+        {
+            const size_t driverCount{std::min(m_Concurrency, values.size())};
+            if(driverCount == 0)
+                return;
+
+            RunState state{values, driverCount};
+            for(size_t driver{0}; driver != driverCount; ++driver)
+            {
+                Drive(state);
+            }
+
+            state.m_Latch.wait();
+            if(state.m_Exception)
+                std::rethrow_exception(state.m_Exception);
+        }
+
+        size_t GetConcurrency() const { return m_Concurrency; }
+    private:
+        struct RunState
+        {
+            RunState(const std::span<const std::unique_ptr<Value>> values, const size_t driverCount)
+                : m_Values{values}
+                , m_Latch{static_cast<std::ptrdiff_t>(driverCount)}
+            {
+            }
+
+            std::span<const std::unique_ptr<Value>> m_Values;
+            std::atomic<size_t> m_NextIndex{0};
+            std::latch m_Latch;
+            std::mutex m_ExceptionMutex{};
+            std::exception_ptr m_Exception{};
+        };
+
+        FireAndForget Drive(RunState& state)
+        {
+            co_await m_Scheduler.Schedule();
+
+            for(size_t index{state.m_NextIndex.fetch_add(1, std::memory_order_relaxed)};
+                index < state.m_Values.size();
+                index = state.m_NextIndex.fetch_add(1, std::memory_order_relaxed))
+            {
+                try
+                {
+                    co_await state.m_Values[index]->Operation();
+                }
+                catch(...)
+                {
+                    const std::scoped_lock lock{state.m_ExceptionMutex};
+                    if(!state.m_Exception)
+                        state.m_Exception = std::current_exception();
+                }
+            }
+
+            state.m_Latch.count_down();
+        }
+
+        AsyncScheduler& m_Scheduler;
+        const size_t m_Concurrency{DefaultConcurrency};
+    };
+
+    // Synchronous counterpart of DelayedOperationStrategy, blocks the calling thread for latency
+    class SleepingIncrementIntValueOperationStrategy final
+        : public ReferenceSemantics::IntValue::OperationStrategy
+    {
+    public:
+        explicit SleepingIncrementIntValueOperationStrategy(const std::chrono::steady_clock::duration latency)
+            : m_Latency{latency}
+        {
+        }
+
+        void Operation(ReferenceSemantics::IntValue& value) override
+        {
+            std::this_thread::sleep_for(m_Latency);
+            value.SetValue(value.GetValue() + 1);
+        }
+    private:
+        std::chrono::steady_clock::duration m_Latency{};
+    };
+
+    TEST_CASE("Strategy - Async Semantics - Unit Tests")
+    {
+        using namespace std::chrono_literals;
+        AsyncScheduler scheduler{2};
+
+        SECTION("Synchronous Strategies")
+        {
+            std::vector<std::unique_ptr<Value>> values{};
+            for(uint32_t i{0}; i != 100; ++i)
+            {
+                values.push_back(CreateValue(i % 2 == 0, i % 4 < 2));
+            }
+
+            AsyncExecutor executor{scheduler, 8};
+            executor.Run(values);
+            executor.Run(values);
+
+            for(size_t i{0}; i != values.size(); ++i)
+            {
+                const int32_t expected{i % 4 < 2 ? 2 : -2};
+                if(i % 2 == 0)
+                {
+                    REQUIRE(static_cast<const IntValue&>(*values[i]).GetValue() == expected);
+                }
+                else
+                {
+                    REQUIRE(static_cast<const FloatValue&>(*values[i]).GetValue() ==
+                        static_cast<float_t>(expected));
+                }
+            }
+
+            AsyncExecutor{scheduler}.Run({});
+        }
+
+        SECTION("Overlapping Suspension")
+        {
+            constexpr size_t valueCount{16};
+            constexpr AsyncScheduler::Clock::duration latency{50ms};
+
+            std::vector<std::unique_ptr<Value>> values{};
+            for(size_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateDelayedIntValue(scheduler, latency));
+            }
+
+            const AsyncScheduler::Clock::time_point start{AsyncScheduler::Clock::now()};
+            AsyncExecutor{scheduler, valueCount}.Run(values);
+            const AsyncScheduler::Clock::duration elapsed{AsyncScheduler::Clock::now() - start};
+
+            REQUIRE(elapsed >= latency);
+            // Serially this takes valueCount * latency
+            REQUIRE(elapsed < valueCount * latency / 2);
+            REQUIRE(std::ranges::all_of(values,
+                [](const std::unique_ptr<Value>& value)
+                {
+                    return static_cast<const IntValue&>(*value).GetValue() == 1;
+                }));
+        }
+
+        SECTION("Concurrency Limit")
+        {
+            class CountingOperationStrategy final : public IntValue::OperationStrategy
+            {
+            public:
+                CountingOperationStrategy(AsyncScheduler& scheduler, std::atomic<size_t>& inFlightCount,
+                    std::atomic<size_t>& maxInFlightCount)
+                    : m_Scheduler{scheduler}
+                    , m_InFlightCount{inFlightCount}
+                    , m_MaxInFlightCount{maxInFlightCount}
+                {
+                }
+
+                Task Operation(IntValue& value) override
+                {
+                    const size_t inFlightCount{m_InFlightCount.fetch_add(1) + 1};
+                    size_t maxInFlightCount{m_MaxInFlightCount.load()};
+                    while(inFlightCount > maxInFlightCount &&
+                        !m_MaxInFlightCount.compare_exchange_weak(maxInFlightCount, inFlightCount))
+                    {
+                    }
+
+                    co_await m_Scheduler.Sleep(1ms);
+                    value.SetValue(value.GetValue() + 1);
+                    m_InFlightCount.fetch_sub(1);
+                }
+            private:
+                AsyncScheduler& m_Scheduler;
+                std::atomic<size_t>& m_InFlightCount;
+                std::atomic<size_t>& m_MaxInFlightCount;
+            };
+
+            std::atomic<size_t> inFlightCount{0};
+            std::atomic<size_t> maxInFlightCount{0};
+            std::vector<std::unique_ptr<Value>> values{};
+            for(uint32_t i{0}; i != 32; ++i)
+            {
+                values.push_back(std::make_unique<IntValue>(0,
+                    std::make_unique<CountingOperationStrategy>(scheduler, inFlightCount, maxInFlightCount)));
+            }
+
+            AsyncExecutor{scheduler, 4}.Run(values);
+            REQUIRE(maxInFlightCount.load() <= 4);
+            REQUIRE(maxInFlightCount.load() >= 1);
+            REQUIRE(inFlightCount.load() == 0);
+        }
+
+        SECTION("Exceptions")
+        {
+            class ThrowingOperationStrategy final : public IntValue::OperationStrategy
+            {
+            public:
+                Task Operation(IntValue&) override
+                {
+                    throw std::runtime_error{"Operation failed"};
+                    co_return;
+                }
+            };
+
+            std::vector<std::unique_ptr<Value>> values{};
+            values.push_back(CreateValue(true, true));
+            values.push_back(std::make_unique<IntValue>(0, std::make_unique<ThrowingOperationStrategy>()));
+            values.push_back(CreateValue(true, true));
+
+            AsyncExecutor executor{scheduler, 1};
+            REQUIRE_THROWS_AS(executor.Run(values), std::runtime_error);
+            // The remaining values are still processed
+            REQUIRE(static_cast<const IntValue&>(*values[2]).GetValue() == 1);
+        }
+    }
+
+    // Throughput of values whose Strategy waits latency, e.g. for I/O, the synchronous loop blocks for every
+    // value while the executor overlaps the waits
+    TEST_CASE("Strategy - Async Semantics - Benchmark")
+    {
+        using namespace std::chrono_literals;
+        constexpr size_t valueCount{16};
+        constexpr AsyncScheduler::Clock::duration latency{1ms};
+
+        std::vector<std::unique_ptr<ReferenceSemantics::Value>> synchronousValues{};
+        for(size_t i{0}; i != valueCount; ++i)
+        {
+            synchronousValues.push_back(std::make_unique<ReferenceSemantics::IntValue>(0,
+                std::make_unique<SleepingIncrementIntValueOperationStrategy>(latency)));
+        }
+
+        AsyncScheduler scheduler{};
+        std::vector<std::unique_ptr<Value>> values{};
+        for(size_t i{0}; i != valueCount; ++i)
+        {
+            values.push_back(CreateDelayedIntValue(scheduler, latency));
+        }
+
+        BENCHMARK("Synchronous Value::Operation()")
+        {
+            for(const std::unique_ptr<ReferenceSemantics::Value>& value: synchronousValues)
+            {
+                value->Operation();
+            }
+        };
+
+        for(const size_t concurrency: {size_t{1}, size_t{4}, valueCount})
+        {
+            AsyncExecutor executor{scheduler, concurrency};
+            BENCHMARK("AsyncExecutor (concurrency " + std::to_string(concurrency) + ")")
+            {
+                executor.Run(values);
+            };
+        }
+
+        constexpr size_t synchronousValueCount{10'000};
+        std::vector<std::unique_ptr<Value>> immediateValues{};
+        for(size_t i{0}; i != synchronousValueCount; ++i)
+        {
+            immediateValues.push_back(CreateRandomValue());
+        }
+
+        // Overhead of the coroutine frames and scheduling for strategies that never suspend
+        BENCHMARK("AsyncExecutor (synchronous strategies)")
+        {
+            AsyncExecutor{scheduler}.Run(immediateValues);
+        };
+    }
+}
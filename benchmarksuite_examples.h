@@ -0,0 +1,302 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "externalpolymorphism_examples.h"
+#include "inlinevaluesemantics_examples.h"
+#include "referencesemantics_examples.h"
+#include "strategycollection_examples.h"
+#include "template_examples.h"
+#include "valuesemantics_examples.h"
+#include "variantsemantics_examples.h"
+
+// Runs the same benchmark matrix (value count x Operation() iterations x int/float mix) on every engine.
+// Values are constructed outside of the measured region, so only the dispatch loop is timed.
+namespace BenchmarkSuite
+{
+    struct ValueKind
+    {
+        bool m_IsIntValue{false};
+        bool m_IsIncrement{false};
+    };
+
+    struct BenchmarkParameters
+    {
+        size_t m_ValueCount{0};
+        uint32_t m_IterationCount{1};
+        uint32_t m_IntValuePercentage{50};
+    };
+
+    // Same sequence for every engine, so all of them run the exact same population
+    std::vector<ValueKind> CreateValueKinds(const size_t valueCount, const uint32_t intValuePercentage)
+    {
+        std::mt19937 generator{20'240'601};
+        std::bernoulli_distribution isIntValue{intValuePercentage / 100.0};
+        std::bernoulli_distribution isIncrement{0.5};
+
+        std::vector<ValueKind> valueKinds(valueCount);
+        for(ValueKind& valueKind: valueKinds)
+        {
+            valueKind.m_IsIntValue = isIntValue(generator);
+            valueKind.m_IsIncrement = isIncrement(generator);
+        }
+
+        return valueKinds;
+    }
+
+    template<typename TValue>
+        requires requires(TValue& value) { value->Operation(); }
+    void InvokeOperation(TValue& value)
+    {
+        value->Operation();
+    }
+
+    void InvokeOperation(ExternalPolymorphism::AnyValue& value)
+    {
+        value.Operation();
+    }
+
+    void InvokeOperation(VariantSemantics::Value& value)
+    {
+        VariantSemantics::Operation(value);
+    }
+
+    // Engines
+    template<typename TValue, TValue (*TCreateValue)(bool, bool)>
+    struct VectorEngine
+    {
+        using Population = std::vector<TValue>;
+
+        static Population Create(const std::span<const ValueKind> valueKinds)
+        {
+            Population values{};
+            values.reserve(valueKinds.size());
+
+            for(const ValueKind& valueKind: valueKinds)
+            {
+                values.push_back(TCreateValue(valueKind.m_IsIntValue, valueKind.m_IsIncrement));
+            }
+
+            return values;
+        }
+
+        static void Run(Population& values)
+        {
+            for(TValue& value: values)
+            {
+                InvokeOperation(value);
+            }
+        }
+    };
+
+    struct ReferenceSemanticsEngine
+        : VectorEngine<std::unique_ptr<ReferenceSemantics::Value>, &ReferenceSemantics::CreateValue>
+    {
+        static constexpr const char* Name{"Reference Semantics"};
+    };
+
+    struct ValueSemanticsEngine
+        : VectorEngine<std::unique_ptr<ValueSemantics::Value>, &ValueSemantics::CreateValue>
+    {
+        static constexpr const char* Name{"Value Semantics"};
+    };
+
+    struct InlineValueSemanticsEngine
+        : VectorEngine<std::unique_ptr<InlineValueSemantics::Value>, &InlineValueSemantics::CreateValue>
+    {
+        static constexpr const char* Name{"Inline Value Semantics"};
+    };
+
+    struct TemplateEngine
+        : VectorEngine<std::unique_ptr<Template::Value>, &Template::CreateValue>
+    {
+        static constexpr const char* Name{"Template"};
+    };
+
+    struct ExternalPolymorphismEngine
+        : VectorEngine<ExternalPolymorphism::AnyValue, &ExternalPolymorphism::CreateValue>
+    {
+        static constexpr const char* Name{"External Polymorphism"};
+    };
+
+    struct VariantSemanticsEngine
+        : VectorEngine<VariantSemantics::Value, &VariantSemantics::CreateValue>
+    {
+        static constexpr const char* Name{"Variant Semantics"};
+    };
+
+    struct StrategyCollectionEngine
+    {
+        static constexpr const char* Name{"Strategy Collection"};
+        using Population = Template::ValueCollection;
+
+        static Population Create(const std::span<const ValueKind> valueKinds)
+        {
+            Population collection{};
+            for(const ValueKind& valueKind: valueKinds)
+            {
+                Template::AddValue(collection, valueKind.m_IsIntValue, valueKind.m_IsIncrement);
+            }
+
+            return collection;
+        }
+
+        static void Run(Population& collection)
+        {
+            collection.Operation();
+        }
+    };
+
+    std::string GetBenchmarkName(const char* const engineName, const BenchmarkParameters& parameters)
+    {
+        return std::string{engineName} +
+            " - " + std::to_string(parameters.m_ValueCount) + " Values" +
+            " - " + std::to_string(parameters.m_IterationCount) + " Iterations" +
+            " - " + std::to_string(parameters.m_IntValuePercentage) + "% IntValue";
+    }
+
+    template<typename TEngine>
+    void RunBenchmark(const BenchmarkParameters& parameters, const std::span<const ValueKind> valueKinds)
+    {
+        BENCHMARK_ADVANCED(GetBenchmarkName(TEngine::Name, parameters))(Catch::Benchmark::Chronometer meter)
+        {
+            typename TEngine::Population population{TEngine::Create(valueKinds)};
+            const uint32_t iterationCount{parameters.m_IterationCount};
+
+            meter.measure(
+                [&population, iterationCount]()
+                {
+                    for(uint32_t iteration{0}; iteration != iterationCount; ++iteration)
+                    {
+                        TEngine::Run(population);
+                    }
+                });
+        };
+    }
+
+    template<typename... TEngines>
+    void RunBenchmarks(
+        const std::span<const size_t> valueCounts,
+        const std::span<const uint32_t> iterationCounts,
+        const std::span<const uint32_t> intValuePercentages)
+    {
+        for(const size_t valueCount: valueCounts)
+        {
+            for(const uint32_t intValuePercentage: intValuePercentages)
+            {
+                const std::vector<ValueKind> valueKinds{CreateValueKinds(valueCount, intValuePercentage)};
+                for(const uint32_t iterationCount: iterationCounts)
+                {
+                    const BenchmarkParameters parameters{
+                        .m_ValueCount = valueCount,
+                        .m_IterationCount = iterationCount,
+                        .m_IntValuePercentage = intValuePercentage};
+                    (RunBenchmark<TEngines>(parameters, valueKinds), ...);
+                }
+            }
+        }
+    }
+
+    void RunAllEngineBenchmarks(
+        const std::span<const size_t> valueCounts,
+        const std::span<const uint32_t> iterationCounts,
+        const std::span<const uint32_t> intValuePercentages)
+    {
+        RunBenchmarks<
+            ReferenceSemanticsEngine,
+            ValueSemanticsEngine,
+            InlineValueSemanticsEngine,
+            TemplateEngine,
+            ExternalPolymorphismEngine,
+            VariantSemanticsEngine,
+            StrategyCollectionEngine>(valueCounts, iterationCounts, intValuePercentages);
+    }
+
+    TEST_CASE("Strategy - Benchmark Suite - Unit Tests")
+    {
+        SECTION("Value Kinds")
+        {
+            const auto countIntValues{
+                [](const std::vector<ValueKind>& valueKinds)
+                {
+                    return std::ranges::count_if(valueKinds, &ValueKind::m_IsIntValue);
+                }};
+
+            REQUIRE(countIntValues(CreateValueKinds(1'000, 0)) == 0);
+            REQUIRE(countIntValues(CreateValueKinds(1'000, 100)) == 1'000);
+
+            const std::vector<ValueKind> valueKinds{CreateValueKinds(10'000, 25)};
+            REQUIRE(countIntValues(valueKinds) > 2'000);
+            REQUIRE(countIntValues(valueKinds) < 3'000);
+
+            const std::vector<ValueKind> sameValueKinds{CreateValueKinds(10'000, 25)};
+            REQUIRE(std::ranges::equal(valueKinds, sameValueKinds,
+                [](const ValueKind& lhs, const ValueKind& rhs)
+                {
+                    return lhs.m_IsIntValue == rhs.m_IsIntValue && lhs.m_IsIncrement == rhs.m_IsIncrement;
+                }));
+        }
+
+        SECTION("Engines")
+        {
+            const std::vector<ValueKind> valueKinds{
+                {.m_IsIntValue = true, .m_IsIncrement = true},
+                {.m_IsIntValue = true, .m_IsIncrement = false},
+                {.m_IsIntValue = false, .m_IsIncrement = true},
+                {.m_IsIntValue = false, .m_IsIncrement = false}};
+
+            TemplateEngine::Population values{TemplateEngine::Create(valueKinds)};
+            TemplateEngine::Run(values);
+            REQUIRE(static_cast<const Template::IntValue<Template::IncrementIntValueOperationStrategy>&>(
+                *values[0]).GetValue() == 1);
+            REQUIRE(static_cast<const Template::IntValue<Template::DecrementIntValueOperationStrategy>&>(
+                *values[1]).GetValue() == -1);
+            REQUIRE(static_cast<const Template::FloatValue<Template::IncrementFloatValueOperationStrategy>&>(
+                *values[2]).GetValue() == 1.0f);
+            REQUIRE(static_cast<const Template::FloatValue<Template::DecrementFloatValueOperationStrategy>&>(
+                *values[3]).GetValue() == -1.0f);
+
+            VariantSemanticsEngine::Population variantValues{VariantSemanticsEngine::Create(valueKinds)};
+            VariantSemanticsEngine::Run(variantValues);
+            REQUIRE(std::get<VariantSemantics::IntValue>(variantValues[1]).GetValue() == -1);
+            REQUIRE(std::get<VariantSemantics::FloatValue>(variantValues[2]).GetValue() == 1.0f);
+
+            StrategyCollectionEngine::Population collection{StrategyCollectionEngine::Create(valueKinds)};
+            StrategyCollectionEngine::Run(collection);
+            REQUIRE(collection.GetSize() == valueKinds.size());
+            using DecrementIntValue = Template::IntValue<Template::DecrementIntValueOperationStrategy>;
+            REQUIRE(collection.GetPartition<DecrementIntValue>().GetValues()[0] == -1);
+
+            REQUIRE(ReferenceSemanticsEngine::Create(valueKinds).size() == valueKinds.size());
+            REQUIRE(ValueSemanticsEngine::Create(valueKinds).size() == valueKinds.size());
+            REQUIRE(InlineValueSemanticsEngine::Create(valueKinds).size() == valueKinds.size());
+            REQUIRE(ExternalPolymorphismEngine::Create(valueKinds).size() == valueKinds.size());
+        }
+    }
+
+    TEST_CASE("Strategy - Benchmark Suite - Benchmark")
+    {
+        constexpr size_t valueCounts[]{10'000};
+        constexpr uint32_t iterationCounts[]{1, 10};
+        constexpr uint32_t intValuePercentages[]{50};
+
+        RunAllEngineBenchmarks(valueCounts, iterationCounts, intValuePercentages);
+    }
+
+    // Full matrix, takes a long time and needs a few GB of memory at 10M values, run with "[matrix]"
+    TEST_CASE("Strategy - Benchmark Suite - Full Matrix Benchmark", "[.][matrix]")
+    {
+        constexpr size_t valueCounts[]{1'000, 10'000, 100'000, 1'000'000, 10'000'000};
+        constexpr uint32_t iterationCounts[]{1, 10, 100};
+        constexpr uint32_t intValuePercentages[]{0, 25, 50, 75, 100};
+
+        RunAllEngineBenchmarks(valueCounts, iterationCounts, intValuePercentages);
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#if defined(__linux__)
+    #define CACHE_INFO_LINUX
+    #include <unistd.h>
+#elif defined(_WIN32)
+    #define CACHE_INFO_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#endif
+
+// Data cache sizes of the machine, falls back to typical desktop sizes for levels that cannot be queried
+namespace CacheInfo
+{
+    struct CacheSizes
+    {
+        size_t m_L1Data{32 * 1024};
+        size_t m_L2{1024 * 1024};
+        // Largest level, L3 on most machines
+        size_t m_LastLevel{32 * 1024 * 1024};
+    };
+
+    inline CacheSizes GetCacheSizes()
+    {
+        CacheSizes cacheSizes{};
+#if defined(CACHE_INFO_LINUX) && defined(_SC_LEVEL1_DCACHE_SIZE)
+        const auto query{
+            [](const int name, size_t& size)
+            {
+                const long value{sysconf(name)};
+                if(value > 0)
+                    size = static_cast<size_t>(value);
+            }};
+
+        query(_SC_LEVEL1_DCACHE_SIZE, cacheSizes.m_L1Data);
+        query(_SC_LEVEL2_CACHE_SIZE, cacheSizes.m_L2);
+        // Without L3 the L2 is the last level
+        if(sysconf(_SC_LEVEL3_CACHE_SIZE) <= 0 && sysconf(_SC_LEVEL2_CACHE_SIZE) > 0)
+            cacheSizes.m_LastLevel = cacheSizes.m_L2;
+
+        query(_SC_LEVEL3_CACHE_SIZE, cacheSizes.m_LastLevel);
+#elif defined(CACHE_INFO_WINDOWS)
+        DWORD size{0};
+        GetLogicalProcessorInformation(nullptr, &size);
+        std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        if(!infos.empty() && GetLogicalProcessorInformation(infos.data(), &size))
+        {
+            for(const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& info: infos)
+            {
+                if(info.Relationship != RelationCache || info.Cache.Type == CacheInstruction)
+                    continue;
+
+                if(info.Cache.Level == 1)
+                    cacheSizes.m_L1Data = info.Cache.Size;
+                else if(info.Cache.Level == 2)
+                    cacheSizes.m_L2 = info.Cache.Size;
+                else if(info.Cache.Level == 3)
+                    cacheSizes.m_LastLevel = info.Cache.Size;
+            }
+        }
+#endif
+        return cacheSizes;
+    }
+}
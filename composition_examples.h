@@ -0,0 +1,406 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "strategycollection_examples.h"
+#include "template_examples.h"
+#include "typelist_examples.h"
+#include "valuesemantics_examples.h"
+
+namespace Template
+{
+    // Applies TOperationStrategies in order as a single Strategy, e.g.
+    // IntValue<decltype(Compose(IncrementIntValueOperationStrategy{}, ScaleValueOperationStrategy<2>{}))>.
+    // The chain is fused at compile time: a value is loaded once, every Strategy is applied to the payload in
+    // registers and the result is stored once, a span of payloads is processed in a single pass.
+    // Every Strategy has to accept the payload type (e.g. int32_t&).
+    template<typename... TOperationStrategies>
+    class ComposedOperationStrategy
+        : public PayloadOperationStrategy<ComposedOperationStrategy<TOperationStrategies...>>
+    {
+    public:
+        using PayloadOperationStrategy<ComposedOperationStrategy>::operator();
+
+        ComposedOperationStrategy() = default;
+
+        explicit ComposedOperationStrategy(TOperationStrategies... operationStrategies)
+            : m_OperationStrategies{std::move(operationStrategies)...}
+        {
+        }
+
+        template<typename TValueType>
+            requires std::is_arithmetic_v<TValueType>
+        void operator()(TValueType& value)
+        {
+            std::apply(
+                [&value](TOperationStrategies&... operationStrategies)
+                {
+                    (operationStrategies(value), ...);
+                },
+                m_OperationStrategies);
+        }
+    private:
+        std::tuple<TOperationStrategies...> m_OperationStrategies{};
+    };
+
+    template<typename... TOperationStrategies>
+    ComposedOperationStrategy<std::remove_cvref_t<TOperationStrategies>...> Compose(
+        TOperationStrategies&&... operationStrategies)
+    {
+        return ComposedOperationStrategy<std::remove_cvref_t<TOperationStrategies>...>{
+            std::forward<TOperationStrategies>(operationStrategies)...};
+    }
+
+    // Stateless (the bounds are template arguments) so they can be default constructed by IntValue/FloatValue
+    template<auto TMinimum, auto TMaximum>
+    class ClampValueOperationStrategy : public PayloadOperationStrategy<ClampValueOperationStrategy<TMinimum, TMaximum>>
+    {
+    public:
+        using PayloadOperationStrategy<ClampValueOperationStrategy>::operator();
+
+        template<typename TValueType>
+            requires std::is_arithmetic_v<TValueType>
+        void operator()(TValueType& value)
+        {
+            value = std::clamp(value, static_cast<TValueType>(TMinimum), static_cast<TValueType>(TMaximum));
+        }
+    };
+
+    template<auto TFactor>
+    class ScaleValueOperationStrategy : public PayloadOperationStrategy<ScaleValueOperationStrategy<TFactor>>
+    {
+    public:
+        using PayloadOperationStrategy<ScaleValueOperationStrategy>::operator();
+
+        template<typename TValueType>
+            requires std::is_arithmetic_v<TValueType>
+        void operator()(TValueType& value)
+        {
+            value = static_cast<TValueType>(value * static_cast<TValueType>(TFactor));
+        }
+    };
+}
+
+namespace ValueSemantics
+{
+    // Applies operationStrategies in order to the value object, the result converts to
+    // IntValue::OperationStrategy/FloatValue::OperationStrategy, so a chain costs one std::function call per
+    // value. The strategies are stored by value in the returned callable.
+    template<typename... TOperationStrategies>
+    auto Compose(TOperationStrategies&&... operationStrategies)
+    {
+        return
+            [... operationStrategies = std::forward<TOperationStrategies>(operationStrategies)]
+            <typename TValue>(TValue& value) mutable
+            {
+                (operationStrategies(value), ...);
+            };
+    }
+
+    template<typename TValue>
+    class ClampValueOperationStrategy
+    {
+    public:
+        using ValueType = decltype(std::declval<const TValue&>().GetValue());
+
+        ClampValueOperationStrategy(const ValueType minimum, const ValueType maximum)
+            : m_Minimum{minimum}
+            , m_Maximum{maximum}
+        {
+        }
+
+        void operator()(TValue& value) const
+        {
+            value.SetValue(std::clamp(value.GetValue(), m_Minimum, m_Maximum));
+        }
+    private:
+        ValueType m_Minimum{};
+        ValueType m_Maximum{};
+    };
+
+    template<typename TValue>
+    class ScaleValueOperationStrategy
+    {
+    public:
+        using ValueType = decltype(std::declval<const TValue&>().GetValue());
+
+        explicit ScaleValueOperationStrategy(const ValueType factor)
+            : m_Factor{factor}
+        {
+        }
+
+        void operator()(TValue& value) const
+        {
+            value.SetValue(value.GetValue() * m_Factor);
+        }
+    private:
+        ValueType m_Factor{};
+    };
+}
+
+namespace Composition
+{
+    // Increment, then clamp to [minimum, maximum], then scale, the pipeline of the examples and benchmarks
+    constexpr int32_t Minimum{-1'000};
+    constexpr int32_t Maximum{1'000};
+    constexpr int32_t Factor{3};
+
+    using TemplateIntPipeline = decltype(Template::Compose(
+        Template::IncrementIntValueOperationStrategy{},
+        Template::ClampValueOperationStrategy<Minimum, Maximum>{},
+        Template::ScaleValueOperationStrategy<Factor>{}));
+
+    using TemplateFloatPipeline = decltype(Template::Compose(
+        Template::IncrementFloatValueOperationStrategy{},
+        Template::ClampValueOperationStrategy<Minimum, Maximum>{},
+        Template::ScaleValueOperationStrategy<Factor>{}));
+
+    constexpr int32_t ApplyPipeline(const int32_t value)
+    {
+        return std::clamp(value + 1, Minimum, Maximum) * Factor;
+    }
+
+    std::array<ValueSemantics::IntValue::OperationStrategy, 3> GetValueSemanticsIntPipeline()
+    {
+        return {
+            ValueSemantics::IncrementIntValueOperationStrategy{},
+            ValueSemantics::ClampValueOperationStrategy<ValueSemantics::IntValue>{Minimum, Maximum},
+            ValueSemantics::ScaleValueOperationStrategy<ValueSemantics::IntValue>{Factor}};
+    }
+
+    ValueSemantics::IntValue::OperationStrategy GetValueSemanticsIntComposition()
+    {
+        return ValueSemantics::Compose(
+            ValueSemantics::IncrementIntValueOperationStrategy{},
+            ValueSemantics::ClampValueOperationStrategy<ValueSemantics::IntValue>{Minimum, Maximum},
+            ValueSemantics::ScaleValueOperationStrategy<ValueSemantics::IntValue>{Factor});
+    }
+
+    // Sequential passes apply one Strategy to the whole population at a time, the fused pass applies the
+    // composed Strategy once per value
+    void RunFusedBenchmarks(const size_t valueCount)
+    {
+        std::vector<int32_t> payloads(valueCount);
+        for(size_t i{0}; i != valueCount; ++i)
+        {
+            payloads[i] = static_cast<int32_t>(i % 2'000) - 1'000;
+        }
+
+        BENCHMARK_ADVANCED("Template Payloads Sequential (3 passes)")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<int32_t> values{payloads};
+            meter.measure(
+                [&values]()
+                {
+                    const std::span<int32_t> span{values};
+                    Template::IncrementIntValueOperationStrategy{}(span);
+                    Template::ClampValueOperationStrategy<Minimum, Maximum>{}(span);
+                    Template::ScaleValueOperationStrategy<Factor>{}(span);
+                });
+        };
+
+        BENCHMARK_ADVANCED("Template Payloads Fused")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<int32_t> values{payloads};
+            meter.measure(
+                [&values]()
+                {
+                    TemplateIntPipeline{}(std::span<int32_t>{values});
+                });
+        };
+
+        BENCHMARK_ADVANCED("Template StrategyPartition Fused")(Catch::Benchmark::Chronometer meter)
+        {
+            Template::StrategyPartition<Template::IntValue<TemplateIntPipeline>> partition{};
+            partition.Reserve(valueCount);
+            for(const int32_t payload: payloads)
+            {
+                partition.Add(payload);
+            }
+
+            meter.measure(
+                [&partition]()
+                {
+                    partition.Operation();
+                });
+        };
+
+        BENCHMARK_ADVANCED("Template std::unique_ptr Sequential (3 passes)")(Catch::Benchmark::Chronometer meter)
+        {
+            using IncrementValue = Template::IntValue<Template::IncrementValueOperationStrategy>;
+            using ClampValue = Template::IntValue<Template::ClampValueOperationStrategy<Minimum, Maximum>>;
+            using ScaleValue = Template::IntValue<Template::ScaleValueOperationStrategy<Factor>>;
+
+            // One population per Strategy, as the strategy of a Template value is fixed by its type
+            std::vector<std::unique_ptr<Template::Value>> incrementValues{};
+            std::vector<std::unique_ptr<Template::Value>> clampValues{};
+            std::vector<std::unique_ptr<Template::Value>> scaleValues{};
+            for(const int32_t payload: payloads)
+            {
+                incrementValues.push_back(std::make_unique<IncrementValue>(payload));
+                clampValues.push_back(std::make_unique<ClampValue>(payload));
+                scaleValues.push_back(std::make_unique<ScaleValue>(payload));
+            }
+
+            meter.measure(
+                [&incrementValues, &clampValues, &scaleValues]()
+                {
+                    for(const auto* values: {&incrementValues, &clampValues, &scaleValues})
+                    {
+                        for(const std::unique_ptr<Template::Value>& value: *values)
+                        {
+                            value->Operation();
+                        }
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("Template std::unique_ptr Fused")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Template::Value>> values{};
+            values.reserve(valueCount);
+            for(const int32_t payload: payloads)
+            {
+                values.push_back(std::make_unique<Template::IntValue<TemplateIntPipeline>>(payload));
+            }
+
+            meter.measure(
+                [&values]()
+                {
+                    for(const std::unique_ptr<Template::Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("ValueSemantics Sequential (3 passes)")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<ValueSemantics::IntValue> values{};
+            values.reserve(valueCount);
+            for(const int32_t payload: payloads)
+            {
+                values.emplace_back(payload, ValueSemantics::IntValue::OperationStrategy{});
+            }
+
+            std::array<ValueSemantics::IntValue::OperationStrategy, 3> pipeline{GetValueSemanticsIntPipeline()};
+            meter.measure(
+                [&values, &pipeline]()
+                {
+                    for(ValueSemantics::IntValue::OperationStrategy& operationStrategy: pipeline)
+                    {
+                        for(ValueSemantics::IntValue& value: values)
+                        {
+                            operationStrategy(value);
+                        }
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("ValueSemantics Fused")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<ValueSemantics::IntValue> values{};
+            values.reserve(valueCount);
+            for(const int32_t payload: payloads)
+            {
+                values.emplace_back(payload, GetValueSemanticsIntComposition());
+            }
+
+            meter.measure(
+                [&values]()
+                {
+                    for(ValueSemantics::IntValue& value: values)
+                    {
+                        value.Operation();
+                    }
+                });
+        };
+    }
+
+    TEST_CASE("Strategy - Composition - Unit Tests")
+    {
+        SECTION("Template Payloads")
+        {
+            int32_t value{Maximum};
+            TemplateIntPipeline{}(value);
+            REQUIRE(value == Maximum * Factor);
+
+            std::array<int32_t, 5> values{Minimum - 10, -1, 0, 10, Maximum};
+            TemplateIntPipeline{}(std::span<int32_t>{values});
+            REQUIRE(values == std::array<int32_t, 5>{
+                Minimum * Factor, 0, Factor, 11 * Factor, Maximum * Factor});
+
+            float_t floatValue{0.5f};
+            TemplateFloatPipeline{}(floatValue);
+            REQUIRE(floatValue == 4.5f);
+        }
+
+        SECTION("Template Values")
+        {
+            Template::IntValue<TemplateIntPipeline> intValue{10};
+            intValue.Operation();
+            REQUIRE(intValue.GetValue() == ApplyPipeline(10));
+
+            Template::StrategyPartition<Template::IntValue<TemplateIntPipeline>> partition{};
+            partition.Add(-5'000);
+            partition.Add(7);
+            partition.Operation();
+            REQUIRE(partition.GetValues()[0] == ApplyPipeline(-5'000));
+            REQUIRE(partition.GetValues()[1] == ApplyPipeline(7));
+
+            // Generic strategies work on the value object and on the payload
+            using GenericPipeline = decltype(Template::Compose(
+                Template::IncrementValueOperationStrategy{},
+                Template::IncrementValueOperationStrategy{},
+                Template::DecrementValueOperationStrategy{}));
+            Template::FloatValue<GenericPipeline> floatValue{0.0f};
+            floatValue.Operation();
+            REQUIRE(floatValue.GetValue() == 1.0f);
+        }
+
+        SECTION("Value Semantics")
+        {
+            ValueSemantics::IntValue intValue{1'500, GetValueSemanticsIntComposition()};
+            intValue.Operation();
+            REQUIRE(intValue.GetValue() == ApplyPipeline(1'500));
+
+            ValueSemantics::IntValue sequentialValue{42, ValueSemantics::IntValue::OperationStrategy{}};
+            for(ValueSemantics::IntValue::OperationStrategy& operationStrategy: GetValueSemanticsIntPipeline())
+            {
+                operationStrategy(sequentialValue);
+            }
+
+            intValue.SetValue(42);
+            intValue.Operation();
+            REQUIRE(intValue.GetValue() == sequentialValue.GetValue());
+
+            // std::function strategies compose as well
+            ValueSemantics::FloatValue floatValue{2.0f, ValueSemantics::Compose(
+                ValueSemantics::GetDecrementFloatValueOperationStrategy(),
+                ValueSemantics::ScaleValueOperationStrategy<ValueSemantics::FloatValue>{0.5f})};
+            floatValue.Operation();
+            REQUIRE(floatValue.GetValue() == 0.5f);
+        }
+    }
+
+    TEST_CASE("Strategy - Composition - Benchmark")
+    {
+        RunFusedBenchmarks(1'000'000);
+    }
+
+    // 10M values, run with "[fused]"
+    TEST_CASE("Strategy - Composition - 10M Benchmark", "[.][fused]")
+    {
+        RunFusedBenchmarks(10'000'000);
+    }
+}
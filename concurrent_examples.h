@@ -0,0 +1,362 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "rng.h"
+#include "template_examples.h"
+#include "threadpool.h"
+
+// Values that any number of threads can apply strategies to at the same time.
+// Counters only need atomicity and not ordering, so every access is relaxed.
+namespace Concurrent
+{
+    // A single atomic, int32_t is updated with fetch_add and float_t with a compare and swap loop
+    template<typename TValueType>
+    class AtomicStorage
+    {
+    public:
+        using ValueType = TValueType;
+
+        explicit AtomicStorage(const TValueType value)
+            : m_Value{value}
+        {
+        }
+
+        void Add(const TValueType delta)
+        {
+            if constexpr(std::is_integral_v<TValueType>)
+            {
+                m_Value.fetch_add(delta, std::memory_order_relaxed);
+            }
+            else
+            {
+                TValueType expected{m_Value.load(std::memory_order_relaxed)};
+                while(!m_Value.compare_exchange_weak(expected, expected + delta, std::memory_order_relaxed))
+                {
+                }
+            }
+        }
+
+        TValueType Load() const { return m_Value.load(std::memory_order_relaxed); }
+    private:
+        std::atomic<TValueType> m_Value{};
+    };
+
+    namespace Detail
+    {
+        // Pool workers take the stripe of their worker index, so up to TStripeCount workers of one pool never
+        // share a cache line. Other threads hash their id and usually get distinct stripes.
+        inline size_t GetStripeIndex()
+        {
+            if(const std::optional<size_t> workerIndex{ThreadPool::GetCurrentWorkerIndex()})
+                return *workerIndex;
+
+            static thread_local const size_t stripeIndex{
+                static_cast<size_t>(Rng::Mix(std::hash<std::thread::id>{}(std::this_thread::get_id())))};
+            return stripeIndex;
+        }
+    }
+
+    // One cache line padded AtomicStorage per stripe for values under high contention.
+    // Writes only touch the stripe of the calling thread, Load() merges all stripes and is not a snapshot:
+    // concurrent additions may or may not be included.
+    template<typename TValueType, size_t TStripeCount = 32>
+    class StripedStorage
+    {
+    public:
+        using ValueType = TValueType;
+
+        explicit StripedStorage(const TValueType value)
+        {
+            m_Stripes[0].m_Storage.Add(value);
+        }
+
+        void Add(const TValueType delta)
+        {
+            m_Stripes[Detail::GetStripeIndex() % TStripeCount].m_Storage.Add(delta);
+        }
+
+        TValueType Load() const
+        {
+            TValueType value{0};
+            for(const Stripe& stripe: m_Stripes)
+            {
+                value += stripe.m_Storage.Load();
+            }
+
+            return value;
+        }
+    private:
+        struct alignas(64) Stripe
+        {
+            AtomicStorage<TValueType> m_Storage{0};
+        };
+
+        std::array<Stripe, TStripeCount> m_Stripes{};
+    };
+
+    template<typename TStorage, typename TOperationStrategy>
+    class ConcurrentValue final : public Template::Value
+    {
+    public:
+        using OperationStrategy = TOperationStrategy;
+        using ValueType = typename TStorage::ValueType;
+
+        explicit ConcurrentValue(const ValueType value)
+            : m_Storage{value}
+        {
+        }
+
+        // Strategies are stateless, concurrent calls only share m_Storage
+        void Operation() override
+        {
+            m_OperationStrategy(*this);
+        }
+
+        void Add(const ValueType delta) { m_Storage.Add(delta); }
+        ValueType GetValue() const { return m_Storage.Load(); }
+    private:
+        TEMPLATE_NO_UNIQUE_ADDRESS TOperationStrategy m_OperationStrategy{};
+        TStorage m_Storage;
+    };
+
+    template<typename TOperationStrategy>
+    using AtomicIntValue = ConcurrentValue<AtomicStorage<int32_t>, TOperationStrategy>;
+
+    template<typename TOperationStrategy>
+    using AtomicFloatValue = ConcurrentValue<AtomicStorage<float_t>, TOperationStrategy>;
+
+    template<typename TOperationStrategy>
+    using StripedIntValue = ConcurrentValue<StripedStorage<int32_t>, TOperationStrategy>;
+
+    template<typename TOperationStrategy>
+    using StripedFloatValue = ConcurrentValue<StripedStorage<float_t>, TOperationStrategy>;
+
+    // Strategies apply to every ConcurrentValue of their value type, so a value can also be mutated with a
+    // strategy other than its own, e.g. DecrementIntValueOperationStrategy{}(incrementValue)
+    class IncrementIntValueOperationStrategy
+    {
+    public:
+        template<typename TStorage, typename TOperationStrategy>
+        void operator()(ConcurrentValue<TStorage, TOperationStrategy>& value) const
+        {
+            value.Add(1);
+        }
+    };
+
+    class DecrementIntValueOperationStrategy
+    {
+    public:
+        template<typename TStorage, typename TOperationStrategy>
+        void operator()(ConcurrentValue<TStorage, TOperationStrategy>& value) const
+        {
+            value.Add(-1);
+        }
+    };
+
+    class IncrementFloatValueOperationStrategy
+    {
+    public:
+        template<typename TStorage, typename TOperationStrategy>
+        void operator()(ConcurrentValue<TStorage, TOperationStrategy>& value) const
+        {
+            value.Add(1.0f);
+        }
+    };
+
+    class DecrementFloatValueOperationStrategy
+    {
+    public:
+        template<typename TStorage, typename TOperationStrategy>
+        void operator()(ConcurrentValue<TStorage, TOperationStrategy>& value) const
+        {
+            value.Add(-1.0f);
+        }
+    };
+
+    static_assert(std::atomic<int32_t>::is_always_lock_free && std::atomic<float_t>::is_always_lock_free);
+
+    // Half of the threads apply the value's own Operation() and half apply TOtherStrategy
+    template<typename TValue, typename TOtherStrategy>
+    void RunMixed(TValue& value, ThreadPool& threadPool, const uint32_t operationCount)
+    {
+        threadPool.Run(
+            [&value, operationCount](const size_t workerIndex)
+            {
+                for(uint32_t operation{0}; operation != operationCount; ++operation)
+                {
+                    if(workerIndex % 2 == 0)
+                        value.Operation();
+                    else
+                        TOtherStrategy{}(value);
+                }
+            });
+    }
+
+    TEST_CASE("Strategy - Concurrent - Unit Tests")
+    {
+        constexpr uint32_t operationCount{20'000};
+        ThreadPool threadPool{8};
+
+        SECTION("Single thread")
+        {
+            AtomicIntValue<IncrementIntValueOperationStrategy> intValue{10};
+            intValue.Operation();
+            DecrementIntValueOperationStrategy{}(intValue);
+            DecrementIntValueOperationStrategy{}(intValue);
+            REQUIRE(intValue.GetValue() == 9);
+
+            StripedFloatValue<DecrementFloatValueOperationStrategy> floatValue{10.0f};
+            floatValue.Operation();
+            REQUIRE(floatValue.GetValue() == 9.0f);
+        }
+
+        SECTION("No lost updates")
+        {
+            AtomicIntValue<IncrementIntValueOperationStrategy> atomicIntValue{0};
+            AtomicFloatValue<IncrementFloatValueOperationStrategy> atomicFloatValue{0.0f};
+            StripedIntValue<IncrementIntValueOperationStrategy> stripedIntValue{0};
+            StripedFloatValue<IncrementFloatValueOperationStrategy> stripedFloatValue{0.0f};
+            threadPool.Run(
+                [&](const size_t)
+                {
+                    for(uint32_t operation{0}; operation != operationCount; ++operation)
+                    {
+                        atomicIntValue.Operation();
+                        atomicFloatValue.Operation();
+                        stripedIntValue.Operation();
+                        stripedFloatValue.Operation();
+                    }
+                });
+
+            // Whole numbers below 2^24 are exact in float_t, so the float sums do not depend on the order
+            REQUIRE(atomicIntValue.GetValue() == 8 * operationCount);
+            REQUIRE(atomicFloatValue.GetValue() == 8.0f * operationCount);
+            REQUIRE(stripedIntValue.GetValue() == 8 * operationCount);
+            REQUIRE(stripedFloatValue.GetValue() == 8.0f * operationCount);
+        }
+
+        SECTION("Mixed strategies on one value")
+        {
+            AtomicIntValue<IncrementIntValueOperationStrategy> atomicIntValue{100};
+            RunMixed<decltype(atomicIntValue), DecrementIntValueOperationStrategy>(
+                atomicIntValue, threadPool, operationCount);
+            REQUIRE(atomicIntValue.GetValue() == 100);
+
+            StripedFloatValue<DecrementFloatValueOperationStrategy> stripedFloatValue{100.0f};
+            RunMixed<decltype(stripedFloatValue), IncrementFloatValueOperationStrategy>(
+                stripedFloatValue, threadPool, operationCount);
+            REQUIRE(stripedFloatValue.GetValue() == 100.0f);
+        }
+    }
+
+    // Every thread mutates the same value, the total work grows with the thread count
+    TEST_CASE("Strategy - Concurrent - Benchmark")
+    {
+        constexpr uint32_t operationCount{100'000};
+
+        for(const size_t threadCount: {1, 2, 4, 8, 16, 32})
+        {
+            ThreadPool threadPool{threadCount};
+            const std::string suffix{" - " + std::to_string(threadCount) + " Threads"};
+
+            BENCHMARK_ADVANCED("Mutex" + suffix)(Catch::Benchmark::Chronometer meter)
+            {
+                Template::IntValue<Template::IncrementIntValueOperationStrategy> value{0};
+                std::mutex mutex{};
+                meter.measure(
+                    [&]()
+                    {
+                        threadPool.Run(
+                            [&](const size_t)
+                            {
+                                for(uint32_t operation{0}; operation != operationCount; ++operation)
+                                {
+                                    const std::lock_guard lock{mutex};
+                                    value.Operation();
+                                }
+                            });
+                    });
+            };
+
+            BENCHMARK_ADVANCED("Atomic Int" + suffix)(Catch::Benchmark::Chronometer meter)
+            {
+                AtomicIntValue<IncrementIntValueOperationStrategy> value{0};
+                meter.measure(
+                    [&]()
+                    {
+                        threadPool.Run(
+                            [&](const size_t)
+                            {
+                                for(uint32_t operation{0}; operation != operationCount; ++operation)
+                                {
+                                    value.Operation();
+                                }
+                            });
+                    });
+            };
+
+            BENCHMARK_ADVANCED("Striped Int" + suffix)(Catch::Benchmark::Chronometer meter)
+            {
+                StripedIntValue<IncrementIntValueOperationStrategy> value{0};
+                meter.measure(
+                    [&]()
+                    {
+                        threadPool.Run(
+                            [&](const size_t)
+                            {
+                                for(uint32_t operation{0}; operation != operationCount; ++operation)
+                                {
+                                    value.Operation();
+                                }
+                            });
+                    });
+            };
+
+            BENCHMARK_ADVANCED("Atomic Float" + suffix)(Catch::Benchmark::Chronometer meter)
+            {
+                AtomicFloatValue<IncrementFloatValueOperationStrategy> value{0.0f};
+                meter.measure(
+                    [&]()
+                    {
+                        threadPool.Run(
+                            [&](const size_t)
+                            {
+                                for(uint32_t operation{0}; operation != operationCount; ++operation)
+                                {
+                                    value.Operation();
+                                }
+                            });
+                    });
+            };
+
+            BENCHMARK_ADVANCED("Striped Float" + suffix)(Catch::Benchmark::Chronometer meter)
+            {
+                StripedFloatValue<IncrementFloatValueOperationStrategy> value{0.0f};
+                meter.measure(
+                    [&]()
+                    {
+                        threadPool.Run(
+                            [&](const size_t)
+                            {
+                                for(uint32_t operation{0}; operation != operationCount; ++operation)
+                                {
+                                    value.Operation();
+                                }
+                            });
+                    });
+            };
+        }
+    }
+}
@@ -0,0 +1,516 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "composition_examples.h"
+#include "rng.h"
+#include "simd.h"
+#include "strategycollection_examples.h"
+#include "template_examples.h"
+#include "typelist_examples.h"
+
+namespace Template
+{
+    // Change of the payload per Operation() for strategies that add a constant. Such operations commute, so
+    // any number of them can be applied later as a single addition of count * Value.
+    template<typename TOperationStrategy>
+    struct OperationDelta;
+
+    template<>
+    struct OperationDelta<IncrementIntValueOperationStrategy>
+    {
+        static constexpr int32_t Value{1};
+    };
+
+    template<>
+    struct OperationDelta<DecrementIntValueOperationStrategy>
+    {
+        static constexpr int32_t Value{-1};
+    };
+
+    template<>
+    struct OperationDelta<IncrementFloatValueOperationStrategy>
+    {
+        static constexpr float_t Value{1.0f};
+    };
+
+    template<>
+    struct OperationDelta<DecrementFloatValueOperationStrategy>
+    {
+        static constexpr float_t Value{-1.0f};
+    };
+
+    template<>
+    struct OperationDelta<IncrementValueOperationStrategy>
+    {
+        static constexpr int32_t Value{1};
+    };
+
+    template<>
+    struct OperationDelta<DecrementValueOperationStrategy>
+    {
+        static constexpr int32_t Value{-1};
+    };
+
+    template<typename TOperationStrategy>
+    concept DeferrableOperationStrategy = requires { OperationDelta<TOperationStrategy>::Value; };
+
+    template<typename TValueType, DeferrableOperationStrategy TOperationStrategy>
+    constexpr TValueType GetDelta(const int64_t operationCount)
+    {
+        return static_cast<TValueType>(operationCount * OperationDelta<TOperationStrategy>::Value);
+    }
+
+    // Counts Operation() calls and applies them when the value is read.
+    // A float value is materialized with a single multiply-add, which rounds differently than adding 1.0f
+    // count times once the value exceeds 2^24.
+    template<typename TValueType, DeferrableOperationStrategy TOperationStrategy>
+    class DeferredValue final : public Value
+    {
+    public:
+        using OperationStrategy = TOperationStrategy;
+        using ValueType = TValueType;
+
+        explicit DeferredValue(const TValueType value)
+            : m_Value{value}
+        {
+        }
+
+        void Operation() override
+        {
+            ++m_PendingOperationCount;
+        }
+
+        TValueType GetValue() const
+        {
+            Materialize();
+            return m_Value;
+        }
+
+        void SetValue(const TValueType value)
+        {
+            m_Value = value;
+            m_PendingOperationCount = 0;
+        }
+
+        int64_t GetPendingOperationCount() const { return m_PendingOperationCount; }
+    private:
+        void Materialize() const
+        {
+            if(m_PendingOperationCount == 0)
+                return;
+
+            m_Value += GetDelta<TValueType, TOperationStrategy>(m_PendingOperationCount);
+            m_PendingOperationCount = 0;
+        }
+
+        mutable TValueType m_Value{};
+        mutable int64_t m_PendingOperationCount{0};
+    };
+
+    template<typename TOperationStrategy>
+    using DeferredIntValue = DeferredValue<int32_t, TOperationStrategy>;
+
+    template<typename TOperationStrategy>
+    using DeferredFloatValue = DeferredValue<float_t, TOperationStrategy>;
+
+    // Deferred counterpart of StrategyPartition.
+    // Operation() on the whole partition only counts, Operation(index) counts per value and marks the value
+    // in a dirty bitmap, recording the index of each bitmap word that becomes dirty. Flush() only visits the
+    // recorded words, so its cost depends on the values touched since the last Flush() rather than on the
+    // partition size. GetValue() includes the pending operations
+    // without flushing. Flush() at least every 2^31 operations of a single value.
+    // A value added while partition operations are pending is stored as passed in and only receives the
+    // operations counted after it. Values added at the same partition operation count form a run, only the
+    // start of each run is recorded, so a partition without Add() between partition operations has no runs.
+    template<typename TValue>
+    class DeferredStrategyPartition
+    {
+    public:
+        using OperationStrategy = typename TValue::OperationStrategy;
+        using ValueType = typename TValue::ValueType;
+
+        static_assert(DeferrableOperationStrategy<OperationStrategy>,
+            "The Strategy of TValue has no OperationDelta");
+
+        void Reserve(const size_t count)
+        {
+            m_Values.reserve(count);
+            m_PendingOperationCounts.reserve(count);
+            m_DirtyWords.reserve((count + 63) / 64);
+            m_DirtyWordIndices.reserve((count + 63) / 64);
+        }
+
+        void Add(const ValueType value)
+        {
+            const int64_t lastBaseOperationCount{m_Runs.empty() ? 0 : m_Runs.back().m_BaseOperationCount};
+            if(m_PendingPartitionOperationCount != lastBaseOperationCount)
+            {
+                m_Runs.push_back(Run{
+                    .m_FirstIndex = m_Values.size(),
+                    .m_BaseOperationCount = m_PendingPartitionOperationCount});
+            }
+
+            m_Values.push_back(value);
+            m_PendingOperationCounts.push_back(0);
+            if(m_DirtyWords.size() * 64 < m_Values.size())
+            {
+                m_DirtyWords.push_back(0);
+            }
+        }
+
+        void Operation()
+        {
+            ++m_PendingPartitionOperationCount;
+        }
+
+        void Operation(const size_t index)
+        {
+            ++m_PendingOperationCounts[index];
+            uint64_t& dirtyWord{m_DirtyWords[index / 64]};
+            if(dirtyWord == 0)
+                m_DirtyWordIndices.push_back(index / 64);
+
+            dirtyWord |= uint64_t{1} << (index % 64);
+        }
+
+        ValueType GetValue(const size_t index) const
+        {
+            const int64_t operationCount{int64_t{m_PendingOperationCounts[index]} +
+                m_PendingPartitionOperationCount - GetBaseOperationCount(index)};
+            return m_Values[index] + GetDelta<ValueType, OperationStrategy>(operationCount);
+        }
+
+        void Flush()
+        {
+            for(const size_t word: m_DirtyWordIndices)
+            {
+                for(uint64_t bits{std::exchange(m_DirtyWords[word], 0)}; bits != 0; bits &= bits - 1)
+                {
+                    const size_t index{word * 64 + static_cast<size_t>(std::countr_zero(bits))};
+                    m_Values[index] +=
+                        GetDelta<ValueType, OperationStrategy>(m_PendingOperationCounts[index]);
+                    m_PendingOperationCounts[index] = 0;
+                }
+            }
+
+            m_DirtyWordIndices.clear();
+
+            if(m_PendingPartitionOperationCount == 0)
+                return;
+
+            // Values before the first run were added at 0
+            const auto addDelta{
+                [this](const size_t begin, const size_t end, const int64_t baseOperationCount)
+                {
+                    if(begin != end && baseOperationCount != m_PendingPartitionOperationCount)
+                    {
+                        const int64_t operationCount{m_PendingPartitionOperationCount - baseOperationCount};
+                        Simd::Add(std::span<ValueType>{m_Values}.subspan(begin, end - begin),
+                            GetDelta<ValueType, OperationStrategy>(operationCount));
+                    }
+                }};
+
+            addDelta(0, m_Runs.empty() ? m_Values.size() : m_Runs.front().m_FirstIndex, 0);
+            for(size_t run{0}; run != m_Runs.size(); ++run)
+            {
+                const size_t end{run + 1 == m_Runs.size() ? m_Values.size() : m_Runs[run + 1].m_FirstIndex};
+                addDelta(m_Runs[run].m_FirstIndex, end, m_Runs[run].m_BaseOperationCount);
+            }
+
+            m_Runs.clear();
+            m_PendingPartitionOperationCount = 0;
+        }
+
+        size_t GetSize() const { return m_Values.size(); }
+
+        size_t GetDirtyCount() const
+        {
+            size_t dirtyCount{0};
+            for(const size_t word: m_DirtyWordIndices)
+            {
+                dirtyCount += static_cast<size_t>(std::popcount(m_DirtyWords[word]));
+            }
+
+            return dirtyCount;
+        }
+
+        // Payloads without the pending operations, call Flush() first
+        std::span<const ValueType> GetValues() const { return m_Values; }
+    private:
+        // Values from m_FirstIndex up to the next run were added at m_BaseOperationCount
+        struct Run
+        {
+            size_t m_FirstIndex{0};
+            int64_t m_BaseOperationCount{0};
+        };
+
+        int64_t GetBaseOperationCount(const size_t index) const
+        {
+            const auto it{std::ranges::upper_bound(m_Runs, index, {}, &Run::m_FirstIndex)};
+            return it == m_Runs.begin() ? 0 : std::prev(it)->m_BaseOperationCount;
+        }
+
+        std::vector<ValueType> m_Values{};
+        // Ordered by m_FirstIndex, with increasing base counts
+        std::vector<Run> m_Runs{};
+        std::vector<int32_t> m_PendingOperationCounts{};
+        std::vector<uint64_t> m_DirtyWords{};
+        // Words of m_DirtyWords with at least one bit set, in the order they became dirty
+        std::vector<size_t> m_DirtyWordIndices{};
+        int64_t m_PendingPartitionOperationCount{0};
+    };
+
+    TEST_CASE("Strategy - Deferred - Unit Tests")
+    {
+        SECTION("DeferredValue")
+        {
+            DeferredIntValue<IncrementIntValueOperationStrategy> intValue{10};
+            for(uint32_t i{0}; i != 1'000; ++i)
+            {
+                intValue.Operation();
+            }
+
+            REQUIRE(intValue.GetPendingOperationCount() == 1'000);
+            REQUIRE(intValue.GetValue() == 1'010);
+            REQUIRE(intValue.GetPendingOperationCount() == 0);
+
+            intValue.Operation();
+            intValue.SetValue(0);
+            REQUIRE(intValue.GetValue() == 0);
+
+            std::unique_ptr<Value> floatValue{
+                std::make_unique<DeferredFloatValue<DecrementFloatValueOperationStrategy>>(0.5f)};
+            floatValue->Operation();
+            floatValue->Operation();
+            REQUIRE(static_cast<const DeferredFloatValue<DecrementFloatValueOperationStrategy>&>(*floatValue)
+                .GetValue() == -1.5f);
+
+            DeferredIntValue<DecrementValueOperationStrategy> genericValue{0};
+            genericValue.Operation();
+            REQUIRE(genericValue.GetValue() == -1);
+
+            STATIC_REQUIRE(
+                !DeferrableOperationStrategy<decltype(Compose(IncrementIntValueOperationStrategy{}))>);
+        }
+
+        SECTION("DeferredStrategyPartition")
+        {
+            DeferredStrategyPartition<IntValue<IncrementIntValueOperationStrategy>> partition{};
+            for(int32_t i{0}; i != 200; ++i)
+            {
+                partition.Add(i);
+            }
+
+            partition.Operation();
+            partition.Operation(3);
+            partition.Operation(3);
+            partition.Operation(130);
+            REQUIRE(partition.GetDirtyCount() == 2);
+            REQUIRE(partition.GetValue(0) == 1);
+            REQUIRE(partition.GetValue(3) == 6);
+            REQUIRE(partition.GetValue(130) == 132);
+
+            // Added after the pending partition Operation(), which must not apply to it
+            partition.Add(1'000);
+            REQUIRE(partition.GetValue(200) == 1'000);
+
+            partition.Flush();
+            REQUIRE(partition.GetDirtyCount() == 0);
+            REQUIRE(partition.GetValues()[0] == 1);
+            REQUIRE(partition.GetValues()[3] == 6);
+            REQUIRE(partition.GetValues()[130] == 132);
+            REQUIRE(partition.GetValues()[199] == 200);
+            REQUIRE(partition.GetValues()[200] == 1'000);
+
+            DeferredStrategyPartition<FloatValue<DecrementFloatValueOperationStrategy>> floatPartition{};
+            floatPartition.Add(0.0f);
+            floatPartition.Operation(0);
+            floatPartition.Operation();
+            floatPartition.Flush();
+            REQUIRE(floatPartition.GetValues()[0] == -2.0f);
+        }
+
+        SECTION("Values added between partition operations")
+        {
+            // 1e-8f - 1.0f + 1.0f would round to 0.0f
+            DeferredStrategyPartition<FloatValue<IncrementFloatValueOperationStrategy>> floatPartition{};
+            floatPartition.Add(0.0f);
+            floatPartition.Operation();
+            floatPartition.Add(1e-8f);
+            floatPartition.Add(2e-8f);
+            floatPartition.Operation();
+            floatPartition.Add(3e-8f);
+            REQUIRE(floatPartition.GetValue(1) == 1.0f + 1e-8f);
+            REQUIRE(floatPartition.GetValue(3) == 3e-8f);
+
+            floatPartition.Flush();
+            REQUIRE(std::ranges::equal(floatPartition.GetValues(),
+                std::vector<float_t>{2.0f, 1.0f + 1e-8f, 1.0f + 2e-8f, 3e-8f}));
+            floatPartition.Operation();
+            floatPartition.Flush();
+            REQUIRE(floatPartition.GetValues()[3] == 1.0f + 3e-8f);
+
+            // Subtracting the pending operations from the value would overflow
+            DeferredStrategyPartition<IntValue<IncrementIntValueOperationStrategy>> intPartition{};
+            intPartition.Add(0);
+            intPartition.Operation();
+            intPartition.Operation();
+            intPartition.Add(std::numeric_limits<int32_t>::min());
+            REQUIRE(intPartition.GetValue(0) == 2);
+            REQUIRE(intPartition.GetValue(1) == std::numeric_limits<int32_t>::min());
+
+            intPartition.Flush();
+            REQUIRE(intPartition.GetValues()[1] == std::numeric_limits<int32_t>::min());
+        }
+    }
+
+    // Many writes between rare reads
+    TEST_CASE("Strategy - Deferred - Benchmark")
+    {
+        constexpr uint32_t valueCount{100'000};
+        constexpr uint32_t operationCount{100};
+
+        BENCHMARK_ADVANCED("std::unique_ptr Eager")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<IntValue<IncrementIntValueOperationStrategy>>> values{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(std::make_unique<IntValue<IncrementIntValueOperationStrategy>>(0));
+            }
+
+            meter.measure(
+                [&values]()
+                {
+                    int64_t sum{0};
+                    for(uint32_t operation{0}; operation != operationCount; ++operation)
+                    {
+                        for(const auto& value: values)
+                        {
+                            static_cast<Value&>(*value).Operation();
+                        }
+                    }
+
+                    for(const auto& value: values)
+                    {
+                        sum += value->GetValue();
+                    }
+
+                    return sum;
+                });
+        };
+
+        BENCHMARK_ADVANCED("std::unique_ptr Deferred")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<DeferredIntValue<IncrementIntValueOperationStrategy>>> values{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(std::make_unique<DeferredIntValue<IncrementIntValueOperationStrategy>>(0));
+            }
+
+            meter.measure(
+                [&values]()
+                {
+                    int64_t sum{0};
+                    for(uint32_t operation{0}; operation != operationCount; ++operation)
+                    {
+                        for(const auto& value: values)
+                        {
+                            static_cast<Value&>(*value).Operation();
+                        }
+                    }
+
+                    for(const auto& value: values)
+                    {
+                        sum += value->GetValue();
+                    }
+
+                    return sum;
+                });
+        };
+
+        BENCHMARK_ADVANCED("StrategyPartition Eager")(Catch::Benchmark::Chronometer meter)
+        {
+            StrategyPartition<FloatValue<IncrementFloatValueOperationStrategy>> partition{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                partition.Add(0.0f);
+            }
+
+            meter.measure(
+                [&partition]()
+                {
+                    for(uint32_t operation{0}; operation != operationCount; ++operation)
+                    {
+                        partition.Operation();
+                    }
+
+                    return partition.GetValues()[0];
+                });
+        };
+
+        BENCHMARK_ADVANCED("DeferredStrategyPartition")(Catch::Benchmark::Chronometer meter)
+        {
+            DeferredStrategyPartition<FloatValue<IncrementFloatValueOperationStrategy>> partition{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                partition.Add(0.0f);
+            }
+
+            meter.measure(
+                [&partition]()
+                {
+                    for(uint32_t operation{0}; operation != operationCount; ++operation)
+                    {
+                        partition.Operation();
+                    }
+
+                    partition.Flush();
+                    return partition.GetValues()[0];
+                });
+        };
+
+        // 1% of the values receive operationCount operations each before the flush
+        constexpr uint32_t touchedCount{valueCount / 100};
+        std::vector<uint32_t> touchedIndices(touchedCount);
+        Rng::Generator generator{};
+        for(uint32_t& index: touchedIndices)
+        {
+            index = static_cast<uint32_t>(generator() % valueCount);
+        }
+
+        BENCHMARK_ADVANCED("DeferredStrategyPartition Sparse Flush")(Catch::Benchmark::Chronometer meter)
+        {
+            DeferredStrategyPartition<IntValue<IncrementIntValueOperationStrategy>> partition{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                partition.Add(0);
+            }
+
+            meter.measure(
+                [&partition, &touchedIndices]()
+                {
+                    for(uint32_t operation{0}; operation != operationCount; ++operation)
+                    {
+                        for(const uint32_t index: touchedIndices)
+                        {
+                            partition.Operation(index);
+                        }
+                    }
+
+                    partition.Flush();
+                    return partition.GetValues()[touchedIndices[0]];
+                });
+        };
+    }
+}
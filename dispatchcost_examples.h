@@ -0,0 +1,466 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "adaptive_examples.h"
+#include "benchmarksuite_examples.h"
+#include "cacheinfo.h"
+#include "packedvalues_examples.h"
+
+// Nanoseconds per Operation() of every engine on populations built up front from a fixed seed, so the timed
+// loop contains nothing but the dispatch and the strategy. Populations are run in sorted order (all values of
+// a type together, predictable branches and indirect calls) and shuffled order, at footprints meant to stay
+// resident in L1, L2, the last level cache and DRAM. Every engine's value count is derived from its own
+// bytes per value. Results are written as JSON to track regressions.
+namespace DispatchCost
+{
+    using BenchmarkSuite::ValueKind;
+
+    enum class Order : uint8_t
+    {
+        Sorted,
+        Shuffled
+    };
+
+    enum class Residency : uint8_t
+    {
+        L1,
+        L2,
+        LastLevel,
+        Dram
+    };
+
+    std::string GetName(const Order order)
+    {
+        return order == Order::Sorted ? "sorted" : "shuffled";
+    }
+
+    std::string GetName(const Residency residency)
+    {
+        switch(residency)
+        {
+        case Residency::L1:
+            return "L1";
+        case Residency::L2:
+            return "L2";
+        case Residency::LastLevel:
+            return "LLC";
+        case Residency::Dram:
+            return "DRAM";
+        }
+
+        return "Unknown";
+    }
+
+    struct SizeClass
+    {
+        Residency m_Residency{Residency::L1};
+        // Footprint of the population
+        size_t m_Bytes{0};
+    };
+
+    // Half of each cache level, and four times the last level for DRAM
+    std::vector<SizeClass> GetSizeClasses(const CacheInfo::CacheSizes& cacheSizes)
+    {
+        return {
+            {Residency::L1, cacheSizes.m_L1Data / 2},
+            {Residency::L2, cacheSizes.m_L2 / 2},
+            {Residency::LastLevel, cacheSizes.m_LastLevel / 2},
+            {Residency::Dram, cacheSizes.m_LastLevel * 4}};
+    }
+
+    size_t GetValueCount(const SizeClass& sizeClass, const size_t bytesPerValue, const size_t maxValueCount)
+    {
+        return std::clamp<size_t>(sizeClass.m_Bytes / std::max<size_t>(bytesPerValue, 1), 1, maxValueCount);
+    }
+
+    // Mean bytes per value of the layouts whose name starts with layoutPrefix, e.g. "Template::" for the
+    // IntValue and FloatValue layouts of a population that holds half of each
+    size_t GetBytesPerValue(const std::string_view layoutPrefix)
+    {
+        static const std::vector<Template::LayoutInfo> layoutInfos{Template::GetLayoutInfos()};
+        size_t bytes{0};
+        size_t layoutCount{0};
+        for(const Template::LayoutInfo& layoutInfo: layoutInfos)
+        {
+            if(std::string_view{layoutInfo.m_Name}.starts_with(layoutPrefix))
+            {
+                bytes += layoutInfo.m_BytesPerValue;
+                ++layoutCount;
+            }
+        }
+
+        return layoutCount == 0 ? 0 : bytes / layoutCount;
+    }
+
+    // Layouts of the benchmark suite engines
+    template<typename TEngine>
+    std::string_view GetLayoutPrefix()
+    {
+        using namespace BenchmarkSuite;
+        if constexpr(std::is_same_v<TEngine, ReferenceSemanticsEngine>)
+            return "ReferenceSemantics::";
+        else if constexpr(std::is_same_v<TEngine, ValueSemanticsEngine>)
+            return "ValueSemantics::";
+        else if constexpr(std::is_same_v<TEngine, InlineValueSemanticsEngine>)
+            return "InlineValueSemantics::";
+        else if constexpr(std::is_same_v<TEngine, TemplateEngine>)
+            return "Template::";
+        else if constexpr(std::is_same_v<TEngine, ExternalPolymorphismEngine>)
+            return "ExternalPolymorphism::";
+        else if constexpr(std::is_same_v<TEngine, VariantSemanticsEngine>)
+            return "VariantSemantics::";
+        else if constexpr(std::is_same_v<TEngine, StrategyCollectionEngine>)
+            return "StrategyPartition payload";
+        else
+            return TEngine::LayoutPrefix;
+    }
+
+    // CreateValueKinds() is already in random order, sorting groups the values by type and strategy
+    std::vector<ValueKind> CreateValueKinds(const size_t valueCount, const Order order)
+    {
+        std::vector<ValueKind> valueKinds{BenchmarkSuite::CreateValueKinds(valueCount, 50)};
+        if(order == Order::Sorted)
+        {
+            std::ranges::stable_sort(valueKinds,
+                [](const ValueKind& lhs, const ValueKind& rhs)
+                {
+                    return std::tie(lhs.m_IsIntValue, lhs.m_IsIncrement) >
+                        std::tie(rhs.m_IsIntValue, rhs.m_IsIncrement);
+                });
+        }
+
+        return valueKinds;
+    }
+
+    // Engines added after the benchmark suite
+    struct PackedValuesEngine
+    {
+        static constexpr const char* Name{"Packed Values"};
+        static constexpr std::string_view LayoutPrefix{"PackedValues ("};
+        using Population = Template::PackedValues;
+
+        static Population Create(const std::span<const ValueKind> valueKinds)
+        {
+            Population values{};
+            for(const ValueKind& valueKind: valueKinds)
+            {
+                Template::AddValue(values, valueKind.m_IsIntValue, valueKind.m_IsIncrement);
+            }
+
+            return values;
+        }
+
+        static void Run(Population& values)
+        {
+            values.Operation();
+        }
+    };
+
+    struct AdaptiveEngine
+    {
+        static constexpr const char* Name{"Adaptive"};
+        // First estimate only, the population is sized again from the layout of the backend it chose
+        static constexpr std::string_view LayoutPrefix{"StrategyPartition payload"};
+
+        struct Population
+        {
+            // Private, so a winner cached for earlier populations does not decide the backend
+            std::unique_ptr<Adaptive::ProfileCache> m_ProfileCache{};
+            Adaptive::AdaptiveExecutor m_Executor;
+        };
+
+        static Population Create(const std::span<const ValueKind> valueKinds)
+        {
+            std::vector<Adaptive::ValueRecord> records(valueKinds.size());
+            for(size_t i{0}; i != valueKinds.size(); ++i)
+            {
+                records[i].m_StrategyId =
+                    Adaptive::GetStrategyId(valueKinds[i].m_IsIntValue, valueKinds[i].m_IsIncrement);
+            }
+
+            auto profileCache{std::make_unique<Adaptive::ProfileCache>()};
+            // No re-probing inside the timed loop
+            Adaptive::AdaptiveExecutor executor{
+                records, Adaptive::AdaptiveOptions{.m_ReprobeInterval = 0}, *profileCache};
+            return Population{std::move(profileCache), std::move(executor)};
+        }
+
+        // Layout Operation() touches. The canonical records are only read on export and the probe backends
+        // only hold the probe sample, neither is part of the timed footprint.
+        static std::string_view GetLayoutPrefix(const Population& population)
+        {
+            switch(population.m_Executor.GetBackendId())
+            {
+            case Adaptive::BackendId::Virtual:
+                return "ReferenceSemantics::";
+            case Adaptive::BackendId::Variant:
+                return "VariantSemantics::";
+            case Adaptive::BackendId::Partitioned:
+            case Adaptive::BackendId::Simd:
+            case Adaptive::BackendId::Count:
+                break;
+            }
+
+            return "StrategyPartition payload";
+        }
+
+        static std::string GetBackendName(const Population& population)
+        {
+            return Adaptive::GetName(population.m_Executor.GetBackendId());
+        }
+
+        static void Run(Population& population)
+        {
+            population.m_Executor.Operation();
+        }
+    };
+
+    struct Measurement
+    {
+        std::string m_Engine{};
+        // Chosen at runtime by engines like Adaptive, empty for the others
+        std::string m_Backend{};
+        Order m_Order{Order::Sorted};
+        Residency m_Residency{Residency::L1};
+        size_t m_BytesPerValue{0};
+        size_t m_ValueCount{0};
+        uint32_t m_PassCount{0};
+        double m_MinNanoseconds{0.0};
+        double m_MedianNanoseconds{0.0};
+    };
+
+    struct SuiteOptions
+    {
+        // Operation() calls per timed repetition, split into whole passes over the population
+        size_t m_OperationCount{10'000'000};
+        uint32_t m_RepetitionCount{5};
+        size_t m_MaxValueCount{16'000'000};
+    };
+
+    template<typename TEngine>
+    Measurement Measure(const SizeClass& sizeClass, const Order order, const SuiteOptions& options)
+    {
+        size_t bytesPerValue{GetBytesPerValue(GetLayoutPrefix<TEngine>())};
+        std::vector<ValueKind> valueKinds{
+            CreateValueKinds(GetValueCount(sizeClass, bytesPerValue, options.m_MaxValueCount), order)};
+        std::optional<typename TEngine::Population> population{};
+        population.emplace(TEngine::Create(valueKinds));
+        std::string backend{};
+        if constexpr(requires { TEngine::GetLayoutPrefix(*population); })
+        {
+            // The layout is chosen by the population, which is created once more if it differs from the
+            // estimate
+            const size_t chosenBytesPerValue{GetBytesPerValue(TEngine::GetLayoutPrefix(*population))};
+            if(chosenBytesPerValue != bytesPerValue)
+            {
+                valueKinds = CreateValueKinds(
+                    GetValueCount(sizeClass, chosenBytesPerValue, options.m_MaxValueCount), order);
+                population.reset();
+                population.emplace(TEngine::Create(valueKinds));
+                bytesPerValue = GetBytesPerValue(TEngine::GetLayoutPrefix(*population));
+            }
+
+            backend = TEngine::GetBackendName(*population);
+        }
+
+        const uint32_t passCount{static_cast<uint32_t>(
+            std::max<size_t>(options.m_OperationCount / std::max<size_t>(valueKinds.size(), 1), 1))};
+        TEngine::Run(*population);
+
+        std::vector<double> nanoseconds(std::max<uint32_t>(options.m_RepetitionCount, 1));
+        for(double& repetitionNanoseconds: nanoseconds)
+        {
+            const auto start{std::chrono::steady_clock::now()};
+            for(uint32_t pass{0}; pass != passCount; ++pass)
+            {
+                TEngine::Run(*population);
+            }
+
+            const std::chrono::duration<double, std::nano> duration{std::chrono::steady_clock::now() - start};
+            repetitionNanoseconds = duration.count() / (static_cast<double>(passCount) * valueKinds.size());
+        }
+
+        std::ranges::sort(nanoseconds);
+        return Measurement{
+            .m_Engine = TEngine::Name,
+            .m_Backend = backend,
+            .m_Order = order,
+            .m_Residency = sizeClass.m_Residency,
+            .m_BytesPerValue = bytesPerValue,
+            .m_ValueCount = valueKinds.size(),
+            .m_PassCount = passCount,
+            .m_MinNanoseconds = nanoseconds.front(),
+            .m_MedianNanoseconds = nanoseconds[nanoseconds.size() / 2]};
+    }
+
+    template<typename... TEngines>
+    std::vector<Measurement> RunSuite(
+        const std::span<const SizeClass> sizeClasses, const SuiteOptions& options)
+    {
+        std::vector<Measurement> measurements{};
+        for(const SizeClass& sizeClass: sizeClasses)
+        {
+            for(const Order order: {Order::Sorted, Order::Shuffled})
+            {
+                (measurements.push_back(Measure<TEngines>(sizeClass, order, options)), ...);
+            }
+        }
+
+        return measurements;
+    }
+
+    std::vector<Measurement> RunAllEngines(
+        const std::span<const SizeClass> sizeClasses, const SuiteOptions& options)
+    {
+        return RunSuite<
+            BenchmarkSuite::ReferenceSemanticsEngine,
+            BenchmarkSuite::ValueSemanticsEngine,
+            BenchmarkSuite::InlineValueSemanticsEngine,
+            BenchmarkSuite::TemplateEngine,
+            BenchmarkSuite::ExternalPolymorphismEngine,
+            BenchmarkSuite::VariantSemanticsEngine,
+            BenchmarkSuite::StrategyCollectionEngine,
+            PackedValuesEngine,
+            AdaptiveEngine>(sizeClasses, options);
+    }
+
+    void WriteJson(std::ostream& stream, const CacheInfo::CacheSizes& cacheSizes,
+        const std::span<const Measurement> measurements)
+    {
+        stream << std::fixed << std::setprecision(3)
+            << "{\n"
+            << "  \"cacheSizes\": {\"l1Data\": " << cacheSizes.m_L1Data << ", \"l2\": " << cacheSizes.m_L2
+            << ", \"lastLevel\": " << cacheSizes.m_LastLevel << "},\n"
+            << "  \"results\": [";
+
+        for(size_t i{0}; i != measurements.size(); ++i)
+        {
+            const Measurement& measurement{measurements[i]};
+            stream << (i == 0 ? "\n" : ",\n")
+                << "    {\"engine\": \"" << measurement.m_Engine << "\"";
+            if(!measurement.m_Backend.empty())
+                stream << ", \"backend\": \"" << measurement.m_Backend << "\"";
+
+            stream << ", \"order\": \"" << GetName(measurement.m_Order) << "\""
+                << ", \"residency\": \"" << GetName(measurement.m_Residency) << "\""
+                << ", \"bytesPerValue\": " << measurement.m_BytesPerValue
+                << ", \"valueCount\": " << measurement.m_ValueCount
+                << ", \"passCount\": " << measurement.m_PassCount
+                << ", \"nsPerOperationMin\": " << measurement.m_MinNanoseconds
+                << ", \"nsPerOperationMedian\": " << measurement.m_MedianNanoseconds << "}";
+        }
+
+        stream << "\n  ]\n}\n";
+    }
+
+    TEST_CASE("Strategy - Dispatch Cost - Unit Tests")
+    {
+        SECTION("Size classes")
+        {
+            const std::vector<SizeClass> sizeClasses{GetSizeClasses(CacheInfo::CacheSizes{})};
+            REQUIRE(sizeClasses.size() == 4);
+            REQUIRE(sizeClasses[0].m_Bytes == 16 * 1024);
+            REQUIRE(std::ranges::is_sorted(sizeClasses, {}, &SizeClass::m_Bytes));
+            REQUIRE(GetValueCount(sizeClasses[0], 32, 1'000'000) == 512);
+            REQUIRE(GetValueCount(sizeClasses[3], 4, 1'000'000) == 1'000'000);
+            REQUIRE(GetValueCount(sizeClasses[0], 0, 1'000'000) == 16 * 1024);
+
+            const CacheInfo::CacheSizes cacheSizes{CacheInfo::GetCacheSizes()};
+            REQUIRE(cacheSizes.m_L1Data <= cacheSizes.m_L2);
+            REQUIRE(cacheSizes.m_L2 <= cacheSizes.m_LastLevel);
+        }
+
+        SECTION("Engines are sized from their own layouts")
+        {
+            using namespace BenchmarkSuite;
+            const size_t referenceBytes{GetBytesPerValue(GetLayoutPrefix<ReferenceSemanticsEngine>())};
+            const size_t templateBytes{GetBytesPerValue(GetLayoutPrefix<TemplateEngine>())};
+            const size_t collectionBytes{GetBytesPerValue(GetLayoutPrefix<StrategyCollectionEngine>())};
+            REQUIRE(templateBytes > collectionBytes);
+            REQUIRE(referenceBytes > collectionBytes);
+            REQUIRE(collectionBytes == sizeof(int32_t));
+            REQUIRE(GetBytesPerValue(GetLayoutPrefix<PackedValuesEngine>()) ==
+                Template::PackedValues::BytesPerValue);
+            REQUIRE(GetBytesPerValue(GetLayoutPrefix<AdaptiveEngine>()) == sizeof(int32_t));
+
+            // Probed with a private cache and sized from the backend it chose
+            const std::vector<ValueKind> valueKinds{CreateValueKinds(1'000, Order::Shuffled)};
+            const AdaptiveEngine::Population population{AdaptiveEngine::Create(valueKinds)};
+            REQUIRE(population.m_ProfileCache->GetProbeCount() == 1);
+            REQUIRE(GetBytesPerValue(AdaptiveEngine::GetLayoutPrefix(population)) != 0);
+            REQUIRE(AdaptiveEngine::GetBackendName(population) ==
+                Adaptive::GetName(population.m_Executor.GetBackendId()));
+            REQUIRE(GetBytesPerValue("Unknown") == 0);
+        }
+
+        SECTION("Orders contain the same values")
+        {
+            const std::vector<ValueKind> sorted{CreateValueKinds(1'000, Order::Sorted)};
+            const std::vector<ValueKind> shuffled{CreateValueKinds(1'000, Order::Shuffled)};
+            const auto countIntValues{
+                [](const std::vector<ValueKind>& valueKinds)
+                {
+                    return std::ranges::count_if(valueKinds, &ValueKind::m_IsIntValue);
+                }};
+
+            REQUIRE(countIntValues(sorted) == countIntValues(shuffled));
+            REQUIRE(std::ranges::is_partitioned(sorted, &ValueKind::m_IsIntValue));
+            REQUIRE_FALSE(std::ranges::is_partitioned(shuffled, &ValueKind::m_IsIntValue));
+        }
+
+        SECTION("Suite")
+        {
+            const SizeClass sizeClasses[]{{Residency::L1, 16 * 1024}};
+            const std::vector<Measurement> measurements{RunAllEngines(sizeClasses,
+                SuiteOptions{.m_OperationCount = 1'024, .m_RepetitionCount = 1, .m_MaxValueCount = 256})};
+            REQUIRE(measurements.size() == 9 * 2);
+            REQUIRE(std::ranges::all_of(measurements,
+                [](const Measurement& measurement)
+                {
+                    return measurement.m_BytesPerValue != 0 && measurement.m_ValueCount == 256 &&
+                        measurement.m_PassCount == 4 && measurement.m_MinNanoseconds > 0.0 &&
+                        measurement.m_MinNanoseconds <= measurement.m_MedianNanoseconds;
+                }));
+
+            std::ostringstream stream{};
+            WriteJson(stream, CacheInfo::CacheSizes{}, measurements);
+            const std::string json{stream.str()};
+            REQUIRE(json.starts_with("{\n"));
+            REQUIRE(json.find(
+                "\"engine\": \"Reference Semantics\", \"order\": \"sorted\", \"residency\": \"L1\"") !=
+                std::string::npos);
+            REQUIRE(json.find("\"engine\": \"Adaptive\", \"backend\": \"") != std::string::npos);
+            REQUIRE(std::ranges::count(json, '{') == std::ranges::count(json, '}'));
+        }
+    }
+
+    // Writes dispatch_cost.json to the working directory, populations are limited to 16M values
+    TEST_CASE("Strategy - Dispatch Cost - Benchmark", "[.][dispatch]")
+    {
+        const CacheInfo::CacheSizes cacheSizes{CacheInfo::GetCacheSizes()};
+        const std::vector<SizeClass> sizeClasses{GetSizeClasses(cacheSizes)};
+        const std::vector<Measurement> measurements{RunAllEngines(sizeClasses, SuiteOptions{})};
+
+        std::ofstream file{"dispatch_cost.json"};
+        WriteJson(file, cacheSizes, measurements);
+        WriteJson(std::cout, cacheSizes, measurements);
+        REQUIRE(file.good());
+    }
+}
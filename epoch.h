@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// Epoch based reclamation.
+// Readers enter a Guard while they use shared data, a writer that has unpublished data calls Synchronize()
+// and may reuse or free it once the call returns, because every reader that could still see it has left.
+// Entering and leaving a Guard never takes a lock, nested Guards only touch thread local state.
+namespace Epoch
+{
+    // At most this many threads can be registered at once, a thread registers on its first Guard
+    constexpr size_t MaxThreadCount{256};
+
+    namespace Detail
+    {
+        struct alignas(64) Record
+        {
+            // Epoch observed when the outermost Guard was entered, 0 while outside of every Guard
+            std::atomic<uint64_t> m_Epoch{0};
+            std::atomic<bool> m_IsClaimed{false};
+        };
+
+        struct State
+        {
+            std::atomic<uint64_t> m_GlobalEpoch{1};
+            std::array<Record, MaxThreadCount> m_Records{};
+        };
+
+        inline State& GetState()
+        {
+            static State state{};
+            return state;
+        }
+
+        class ThreadRecord
+        {
+        public:
+            ThreadRecord()
+                : m_Record{Claim()}
+            {
+            }
+
+            ThreadRecord(const ThreadRecord&) = delete;
+            ThreadRecord& operator=(const ThreadRecord&) = delete;
+
+            ~ThreadRecord()
+            {
+                m_Record.m_IsClaimed.store(false, std::memory_order_release);
+            }
+
+            Record& m_Record;
+            uint32_t m_Depth{0};
+        private:
+            static Record& Claim()
+            {
+                while(true)
+                {
+                    for(Record& record: GetState().m_Records)
+                    {
+                        bool isClaimed{false};
+                        if(record.m_IsClaimed.compare_exchange_strong(isClaimed, true, std::memory_order_acquire))
+                            return record;
+                    }
+
+                    std::this_thread::yield();
+                }
+            }
+        };
+
+        inline ThreadRecord& GetThreadRecord()
+        {
+            thread_local ThreadRecord threadRecord{};
+            return threadRecord;
+        }
+    }
+
+    class Guard
+    {
+    public:
+        Guard()
+            : m_ThreadRecord{Detail::GetThreadRecord()}
+        {
+            if(m_ThreadRecord.m_Depth++ == 0)
+            {
+                // seq_cst orders the store before any load of shared data made inside the Guard
+                m_ThreadRecord.m_Record.m_Epoch.store(Detail::GetState().m_GlobalEpoch.load());
+            }
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        ~Guard()
+        {
+            if(--m_ThreadRecord.m_Depth == 0)
+            {
+                m_ThreadRecord.m_Record.m_Epoch.store(0, std::memory_order_release);
+            }
+        }
+    private:
+        Detail::ThreadRecord& m_ThreadRecord;
+    };
+
+    // Blocks until every Guard entered before the call has been left.
+    // Must not be called from inside a Guard, the calling thread would wait for itself.
+    inline void Synchronize()
+    {
+        Detail::State& state{Detail::GetState()};
+        const uint64_t epoch{state.m_GlobalEpoch.fetch_add(1) + 1};
+
+        for(Detail::Record& record: state.m_Records)
+        {
+            while(true)
+            {
+                const uint64_t readerEpoch{record.m_Epoch.load()};
+                if(readerEpoch == 0 || readerEpoch >= epoch)
+                    break;
+
+                std::this_thread::yield();
+            }
+        }
+    }
+}
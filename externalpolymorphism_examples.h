@@ -0,0 +1,384 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random/random.h>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "population.h"
+#include "rng.h"
+#include "template_examples.h"
+#include "threadpool.h"
+
+namespace ExternalPolymorphism
+{
+    // IntValue
+    // No base class or virtual functions, the polymorphic behaviour is added externally via AnyValue.
+    template<typename TOperationStrategy>
+    class IntValue final
+    {
+    public:
+        explicit IntValue(const int32_t value)
+            : m_Value{value}
+        {
+        }
+
+        void Operation()
+        {
+            m_OperationStrategy(*this);
+        }
+
+        int32_t GetValue() const { return m_Value; }
+        void SetValue(const int32_t value) { m_Value = value; }
+    private:
+        TOperationStrategy m_OperationStrategy{};
+        int32_t m_Value{0};
+    };
+
+    class IncrementIntValueOperationStrategy
+    {
+    public:
+        void operator()(IntValue<IncrementIntValueOperationStrategy>& value)
+        {
+            value.SetValue(value.GetValue() + 1);
+        }
+    };
+
+    class DecrementIntValueOperationStrategy
+    {
+    public:
+        void operator()(IntValue<DecrementIntValueOperationStrategy>& value)
+        {
+            value.SetValue(value.GetValue() - 1);
+        }
+    };
+
+    // FloatValue
+    template<typename TOperationStrategy>
+    class FloatValue final
+    {
+    public:
+        explicit FloatValue(const float_t value)
+            : m_Value{value}
+        {
+        }
+
+        void Operation()
+        {
+            m_OperationStrategy(*this);
+        }
+
+        float_t GetValue() const { return m_Value; }
+        void SetValue(const float_t value) { m_Value = value; }
+    private:
+        TOperationStrategy m_OperationStrategy{};
+        float_t m_Value{0.0f};
+    };
+
+    class IncrementFloatValueOperationStrategy
+    {
+    public:
+        void operator()(FloatValue<IncrementFloatValueOperationStrategy>& value)
+        {
+            value.SetValue(value.GetValue() + 1.0f);
+        }
+    };
+
+    class DecrementFloatValueOperationStrategy
+    {
+    public:
+        void operator()(FloatValue<DecrementFloatValueOperationStrategy>& value)
+        {
+            value.SetValue(value.GetValue() - 1.0f);
+        }
+    };
+
+    // AnyValue
+    // Type-erased value built from a manual vtable (a table of function pointers per concrete type)
+    // and a small inline buffer, so a std::vector<AnyValue> stores every value contiguously.
+    class AnyValue
+    {
+    public:
+        static constexpr size_t BufferSize{8};
+        static constexpr size_t BufferAlignment{alignof(void*)};
+
+        template<typename TValue>
+            requires (!std::is_same_v<std::remove_cvref_t<TValue>, AnyValue>) &&
+                requires(std::remove_cvref_t<TValue>& value) { value.Operation(); }
+        AnyValue(TValue&& value)
+        {
+            using Value = std::remove_cvref_t<TValue>;
+            static_assert(sizeof(Value) <= BufferSize, "Value does not fit into the AnyValue buffer");
+            static_assert(alignof(Value) <= BufferAlignment, "Value is over aligned for the AnyValue buffer");
+            static_assert(std::is_nothrow_move_constructible_v<Value>, "Value must be nothrow move constructible");
+
+            ::new(static_cast<void*>(m_Buffer)) Value(std::forward<TValue>(value));
+            m_VTable = &s_VTable<Value>;
+        }
+
+        AnyValue(const AnyValue& other)
+            : m_VTable{other.m_VTable}
+        {
+            m_VTable->m_CopyConstruct(m_Buffer, other.m_Buffer);
+        }
+
+        AnyValue(AnyValue&& other) noexcept
+            : m_VTable{other.m_VTable}
+        {
+            m_VTable->m_MoveConstruct(m_Buffer, other.m_Buffer);
+        }
+
+        AnyValue& operator=(const AnyValue& other)
+        {
+            if(this != &other)
+            {
+                AnyValue copy{other};
+                *this = std::move(copy);
+            }
+
+            return *this;
+        }
+
+        AnyValue& operator=(AnyValue&& other) noexcept
+        {
+            if(this != &other)
+            {
+                m_VTable->m_Destroy(m_Buffer);
+                m_VTable = other.m_VTable;
+                m_VTable->m_MoveConstruct(m_Buffer, other.m_Buffer);
+            }
+
+            return *this;
+        }
+
+        ~AnyValue()
+        {
+            m_VTable->m_Destroy(m_Buffer);
+        }
+
+        void Operation()
+        {
+            m_VTable->m_Operation(m_Buffer);
+        }
+
+        template<typename TValue>
+        TValue* Get()
+        {
+            return m_VTable == &s_VTable<TValue> ? std::launder(reinterpret_cast<TValue*>(m_Buffer)) : nullptr;
+        }
+    private:
+        struct VTable
+        {
+            void(*m_Operation)(void*);
+            void(*m_CopyConstruct)(void* destination, const void* source);
+            void(*m_MoveConstruct)(void* destination, void* source) noexcept;
+            void(*m_Destroy)(void*) noexcept;
+        };
+
+        template<typename TValue>
+        static constexpr VTable s_VTable{
+            [](void* value)
+            {
+                static_cast<TValue*>(value)->Operation();
+            },
+            [](void* destination, const void* source)
+            {
+                ::new(destination) TValue(*static_cast<const TValue*>(source));
+            },
+            [](void* destination, void* source) noexcept
+            {
+                ::new(destination) TValue(std::move(*static_cast<TValue*>(source)));
+            },
+            [](void* value) noexcept
+            {
+                static_cast<TValue*>(value)->~TValue();
+            }};
+
+        const VTable* m_VTable{nullptr};
+        alignas(BufferAlignment) std::byte m_Buffer[BufferSize]{};
+    };
+
+    AnyValue CreateValue(const bool isIntValue, const bool isIncrement)
+    {
+        if(isIntValue)
+        {
+            if(isIncrement)
+                return IntValue<IncrementIntValueOperationStrategy>{0};
+
+            return IntValue<DecrementIntValueOperationStrategy>{0};
+        }
+
+        if(isIncrement)
+            return FloatValue<IncrementFloatValueOperationStrategy>{0.0f};
+
+        return FloatValue<DecrementFloatValueOperationStrategy>{0.0f};
+    }
+
+    AnyValue CreateRandomValue()
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    AnyValue CreateRandomValue(Rng::Generator& generator)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    // Values are stored inline in the vector, no arenas are needed
+    ValuePopulation<AnyValue> CreateRandomValues(
+        const size_t count, ThreadPool& threadPool = GetDefaultThreadPool(), const uint64_t seed = Rng::DefaultSeed)
+    {
+        return Population::CreateValues<AnyValue>(count, threadPool, seed, 0,
+            [](Rng::Generator& generator, std::pmr::memory_resource&)
+            {
+                return CreateRandomValue(generator);
+            });
+    }
+
+    TEST_CASE("Strategy - External Polymorphism - Unit Tests")
+    {
+        SECTION("IntValue Increment Operation")
+        {
+            AnyValue value{IntValue<IncrementIntValueOperationStrategy>{0}};
+            IntValue<IncrementIntValueOperationStrategy>* const intValue{
+                value.Get<IntValue<IncrementIntValueOperationStrategy>>()};
+            REQUIRE(intValue);
+            REQUIRE_FALSE(value.Get<IntValue<DecrementIntValueOperationStrategy>>());
+            REQUIRE(intValue->GetValue() == 0);
+
+            value.Operation();
+            REQUIRE(intValue->GetValue() == 1);
+            value.Operation();
+            REQUIRE(intValue->GetValue() == 2);
+        }
+
+        SECTION("IntValue Decrement Operation")
+        {
+            AnyValue value{IntValue<DecrementIntValueOperationStrategy>{0}};
+            IntValue<DecrementIntValueOperationStrategy>* const intValue{
+                value.Get<IntValue<DecrementIntValueOperationStrategy>>()};
+            REQUIRE(intValue);
+            REQUIRE(intValue->GetValue() == 0);
+
+            value.Operation();
+            REQUIRE(intValue->GetValue() == -1);
+            value.Operation();
+            REQUIRE(intValue->GetValue() == -2);
+        }
+
+        SECTION("FloatValue Increment Operation")
+        {
+            AnyValue value{FloatValue<IncrementFloatValueOperationStrategy>{0.0f}};
+            FloatValue<IncrementFloatValueOperationStrategy>* const floatValue{
+                value.Get<FloatValue<IncrementFloatValueOperationStrategy>>()};
+            REQUIRE(floatValue);
+            REQUIRE(floatValue->GetValue() == 0.0f);
+
+            value.Operation();
+            REQUIRE(floatValue->GetValue() == 1.0f);
+            value.Operation();
+            REQUIRE(floatValue->GetValue() == 2.0f);
+        }
+
+        SECTION("FloatValue Decrement Operation")
+        {
+            AnyValue value{FloatValue<DecrementFloatValueOperationStrategy>{0.0f}};
+            FloatValue<DecrementFloatValueOperationStrategy>* const floatValue{
+                value.Get<FloatValue<DecrementFloatValueOperationStrategy>>()};
+            REQUIRE(floatValue);
+            REQUIRE(floatValue->GetValue() == 0.0f);
+
+            value.Operation();
+            REQUIRE(floatValue->GetValue() == -1.0f);
+            value.Operation();
+            REQUIRE(floatValue->GetValue() == -2.0f);
+        }
+
+        SECTION("Copy And Move")
+        {
+            AnyValue value{IntValue<IncrementIntValueOperationStrategy>{5}};
+            AnyValue copy{value};
+            copy.Operation();
+            REQUIRE(value.Get<IntValue<IncrementIntValueOperationStrategy>>()->GetValue() == 5);
+            REQUIRE(copy.Get<IntValue<IncrementIntValueOperationStrategy>>()->GetValue() == 6);
+
+            value = std::move(copy);
+            REQUIRE(value.Get<IntValue<IncrementIntValueOperationStrategy>>()->GetValue() == 6);
+
+            value = AnyValue{FloatValue<DecrementFloatValueOperationStrategy>{1.0f}};
+            value.Operation();
+            REQUIRE_FALSE(value.Get<IntValue<IncrementIntValueOperationStrategy>>());
+            REQUIRE(value.Get<FloatValue<DecrementFloatValueOperationStrategy>>()->GetValue() == 0.0f);
+        }
+    }
+
+    TEST_CASE("Strategy - External Polymorphism - Benchmark")
+    {
+        constexpr uint32_t valueCount{50'000};
+
+        BENCHMARK("Benchmark")
+        {
+            std::vector<AnyValue> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue());
+            }
+
+            for(AnyValue& value: values)
+            {
+                value.Operation();
+            }
+        };
+
+        // Compares the cache locality of contiguous AnyValues with heap allocated Template values,
+        // construction is excluded so only the Operation() loop is measured.
+        BENCHMARK_ADVANCED("Operation - std::vector<AnyValue>")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<AnyValue> values{};
+            values.reserve(valueCount);
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue());
+            }
+
+            meter.measure(
+                [&values]()
+                {
+                    for(AnyValue& value: values)
+                    {
+                        value.Operation();
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("Operation - std::vector<std::unique_ptr<Value>>")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Template::Value>> values{};
+            values.reserve(valueCount);
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(Template::CreateRandomValue());
+            }
+
+            meter.measure(
+                [&values]()
+                {
+                    for(const std::unique_ptr<Template::Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
+        };
+    }
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+// Reorders polymorphic values so values of the same dynamic type are adjacent.
+// Executing a grouped batch keeps the indirect branch in value->Operation() on one target for a whole group,
+// which the branch predictor and instruction cache handle far better than a random interleave of types.
+namespace Grouping
+{
+    // Default grouping key, any functor returning a std::type_index (e.g. of a strategy tag) can be used
+    struct DynamicTypeKey
+    {
+        template<typename TPointer>
+        std::type_index operator()(const TPointer& value) const
+        {
+            return typeid(*value);
+        }
+    };
+
+    namespace Detail
+    {
+        // Index of type in types, appended when it is not there yet. Batches only hold a handful of types,
+        // a linear search is faster than hashing.
+        inline uint32_t GetGroupIndex(std::vector<std::type_index>& types, const std::type_index type)
+        {
+            const auto it{std::ranges::find(types, type)};
+            if(it != types.end())
+                return static_cast<uint32_t>(it - types.begin());
+
+            types.push_back(type);
+            return static_cast<uint32_t>(types.size() - 1);
+        }
+    }
+
+    // Stable counting sort by key: groups appear in order of the first value of each type, values keep
+    // their relative order within a group. O(N), the key is evaluated once per value.
+    template<typename TPointer, typename TKey = DynamicTypeKey>
+    void GroupByDynamicType(std::vector<TPointer>& values, const TKey& key = {})
+    {
+        std::vector<std::type_index> types{};
+        std::vector<uint32_t> groupIndices(values.size());
+        for(size_t i{0}; i != values.size(); ++i)
+        {
+            groupIndices[i] = Detail::GetGroupIndex(types, key(values[i]));
+        }
+
+        if(types.size() < 2)
+            return;
+
+        std::vector<size_t> offsets(types.size() + 1, 0);
+        for(const uint32_t groupIndex: groupIndices)
+        {
+            ++offsets[groupIndex + 1];
+        }
+
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        std::vector<TPointer> grouped(values.size());
+        for(size_t i{0}; i != values.size(); ++i)
+        {
+            grouped[offsets[groupIndices[i]]++] = std::move(values[i]);
+        }
+
+        values = std::move(grouped);
+    }
+
+    // Measured cost of grouping a batch against the time it saves per pass over it.
+    struct GroupingReport
+    {
+        std::chrono::nanoseconds m_GroupingTime{};
+        std::chrono::nanoseconds m_UngroupedPassTime{};
+        std::chrono::nanoseconds m_GroupedPassTime{};
+
+        // Passes after which the grouping has paid for itself, max() when grouped passes are not faster
+        size_t GetBreakEvenPassCount() const
+        {
+            const std::chrono::nanoseconds saving{m_UngroupedPassTime - m_GroupedPassTime};
+            if(saving <= std::chrono::nanoseconds::zero())
+                return std::numeric_limits<size_t>::max();
+
+            return static_cast<size_t>((m_GroupingTime + saving - std::chrono::nanoseconds{1}) / saving);
+        }
+
+        bool PaysOff(const size_t passCount) const
+        {
+            return passCount >= GetBreakEvenPassCount();
+        }
+    };
+
+    // Groups values and times it, along with passes of Operation() before and after grouping.
+    // Each side gets a warm-up pass and then reports the median of passCount timed passes, so neither is
+    // measured cold (first touch) or warm only because grouping just pulled every value into cache.
+    // All passes are applied to the values.
+    template<typename TPointer, typename TKey = DynamicTypeKey>
+    GroupingReport GroupByDynamicTypeWithReport(
+        std::vector<TPointer>& values, const TKey& key = {}, const size_t passCount = 5)
+    {
+        using Clock = std::chrono::steady_clock;
+        const auto pass{
+            [&values]()
+            {
+                const Clock::time_point begin{Clock::now()};
+                for(const TPointer& value: values)
+                {
+                    value->Operation();
+                }
+
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin);
+            }};
+
+        const auto medianPass{
+            [&pass, passCount]()
+            {
+                pass();
+                std::vector<std::chrono::nanoseconds> passTimes(std::max<size_t>(passCount, 1));
+                std::ranges::generate(passTimes, pass);
+                std::ranges::nth_element(passTimes, passTimes.begin() + passTimes.size() / 2);
+                return passTimes[passTimes.size() / 2];
+            }};
+
+        GroupingReport report{};
+        report.m_UngroupedPassTime = medianPass();
+
+        const Clock::time_point begin{Clock::now()};
+        GroupByDynamicType(values, key);
+        report.m_GroupingTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin);
+
+        report.m_GroupedPassTime = medianPass();
+        return report;
+    }
+
+    // Batch that stays grouped between passes. Only values added since the last Group() have their key
+    // evaluated, they are grouped on their own and merged behind the existing values of their group.
+    // A batch that has not changed is not touched at all.
+    template<typename TPointer, typename TKey = DynamicTypeKey>
+    class GroupedValues
+    {
+    public:
+        explicit GroupedValues(const TKey& key = {})
+            : m_Key{key}
+        {
+        }
+
+        void Reserve(const size_t count)
+        {
+            m_Values.reserve(count);
+        }
+
+        void Add(TPointer&& value)
+        {
+            m_Values.push_back(std::move(value));
+        }
+
+        void Group()
+        {
+            if(IsGrouped())
+                return;
+
+            const size_t tailSize{m_Values.size() - m_GroupedCount};
+            std::vector<uint32_t> tailGroupIndices(tailSize);
+            for(size_t i{0}; i != tailSize; ++i)
+            {
+                tailGroupIndices[i] = Detail::GetGroupIndex(m_Types, m_Key(m_Values[m_GroupedCount + i]));
+            }
+
+            m_GroupSizes.resize(m_Types.size(), 0);
+            std::vector<size_t> tailGroupSizes(m_Types.size(), 0);
+            for(const uint32_t groupIndex: tailGroupIndices)
+            {
+                ++tailGroupSizes[groupIndex];
+            }
+
+            // Every group is its grouped values followed by its new values from the tail
+            std::vector<size_t> tailOffsets(m_Types.size());
+            std::vector<TPointer> grouped(m_Values.size());
+            size_t groupedOffset{0};
+            size_t offset{0};
+            for(size_t groupIndex{0}; groupIndex != m_Types.size(); ++groupIndex)
+            {
+                std::move(m_Values.begin() + groupedOffset, m_Values.begin() + groupedOffset + m_GroupSizes[groupIndex],
+                    grouped.begin() + offset);
+                groupedOffset += m_GroupSizes[groupIndex];
+                offset += m_GroupSizes[groupIndex];
+
+                tailOffsets[groupIndex] = offset;
+                offset += tailGroupSizes[groupIndex];
+                m_GroupSizes[groupIndex] += tailGroupSizes[groupIndex];
+            }
+
+            for(size_t i{0}; i != tailSize; ++i)
+            {
+                grouped[tailOffsets[tailGroupIndices[i]]++] = std::move(m_Values[m_GroupedCount + i]);
+            }
+
+            m_Values = std::move(grouped);
+            m_GroupedCount = m_Values.size();
+        }
+
+        // Groups the values first if any were added
+        void Operation()
+        {
+            Group();
+            for(const TPointer& value: m_Values)
+            {
+                value->Operation();
+            }
+        }
+
+        bool IsGrouped() const { return m_GroupedCount == m_Values.size(); }
+        size_t GetGroupCount() const { return m_Types.size(); }
+        size_t GetSize() const { return m_Values.size(); }
+        const std::vector<TPointer>& GetValues() const { return m_Values; }
+    private:
+        TKey m_Key{};
+        std::vector<TPointer> m_Values{};
+        // Type and size of each group, in the order the groups are stored
+        std::vector<std::type_index> m_Types{};
+        std::vector<size_t> m_GroupSizes{};
+        size_t m_GroupedCount{0};
+    };
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <iostream>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+#include "grouping.h"
+#include "template_examples.h"
+
+namespace Grouping
+{
+    using Template::Value;
+    using IncrementIntValue = Template::IntValue<Template::IncrementIntValueOperationStrategy>;
+    using DecrementIntValue = Template::IntValue<Template::DecrementIntValueOperationStrategy>;
+    using IncrementFloatValue = Template::FloatValue<Template::IncrementFloatValueOperationStrategy>;
+
+    std::vector<std::unique_ptr<Value>> CreateRandomValues(const size_t valueCount)
+    {
+        std::vector<std::unique_ptr<Value>> values{};
+        values.reserve(valueCount);
+
+        for(size_t i{0}; i != valueCount; ++i)
+        {
+            values.push_back(Template::CreateRandomValue());
+        }
+
+        return values;
+    }
+
+    // Number of runs of adjacent values of the same type, equal to the type count once grouped
+    size_t GetRunCount(const std::vector<std::unique_ptr<Value>>& values)
+    {
+        size_t runCount{0};
+        for(size_t i{0}; i != values.size(); ++i)
+        {
+            if(i == 0 || std::type_index{typeid(*values[i])} != std::type_index{typeid(*values[i - 1])})
+                ++runCount;
+        }
+
+        return runCount;
+    }
+
+    TEST_CASE("Strategy - Grouping - Unit Tests")
+    {
+        SECTION("GroupByDynamicType")
+        {
+            std::vector<std::unique_ptr<Value>> values{};
+            values.push_back(std::make_unique<IncrementIntValue>(0));
+            values.push_back(std::make_unique<IncrementFloatValue>(1.0f));
+            values.push_back(std::make_unique<IncrementIntValue>(2));
+            values.push_back(std::make_unique<DecrementIntValue>(3));
+            values.push_back(std::make_unique<IncrementFloatValue>(4.0f));
+
+            GroupByDynamicType(values);
+            REQUIRE(GetRunCount(values) == 3);
+
+            // Stable, groups in order of first appearance
+            REQUIRE(static_cast<const IncrementIntValue&>(*values[0]).GetValue() == 0);
+            REQUIRE(static_cast<const IncrementIntValue&>(*values[1]).GetValue() == 2);
+            REQUIRE(static_cast<const IncrementFloatValue&>(*values[2]).GetValue() == 1.0f);
+            REQUIRE(static_cast<const IncrementFloatValue&>(*values[3]).GetValue() == 4.0f);
+            REQUIRE(static_cast<const DecrementIntValue&>(*values[4]).GetValue() == 3);
+
+            std::vector<std::unique_ptr<Value>> randomValues{CreateRandomValues(1'000)};
+            GroupByDynamicType(randomValues);
+            REQUIRE(randomValues.size() == 1'000);
+            REQUIRE(GetRunCount(randomValues) <= 4);
+        }
+
+        SECTION("Grouping Report")
+        {
+            GroupingReport report{
+                .m_GroupingTime = std::chrono::nanoseconds{1'000},
+                .m_UngroupedPassTime = std::chrono::nanoseconds{500},
+                .m_GroupedPassTime = std::chrono::nanoseconds{200}};
+            REQUIRE(report.GetBreakEvenPassCount() == 4);
+            REQUIRE_FALSE(report.PaysOff(3));
+            REQUIRE(report.PaysOff(4));
+
+            report.m_GroupedPassTime = report.m_UngroupedPassTime;
+            REQUIRE_FALSE(report.PaysOff(1'000'000));
+
+            std::vector<std::unique_ptr<Value>> values{CreateRandomValues(1'000)};
+            GroupByDynamicTypeWithReport(values);
+            REQUIRE(GetRunCount(values) <= 4);
+
+            // A warm-up and three timed passes on each side of the grouping
+            std::vector<std::unique_ptr<Value>> incrementValues{};
+            incrementValues.push_back(std::make_unique<IncrementIntValue>(0));
+            GroupByDynamicTypeWithReport(incrementValues, DynamicTypeKey{}, 3);
+            REQUIRE(static_cast<const IncrementIntValue&>(*incrementValues[0]).GetValue() == 8);
+        }
+
+        SECTION("GroupedValues")
+        {
+            GroupedValues<std::unique_ptr<Value>> groupedValues{};
+            groupedValues.Add(std::make_unique<IncrementIntValue>(0));
+            groupedValues.Add(std::make_unique<IncrementFloatValue>(1.0f));
+            groupedValues.Add(std::make_unique<IncrementIntValue>(2));
+            REQUIRE_FALSE(groupedValues.IsGrouped());
+
+            groupedValues.Operation();
+            REQUIRE(groupedValues.IsGrouped());
+            REQUIRE(groupedValues.GetGroupCount() == 2);
+            REQUIRE(GetRunCount(groupedValues.GetValues()) == 2);
+
+            // Appended values are merged behind their group
+            groupedValues.Add(std::make_unique<DecrementIntValue>(3));
+            groupedValues.Add(std::make_unique<IncrementFloatValue>(4.0f));
+            groupedValues.Add(std::make_unique<IncrementIntValue>(5));
+            groupedValues.Group();
+
+            const std::vector<std::unique_ptr<Value>>& values{groupedValues.GetValues()};
+            REQUIRE(groupedValues.GetGroupCount() == 3);
+            REQUIRE(GetRunCount(values) == 3);
+            REQUIRE(static_cast<const IncrementIntValue&>(*values[0]).GetValue() == 1);
+            REQUIRE(static_cast<const IncrementIntValue&>(*values[1]).GetValue() == 3);
+            REQUIRE(static_cast<const IncrementIntValue&>(*values[2]).GetValue() == 5);
+            REQUIRE(static_cast<const IncrementFloatValue&>(*values[3]).GetValue() == 2.0f);
+            REQUIRE(static_cast<const IncrementFloatValue&>(*values[4]).GetValue() == 4.0f);
+            REQUIRE(static_cast<const DecrementIntValue&>(*values[5]).GetValue() == 3);
+        }
+    }
+
+    TEST_CASE("Strategy - Grouping - Benchmark")
+    {
+        static constexpr size_t valueCount{50'000};
+
+        for(const size_t passCount: {1, 10, 100})
+        {
+            const std::string suffix{" - " + std::to_string(passCount) + " Passes"};
+
+            BENCHMARK_ADVANCED("Ungrouped" + suffix)(Catch::Benchmark::Chronometer meter)
+            {
+                const std::vector<std::unique_ptr<Value>> values{CreateRandomValues(valueCount)};
+                meter.measure(
+                    [&values, passCount]()
+                    {
+                        for(size_t pass{0}; pass != passCount; ++pass)
+                        {
+                            for(const std::unique_ptr<Value>& value: values)
+                            {
+                                value->Operation();
+                            }
+                        }
+                    });
+            };
+
+            // Every run groups a freshly shuffled batch, the grouping cost is part of the measurement
+            BENCHMARK_ADVANCED("GroupByDynamicType" + suffix)(Catch::Benchmark::Chronometer meter)
+            {
+                std::vector<std::vector<std::unique_ptr<Value>>> batches(meter.runs());
+                for(std::vector<std::unique_ptr<Value>>& values: batches)
+                {
+                    values = CreateRandomValues(valueCount);
+                }
+
+                meter.measure(
+                    [&batches, passCount](const int run)
+                    {
+                        std::vector<std::unique_ptr<Value>>& values{batches[run]};
+                        GroupByDynamicType(values);
+                        for(size_t pass{0}; pass != passCount; ++pass)
+                        {
+                            for(const std::unique_ptr<Value>& value: values)
+                            {
+                                value->Operation();
+                            }
+                        }
+                    });
+            };
+        }
+
+        // Stable batch with 1% new values per pass, only the new values are grouped
+        BENCHMARK_ADVANCED("GroupedValues - 1% Appended Per Pass")(Catch::Benchmark::Chronometer meter)
+        {
+            GroupedValues<std::unique_ptr<Value>> groupedValues{};
+            for(std::unique_ptr<Value>& value: CreateRandomValues(valueCount))
+            {
+                groupedValues.Add(std::move(value));
+            }
+
+            groupedValues.Group();
+            meter.measure(
+                [&groupedValues]()
+                {
+                    for(uint32_t i{0}; i != valueCount / 100; ++i)
+                    {
+                        groupedValues.Add(Template::CreateRandomValue());
+                    }
+
+                    groupedValues.Operation();
+                });
+        };
+
+        BENCHMARK_ADVANCED("GroupByDynamicType - 1% Appended Per Pass")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Value>> values{CreateRandomValues(valueCount)};
+            GroupByDynamicType(values);
+            meter.measure(
+                [&values]()
+                {
+                    for(uint32_t i{0}; i != valueCount / 100; ++i)
+                    {
+                        values.push_back(Template::CreateRandomValue());
+                    }
+
+                    GroupByDynamicType(values);
+                    for(const std::unique_ptr<Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
+        };
+    }
+
+    // Prints the measured break-even point for a range of batch sizes, run with "[report]"
+    TEST_CASE("Strategy - Grouping - Report", "[.][report]")
+    {
+        for(const size_t valueCount: {1'000, 10'000, 100'000, 1'000'000})
+        {
+            std::vector<std::unique_ptr<Value>> values{CreateRandomValues(valueCount)};
+            const GroupingReport report{GroupByDynamicTypeWithReport(values)};
+
+            std::cout << valueCount << " values: grouping " << report.m_GroupingTime.count() << "ns, pass "
+                << report.m_UngroupedPassTime.count() << "ns ungrouped / " << report.m_GroupedPassTime.count()
+                << "ns grouped, break-even after ";
+            if(report.GetBreakEvenPassCount() == std::numeric_limits<size_t>::max())
+                std::cout << "never\n";
+            else
+                std::cout << report.GetBreakEvenPassCount() << " passes\n";
+        }
+    }
+}
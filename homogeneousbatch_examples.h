@@ -0,0 +1,125 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "template_examples.h"
+
+namespace Template
+{
+    // Stores values of a single concrete type by value.
+    // Because the type is known, ForEachOperation calls TValue::Operation() directly and the compiler can
+    // inline the Strategy into the loop, no vptr lookup or indirect call is left.
+    template<typename TValue>
+    class HomogeneousValueBatch
+    {
+    public:
+        static_assert(std::is_final_v<TValue>, "TValue must be final, a derived type could override Operation()");
+        static_assert(std::is_base_of_v<Value, TValue>);
+
+        void Reserve(const size_t count)
+        {
+            m_Values.reserve(count);
+        }
+
+        void Add(const typename TValue::ValueType value)
+        {
+            m_Values.emplace_back(value);
+        }
+
+        size_t GetSize() const { return m_Values.size(); }
+        std::span<TValue> GetValues() { return m_Values; }
+        std::span<const TValue> GetValues() const { return m_Values; }
+    private:
+        std::vector<TValue> m_Values{};
+    };
+
+    template<typename TValue>
+    void ForEachOperation(HomogeneousValueBatch<TValue>& batch)
+    {
+        for(TValue& value: batch.GetValues())
+        {
+            // Qualified call, statically bound even without the final specifier
+            value.TValue::Operation();
+        }
+    }
+
+    void ForEachOperation(const std::vector<std::unique_ptr<Value>>& values)
+    {
+        for(const std::unique_ptr<Value>& value: values)
+        {
+            value->Operation();
+        }
+    }
+
+    TEST_CASE("Strategy - Homogeneous Value Batch - Unit Tests")
+    {
+        SECTION("IntValue Increment Operation")
+        {
+            HomogeneousValueBatch<IntValue<IncrementIntValueOperationStrategy>> batch{};
+            batch.Add(0);
+            batch.Add(10);
+            REQUIRE(batch.GetSize() == 2);
+
+            ForEachOperation(batch);
+            ForEachOperation(batch);
+            REQUIRE(batch.GetValues()[0].GetValue() == 2);
+            REQUIRE(batch.GetValues()[1].GetValue() == 12);
+        }
+
+        SECTION("FloatValue Decrement Operation")
+        {
+            HomogeneousValueBatch<FloatValue<DecrementFloatValueOperationStrategy>> batch{};
+            batch.Add(0.0f);
+            batch.Add(10.0f);
+
+            ForEachOperation(batch);
+            ForEachOperation(batch);
+            REQUIRE(batch.GetValues()[0].GetValue() == -2.0f);
+            REQUIRE(batch.GetValues()[1].GetValue() == 8.0f);
+        }
+    }
+
+    TEST_CASE("Strategy - Homogeneous Value Batch - Benchmark")
+    {
+        using HomogeneousValue = IntValue<IncrementIntValueOperationStrategy>;
+        constexpr uint32_t valueCount{50'000};
+
+        BENCHMARK_ADVANCED("std::vector<std::unique_ptr<Value>>")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(std::make_unique<HomogeneousValue>(0));
+            }
+
+            meter.measure(
+                [&values]()
+                {
+                    ForEachOperation(values);
+                });
+        };
+
+        BENCHMARK_ADVANCED("HomogeneousValueBatch")(Catch::Benchmark::Chronometer meter)
+        {
+            HomogeneousValueBatch<HomogeneousValue> batch{};
+            batch.Reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                batch.Add(0);
+            }
+
+            meter.measure(
+                [&batch]()
+                {
+                    ForEachOperation(batch);
+                });
+        };
+    }
+}
@@ -0,0 +1,454 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random/random.h>
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <string_view>
+
+#include "allocationtracking.h"
+#include "arena.h"
+#include "population.h"
+#include "rng.h"
+#include "strategyfunction.h"
+#include "threadpool.h"
+#include "valuesemantics_examples.h"
+
+namespace InlineValueSemantics
+{
+    class Value
+    {
+    public:
+        virtual ~Value() = default;
+        virtual void Operation() = 0;
+    };
+
+    // IntValue
+    class IntValue final : public Value
+    {
+    public:
+        using OperationStrategy = StrategyFunction<void(IntValue&)>;
+
+        explicit IntValue(
+            const int32_t value, OperationStrategy&& operationStrategy)
+            : m_OperationStrategy{std::move(operationStrategy)}
+            , m_Value{value}
+        {
+        }
+
+        void SetOperationStrategy(OperationStrategy&& operationStrategy)
+        {
+            m_OperationStrategy = std::move(operationStrategy);
+        }
+
+        void Operation() override
+        {
+            m_OperationStrategy(*this);
+        }
+
+        int32_t GetValue() const { return m_Value; }
+        void SetValue(const int32_t value) { m_Value = value; }
+    private:
+        OperationStrategy m_OperationStrategy{};
+        int32_t m_Value{0};
+    };
+
+    class IncrementIntValueOperationStrategy
+    {
+    public:
+        void operator()(IntValue& value)
+        {
+            value.SetValue(value.GetValue() + 1);
+        }
+    };
+
+    IntValue::OperationStrategy GetDecrementIntValueOperationStrategy()
+    {
+        return
+            [](IntValue& value)
+            {
+                value.SetValue(value.GetValue() - 1);
+            };
+    }
+
+    // FloatValue
+    class FloatValue final : public Value
+    {
+    public:
+        using OperationStrategy = StrategyFunction<void(FloatValue&)>;
+
+        explicit FloatValue(
+            const float_t value, OperationStrategy&& operationStrategy)
+            : m_OperationStrategy{std::move(operationStrategy)}
+            , m_Value{value}
+        {
+        }
+
+        void SetOperationStrategy(OperationStrategy&& operationStrategy)
+        {
+            m_OperationStrategy = std::move(operationStrategy);
+        }
+
+        void Operation() override
+        {
+            m_OperationStrategy(*this);
+        }
+
+        float_t GetValue() const { return m_Value; }
+        void SetValue(const float_t value) { m_Value = value; }
+    private:
+        OperationStrategy m_OperationStrategy{};
+        float_t m_Value{0.0f};
+    };
+
+    class IncrementFloatValueOperationStrategy
+    {
+    public:
+        void operator()(FloatValue& value)
+        {
+            value.SetValue(value.GetValue() + 1.0f);
+        }
+    };
+
+    FloatValue::OperationStrategy GetDecrementFloatValueOperationStrategy()
+    {
+        return
+            [](FloatValue& value)
+            {
+                value.SetValue(value.GetValue() - 1.0f);
+            };
+    }
+
+    std::unique_ptr<Value> CreateValue(const bool isIntValue, const bool isIncrement)
+    {
+        if(isIntValue)
+        {
+            return std::make_unique<IntValue>(0,
+                isIncrement ?
+                    IncrementIntValueOperationStrategy{} : GetDecrementIntValueOperationStrategy());
+        }
+
+        return std::make_unique<FloatValue>(0.0f,
+            isIncrement ?
+                IncrementFloatValueOperationStrategy{} : GetDecrementFloatValueOperationStrategy());
+    }
+
+    std::unique_ptr<Value> CreateRandomValue()
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    std::unique_ptr<Value> CreateRandomValue(Rng::Generator& generator)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    // StrategyFunction stores the strategies inline, so the value is the only allocation
+    Arena::UniquePtr<Value> CreateValue(
+        const bool isIntValue, const bool isIncrement, std::pmr::memory_resource& memoryResource)
+    {
+        if(isIntValue)
+        {
+            return Arena::MakeUnique<IntValue>(memoryResource, 0,
+                isIncrement ?
+                    IncrementIntValueOperationStrategy{} : GetDecrementIntValueOperationStrategy());
+        }
+
+        return Arena::MakeUnique<FloatValue>(memoryResource, 0.0f,
+            isIncrement ?
+                IncrementFloatValueOperationStrategy{} : GetDecrementFloatValueOperationStrategy());
+    }
+
+    Arena::UniquePtr<Value> CreateRandomValue(Rng::Generator& generator, std::pmr::memory_resource& memoryResource)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement, memoryResource);
+    }
+
+    // Same values as count calls of CreateRandomValue(generator) for every thread count
+    ValuePopulation<Arena::UniquePtr<Value>> CreateRandomValues(
+        const size_t count, ThreadPool& threadPool = GetDefaultThreadPool(), const uint64_t seed = Rng::DefaultSeed)
+    {
+        return Population::CreateValues<Arena::UniquePtr<Value>>(count, threadPool, seed,
+            std::max(sizeof(IntValue), sizeof(FloatValue)),
+            [](Rng::Generator& generator, std::pmr::memory_resource& memoryResource)
+            {
+                return CreateRandomValue(generator, memoryResource);
+            });
+    }
+
+    // Stateful strategy used to compare with std::function.
+    // At 24 bytes it is larger than the small buffer of libstdc++/libc++ std::function (16 bytes), but
+    // still fits into MSVC's (56 bytes), so whether std::function allocates depends on the library.
+    template<typename TValue>
+    auto GetStatefulOperationStrategy(const int64_t step, const int64_t minimum, const int64_t maximum)
+    {
+        return
+            [step, minimum, maximum](TValue& value)
+            {
+                value.SetValue(static_cast<int32_t>(std::clamp(value.GetValue() + step, minimum, maximum)));
+            };
+    }
+
+    // Allocations of one SetOperationStrategy() on each of valueCount values
+    template<typename TValue, typename TGetOperationStrategy>
+    AllocationTracking::AllocationStats TrackSetOperationStrategy(
+        const uint32_t valueCount, const TGetOperationStrategy& getOperationStrategy)
+    {
+        std::vector<TValue> values{};
+        values.reserve(valueCount);
+        for(uint32_t i{0}; i != valueCount; ++i)
+        {
+            values.emplace_back(0, getOperationStrategy());
+        }
+
+        const AllocationTracking::Scope scope{};
+        for(TValue& value: values)
+        {
+            value.SetOperationStrategy(getOperationStrategy());
+        }
+
+        return scope.GetStats();
+    }
+
+    void ReportSetOperationStrategy(
+        const std::string_view name, const AllocationTracking::AllocationStats& stats, const uint32_t swapCount)
+    {
+        const double count{static_cast<double>(swapCount)};
+        std::cout << std::left << std::setw(32) << name << std::fixed << std::setprecision(2)
+            << "allocations/swap " << stats.m_AllocationCount / count
+            << ", bytes/swap " << stats.m_AllocatedBytes / count << '\n';
+    }
+
+    TEST_CASE("Strategy - Inline Value Semantics - Unit Tests")
+    {
+        SECTION("IntValue Operations")
+        {
+            IntValue intValue{0, IncrementIntValueOperationStrategy{}};
+            REQUIRE(intValue.GetValue() == 0);
+
+            Value* const value{&intValue};
+            value->Operation();
+            REQUIRE(intValue.GetValue() == 1);
+            value->Operation();
+            REQUIRE(intValue.GetValue() == 2);
+
+            intValue.SetOperationStrategy(GetDecrementIntValueOperationStrategy());
+            REQUIRE(intValue.GetValue() == 2);
+
+            value->Operation();
+            REQUIRE(intValue.GetValue() == 1);
+            value->Operation();
+            REQUIRE(intValue.GetValue() == 0);
+        }
+
+        SECTION("FloatValue Operations")
+        {
+            FloatValue floatValue{0.0f, IncrementFloatValueOperationStrategy{}};
+            REQUIRE(floatValue.GetValue() == 0.0f);
+
+            Value* const value{&floatValue};
+            value->Operation();
+            REQUIRE(floatValue.GetValue() == 1.0f);
+            value->Operation();
+            REQUIRE(floatValue.GetValue() == 2.0f);
+
+            floatValue.SetOperationStrategy(GetDecrementFloatValueOperationStrategy());
+            REQUIRE(floatValue.GetValue() == 2.0f);
+
+            value->Operation();
+            REQUIRE(floatValue.GetValue() == 1.0f);
+            value->Operation();
+            REQUIRE(floatValue.GetValue() == 0.0f);
+        }
+
+        SECTION("Stateful Operation")
+        {
+            IntValue intValue{0, GetStatefulOperationStrategy<IntValue>(5, -10, 12)};
+            intValue.Operation();
+            REQUIRE(intValue.GetValue() == 5);
+            intValue.Operation();
+            REQUIRE(intValue.GetValue() == 10);
+            intValue.Operation();
+            REQUIRE(intValue.GetValue() == 12);
+        }
+
+        SECTION("StrategyFunction Move")
+        {
+            IntValue::OperationStrategy operationStrategy{IncrementIntValueOperationStrategy{}};
+            REQUIRE(operationStrategy);
+
+            IntValue::OperationStrategy movedOperationStrategy{std::move(operationStrategy)};
+            REQUIRE_FALSE(operationStrategy);
+            REQUIRE(movedOperationStrategy);
+
+            IntValue intValue{0, std::move(movedOperationStrategy)};
+            intValue.Operation();
+            REQUIRE(intValue.GetValue() == 1);
+        }
+
+        SECTION("StrategyFunction Capacity")
+        {
+            struct LargeCallable
+            {
+                void operator()(IntValue&) {}
+                std::array<int64_t, 4> m_Buffer{};
+            };
+
+            STATIC_REQUIRE(IntValue::OperationStrategy::CanStore<IncrementIntValueOperationStrategy>);
+            STATIC_REQUIRE(IntValue::OperationStrategy::CanStore<
+                decltype(GetStatefulOperationStrategy<IntValue>(0, 0, 0))>);
+            STATIC_REQUIRE_FALSE(IntValue::OperationStrategy::CanStore<LargeCallable>);
+        }
+
+        if constexpr(AllocationTracking::IsEnabled)
+        {
+            SECTION("SetOperationStrategy does not allocate")
+            {
+                REQUIRE(TrackSetOperationStrategy<IntValue>(100,
+                    [](){ return IncrementIntValueOperationStrategy{}; }).m_AllocationCount == 0);
+                REQUIRE(TrackSetOperationStrategy<IntValue>(100,
+                    [](){ return GetStatefulOperationStrategy<IntValue>(1, -100, 100); }).m_AllocationCount == 0);
+            }
+        }
+    }
+
+    TEST_CASE("Strategy - Inline Value Semantics - Benchmark")
+    {
+        // Allocations per run, printed with STRATEGY_PATTERN_TRACK_ALLOCATIONS
+        AllocationTracking::BenchmarkReport allocations{};
+
+        BENCHMARK("Benchmark")
+        {
+            const auto run{allocations.Track("Benchmark")};
+            constexpr uint32_t valueCount{50'000};
+            std::vector<std::unique_ptr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue());
+            }
+
+            for(const std::unique_ptr<Value>& value: values)
+            {
+                value->Operation();
+            }
+        };
+    }
+
+    TEST_CASE("Strategy - Inline Value Semantics - SetOperationStrategy Benchmark")
+    {
+        constexpr uint32_t valueCount{50'000};
+
+        if constexpr(AllocationTracking::IsEnabled)
+        {
+            // Initial and new strategies are the same kind, so each swap frees what the previous one allocated
+            ReportSetOperationStrategy("std::function - Stateless",
+                TrackSetOperationStrategy<ValueSemantics::IntValue>(valueCount,
+                    [](){ return ValueSemantics::IncrementIntValueOperationStrategy{}; }), valueCount);
+            ReportSetOperationStrategy("StrategyFunction - Stateless",
+                TrackSetOperationStrategy<IntValue>(valueCount,
+                    [](){ return IncrementIntValueOperationStrategy{}; }), valueCount);
+            ReportSetOperationStrategy("std::function - Stateful",
+                TrackSetOperationStrategy<ValueSemantics::IntValue>(valueCount,
+                    [](){ return GetStatefulOperationStrategy<ValueSemantics::IntValue>(1, -100, 100); }), valueCount);
+            ReportSetOperationStrategy("StrategyFunction - Stateful",
+                TrackSetOperationStrategy<IntValue>(valueCount,
+                    [](){ return GetStatefulOperationStrategy<IntValue>(1, -100, 100); }), valueCount);
+        }
+
+        // Allocations per run, printed with STRATEGY_PATTERN_TRACK_ALLOCATIONS
+        AllocationTracking::BenchmarkReport allocations{};
+
+        BENCHMARK_ADVANCED("std::function - Stateless")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<ValueSemantics::IntValue> values{};
+            values.reserve(valueCount);
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.emplace_back(0, ValueSemantics::IncrementIntValueOperationStrategy{});
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("std::function - Stateless")};
+                    for(ValueSemantics::IntValue& value: values)
+                    {
+                        value.SetOperationStrategy(ValueSemantics::GetDecrementIntValueOperationStrategy());
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("StrategyFunction - Stateless")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<IntValue> values{};
+            values.reserve(valueCount);
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.emplace_back(0, IncrementIntValueOperationStrategy{});
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("StrategyFunction - Stateless")};
+                    for(IntValue& value: values)
+                    {
+                        value.SetOperationStrategy(GetDecrementIntValueOperationStrategy());
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("std::function - Stateful")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<ValueSemantics::IntValue> values{};
+            values.reserve(valueCount);
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.emplace_back(0, ValueSemantics::IncrementIntValueOperationStrategy{});
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("std::function - Stateful")};
+                    for(ValueSemantics::IntValue& value: values)
+                    {
+                        value.SetOperationStrategy(
+                            GetStatefulOperationStrategy<ValueSemantics::IntValue>(1, -100, 100));
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("StrategyFunction - Stateful")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<IntValue> values{};
+            values.reserve(valueCount);
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.emplace_back(0, IncrementIntValueOperationStrategy{});
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("StrategyFunction - Stateful")};
+                    for(IntValue& value: values)
+                    {
+                        value.SetOperationStrategy(GetStatefulOperationStrategy<IntValue>(1, -100, 100));
+                    }
+                });
+        };
+    }
+}
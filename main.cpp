@@ -1,8 +1,106 @@
 #include <catch2/catch_session.hpp>
+#include <new>
 
+#include "allocationtracking.h"
+#include "adaptive_examples.h"
+#include "allocationtracking_examples.h"
+#include "asyncsemantics_examples.h"
+#include "benchmarksuite_examples.h"
+#include "composition_examples.h"
+#include "concurrent_examples.h"
+#include "deferred_examples.h"
+#include "dispatchcost_examples.h"
+#include "externalpolymorphism_examples.h"
+#include "grouping_examples.h"
+#include "homogeneousbatch_examples.h"
+#include "inlinevaluesemantics_examples.h"
+#include "parallel_examples.h"
+#include "numa_examples.h"
+#include "packedvalues_examples.h"
+#include "parameterized_examples.h"
+#include "perfcounters_examples.h"
+#include "population_examples.h"
 #include "referencesemantics_examples.h"
+#include "rng_examples.h"
+#include "simd_examples.h"
+#include "snapshot_examples.h"
+#include "strategycollection_examples.h"
+#include "strategytable_examples.h"
+#include "streaming_examples.h"
+#include "telemetry_examples.h"
 #include "template_examples.h"
+#include "typelist_examples.h"
 #include "valuesemantics_examples.h"
+#include "variantsemantics_examples.h"
+#include "workstealing_examples.h"
+
+#if defined(STRATEGY_PATTERN_TRACK_ALLOCATIONS)
+void* operator new(const size_t size)
+{
+    if(void* const object{AllocationTracking::Detail::Allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__)})
+        return object;
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](const size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment)
+{
+    if(void* const object{AllocationTracking::Detail::Allocate(size, static_cast<size_t>(alignment))})
+        return object;
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* const object) noexcept
+{
+    AllocationTracking::Detail::Deallocate(object);
+}
+
+void operator delete[](void* const object) noexcept
+{
+    AllocationTracking::Detail::Deallocate(object);
+}
+
+void operator delete(void* const object, size_t) noexcept
+{
+    AllocationTracking::Detail::Deallocate(object);
+}
+
+void operator delete[](void* const object, size_t) noexcept
+{
+    AllocationTracking::Detail::Deallocate(object);
+}
+
+void operator delete(void* const object, std::align_val_t) noexcept
+{
+    AllocationTracking::Detail::Deallocate(object);
+}
+
+void operator delete[](void* const object, std::align_val_t) noexcept
+{
+    AllocationTracking::Detail::Deallocate(object);
+}
+
+void operator delete(void* const object, size_t, std::align_val_t) noexcept
+{
+    AllocationTracking::Detail::Deallocate(object);
+}
+
+void operator delete[](void* const object, size_t, std::align_val_t) noexcept
+{
+    AllocationTracking::Detail::Deallocate(object);
+}
+#endif
 
 int main(const int argc, const char* const argv[])
 {
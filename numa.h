@@ -0,0 +1,368 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "threadpool.h"
+
+#if defined(__linux__)
+    #define NUMA_LINUX
+    #include <sched.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#elif defined(_WIN32)
+    #define NUMA_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#endif
+
+// NUMA topology, thread pinning and node bound memory without depending on libnuma.
+// Linux reads the topology from sysfs and binds memory with the mbind system call, Windows uses the
+// Win32 NUMA functions. Without NUMA support everything degrades to a single node, binding is best effort:
+// memory that cannot be bound is still placed by first touch.
+namespace Numa
+{
+    enum class Placement : uint8_t
+    {
+        // Default heap, pages land on the node of the thread that touches them first
+        FirstTouch,
+        // Bound to the node of the allocating worker
+        Local,
+        // Pages spread round robin over all nodes
+        Interleaved
+    };
+
+    // Nodes are indexed densely from 0, m_NodeIds maps an index to the node number of the OS, which can have
+    // gaps or belong to memory only nodes that are left out
+    struct Topology
+    {
+        // CPUs of each node, sorted by node
+        std::vector<std::vector<size_t>> m_NodeCpus{};
+        // OS node number of each node
+        std::vector<size_t> m_NodeIds{};
+
+        size_t GetNodeCount() const { return m_NodeCpus.size(); }
+    };
+
+    namespace Detail
+    {
+        // "0-3,8,10-11"
+        inline std::vector<size_t> ParseCpuList(const std::string& cpuList)
+        {
+            std::vector<size_t> cpus{};
+            std::istringstream stream{cpuList};
+            std::string range{};
+            while(std::getline(stream, range, ','))
+            {
+                if(range.empty() || range == "\n")
+                    continue;
+
+                const size_t separator{range.find('-')};
+                const size_t first{std::stoul(range.substr(0, separator))};
+                const size_t last{separator == std::string::npos ? first : std::stoul(range.substr(separator + 1))};
+                for(size_t cpu{first}; cpu <= last; ++cpu)
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+
+            return cpus;
+        }
+
+        inline Topology GetSingleNodeTopology()
+        {
+            Topology topology{};
+            topology.m_NodeCpus.emplace_back(std::max(std::thread::hardware_concurrency(), 1u));
+            topology.m_NodeIds.push_back(0);
+            for(size_t cpu{0}; cpu != topology.m_NodeCpus[0].size(); ++cpu)
+            {
+                topology.m_NodeCpus[0][cpu] = cpu;
+            }
+
+            return topology;
+        }
+
+        // Nodes of a sysfs node directory ("node<id>/cpulist"), empty if there are none
+        inline Topology ReadTopology(const std::filesystem::path& nodeDirectory)
+        {
+            std::vector<std::pair<size_t, std::vector<size_t>>> nodes{};
+            std::error_code error{};
+            for(const std::filesystem::directory_entry& entry:
+                std::filesystem::directory_iterator{nodeDirectory, error})
+            {
+                const std::string name{entry.path().filename().string()};
+                if(!name.starts_with("node") || name.size() == 4 ||
+                    !std::all_of(name.begin() + 4, name.end(), [](const char c){ return c >= '0' && c <= '9'; }))
+                {
+                    continue;
+                }
+
+                std::ifstream file{entry.path() / "cpulist"};
+                std::string cpuList{};
+                std::getline(file, cpuList);
+                std::vector<size_t> cpus{ParseCpuList(cpuList)};
+                // Memory only nodes have no CPUs to pin workers to
+                if(!cpus.empty())
+                    nodes.emplace_back(std::stoul(name.substr(4)), std::move(cpus));
+            }
+
+            std::ranges::sort(nodes);
+            Topology topology{};
+            for(auto& [node, cpus]: nodes)
+            {
+                topology.m_NodeCpus.push_back(std::move(cpus));
+                topology.m_NodeIds.push_back(node);
+            }
+
+            return topology;
+        }
+
+#if defined(NUMA_LINUX)
+        // From <linux/mempolicy.h>
+        constexpr int MpolBind{2};
+        constexpr int MpolInterleave{3};
+
+        inline bool Bind(void* const address, const size_t size, const int mode, const std::span<const size_t> nodes)
+        {
+            constexpr size_t bitsPerWord{sizeof(unsigned long) * 8};
+            const size_t maxNode{*std::ranges::max_element(nodes) + 1};
+            std::vector<unsigned long> nodeMask((maxNode + bitsPerWord - 1) / bitsPerWord, 0);
+            for(const size_t node: nodes)
+            {
+                nodeMask[node / bitsPerWord] |= 1ul << (node % bitsPerWord);
+            }
+
+            // The kernel reads one bit less than maxnode
+            return syscall(SYS_mbind, address, size, mode, nodeMask.data(), nodeMask.size() * bitsPerWord + 1, 0) == 0;
+        }
+#endif
+    }
+
+    inline Topology GetTopology()
+    {
+#if defined(NUMA_LINUX)
+        const Topology topology{Detail::ReadTopology("/sys/devices/system/node")};
+        return topology.m_NodeCpus.empty() ? Detail::GetSingleNodeTopology() : topology;
+#elif defined(NUMA_WINDOWS)
+        ULONG highestNode{0};
+        if(!GetNumaHighestNodeNumber(&highestNode))
+            return Detail::GetSingleNodeTopology();
+
+        Topology topology{};
+        for(USHORT node{0}; node <= highestNode; ++node)
+        {
+            GROUP_AFFINITY affinity{};
+            if(!GetNumaNodeProcessorMaskEx(node, &affinity) || affinity.Mask == 0)
+                continue;
+
+            topology.m_NodeIds.push_back(node);
+            std::vector<size_t>& cpus{topology.m_NodeCpus.emplace_back()};
+            for(size_t bit{0}; bit != sizeof(KAFFINITY) * 8; ++bit)
+            {
+                if(affinity.Mask & (KAFFINITY{1} << bit))
+                    cpus.push_back(affinity.Group * sizeof(KAFFINITY) * 8 + bit);
+            }
+        }
+
+        return topology.m_NodeCpus.empty() ? Detail::GetSingleNodeTopology() : topology;
+#else
+        return Detail::GetSingleNodeTopology();
+#endif
+    }
+
+    // Restricts the calling thread to cpu, returns false if that is not supported or not allowed
+    inline bool PinCurrentThread(const size_t cpu)
+    {
+#if defined(NUMA_LINUX)
+        if(cpu >= CPU_SETSIZE)
+            return false;
+
+        cpu_set_t cpuSet{};
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#elif defined(NUMA_WINDOWS)
+        GROUP_AFFINITY affinity{};
+        affinity.Group = static_cast<WORD>(cpu / (sizeof(KAFFINITY) * 8));
+        affinity.Mask = KAFFINITY{1} << (cpu % (sizeof(KAFFINITY) * 8));
+        return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    // CPUs the calling thread may run on, empty if that is not supported
+    inline std::vector<size_t> GetCurrentThreadCpus()
+    {
+        std::vector<size_t> cpus{};
+#if defined(NUMA_LINUX)
+        cpu_set_t cpuSet{};
+        if(sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0)
+            return cpus;
+
+        for(size_t cpu{0}; cpu != CPU_SETSIZE; ++cpu)
+        {
+            if(CPU_ISSET(cpu, &cpuSet))
+                cpus.push_back(cpu);
+        }
+#elif defined(NUMA_WINDOWS)
+        GROUP_AFFINITY affinity{};
+        if(!GetThreadGroupAffinity(GetCurrentThread(), &affinity))
+            return cpus;
+
+        for(size_t bit{0}; bit != sizeof(KAFFINITY) * 8; ++bit)
+        {
+            if(affinity.Mask & (KAFFINITY{1} << bit))
+                cpus.push_back(affinity.Group * sizeof(KAFFINITY) * 8 + bit);
+        }
+#endif
+        return cpus;
+    }
+
+    // Node of workerIndex when the workers are split into one contiguous block per node, which matches the
+    // contiguous value ranges of Population::CreateValues and of ParallelApply with Scheduling::Static
+    inline size_t GetWorkerNode(const size_t workerIndex, const size_t workerCount, const size_t nodeCount)
+    {
+        return workerIndex * nodeCount / std::max<size_t>(workerCount, 1);
+    }
+
+    // Pins the worker threads of threadPool to the CPUs of their node, returns the number of workers pinned.
+    // Worker 0 is whichever thread calls Run() and keeps its affinity, it can pin itself with PinCurrentThread().
+    inline size_t PinWorkers(ThreadPool& threadPool, const Topology& topology)
+    {
+        const size_t workerCount{threadPool.GetThreadCount()};
+        const size_t nodeCount{topology.GetNodeCount()};
+        std::vector<uint8_t> isPinned(workerCount, 0);
+        threadPool.Run(
+            [&topology, &isPinned, workerCount, nodeCount](const size_t workerIndex)
+            {
+                if(workerIndex == 0)
+                    return;
+
+                const size_t node{GetWorkerNode(workerIndex, workerCount, nodeCount)};
+                const size_t firstWorker{(node * workerCount + nodeCount - 1) / nodeCount};
+                const std::vector<size_t>& cpus{topology.m_NodeCpus[node]};
+                isPinned[workerIndex] = PinCurrentThread(cpus[(workerIndex - firstWorker) % cpus.size()]);
+            });
+
+        return static_cast<size_t>(std::ranges::count(isPinned, 1));
+    }
+
+    // Page granular upstream resource placing its memory on one node or interleaved over several,
+    // meant for arenas (e.g. std::pmr::monotonic_buffer_resource) and not for small allocations
+    class NodeMemoryResource final : public std::pmr::memory_resource
+    {
+    public:
+        // node indexes topology, e.g. the result of GetWorkerNode()
+        static NodeMemoryResource CreateLocal(const Topology& topology, const size_t node)
+        {
+            return NodeMemoryResource{Placement::Local, {topology.m_NodeIds[node]}};
+        }
+
+        static NodeMemoryResource CreateInterleaved(const Topology& topology)
+        {
+            return NodeMemoryResource{Placement::Interleaved, std::vector<size_t>{topology.m_NodeIds}};
+        }
+
+        // OS node numbers the memory is bound to
+        const std::vector<size_t>& GetNodeIds() const { return m_Nodes; }
+
+        // Allocations that could not be bound, e.g. on machines or kernels without NUMA
+        size_t GetUnboundCount() const { return m_UnboundCount; }
+    private:
+        NodeMemoryResource(const Placement placement, std::vector<size_t>&& nodes)
+            : m_Placement{placement}
+            , m_Nodes{std::move(nodes)}
+        {
+        }
+
+        static size_t GetPageSize()
+        {
+#if defined(NUMA_LINUX)
+            static const size_t pageSize{static_cast<size_t>(sysconf(_SC_PAGESIZE))};
+            return pageSize;
+#else
+            return 4'096;
+#endif
+        }
+
+        static size_t GetAllocationSize(const size_t bytes)
+        {
+            return (std::max<size_t>(bytes, 1) + GetPageSize() - 1) / GetPageSize() * GetPageSize();
+        }
+
+        void* do_allocate(const size_t bytes, const size_t alignment) override
+        {
+            if(alignment > GetPageSize())
+                throw std::bad_alloc{};
+
+            const size_t size{GetAllocationSize(bytes)};
+#if defined(NUMA_LINUX)
+            void* const allocation{mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+            if(allocation == MAP_FAILED)
+                throw std::bad_alloc{};
+
+            const int mode{m_Placement == Placement::Interleaved ? Detail::MpolInterleave : Detail::MpolBind};
+            if(!Detail::Bind(allocation, size, mode, m_Nodes))
+                ++m_UnboundCount;
+
+            return allocation;
+#elif defined(NUMA_WINDOWS)
+            // Windows has no interleaved policy, interleaved memory is placed by first touch
+            void* const allocation{m_Placement == Placement::Local ?
+                VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE,
+                    static_cast<DWORD>(m_Nodes[0])) :
+                VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)};
+            if(!allocation)
+                throw std::bad_alloc{};
+
+            if(m_Placement != Placement::Local)
+                ++m_UnboundCount;
+
+            return allocation;
+#else
+            ++m_UnboundCount;
+            return ::operator new(size, std::align_val_t{GetPageSize()});
+#endif
+        }
+
+        void do_deallocate(void* const pointer, const size_t bytes, [[maybe_unused]] const size_t alignment) override
+        {
+#if defined(NUMA_LINUX)
+            munmap(pointer, GetAllocationSize(bytes));
+#elif defined(NUMA_WINDOWS)
+            (void)bytes;
+            VirtualFree(pointer, 0, MEM_RELEASE);
+#else
+            ::operator delete(pointer, GetAllocationSize(bytes), std::align_val_t{GetPageSize()});
+#endif
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        Placement m_Placement{Placement::Local};
+        std::vector<size_t> m_Nodes{};
+        size_t m_UnboundCount{0};
+    };
+}
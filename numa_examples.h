@@ -0,0 +1,247 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "numa.h"
+#include "parallel.h"
+#include "population.h"
+#include "rng.h"
+#include "template_examples.h"
+#include "threadpool.h"
+
+namespace Template
+{
+    // CreateRandomValues() with the arena of every worker placed explicitly. Workers should be pinned with
+    // Numa::PinWorkers() and the population operated on by the same pool with Parallel::Scheduling::Static,
+    // so every worker processes the values it created.
+    ValuePopulation<Arena::UniquePtr<Value>> CreateRandomValues(
+        const size_t count,
+        ThreadPool& threadPool,
+        const Numa::Placement placement,
+        const Numa::Topology& topology,
+        const uint64_t seed = Rng::DefaultSeed)
+    {
+        const size_t workerCount{threadPool.GetThreadCount()};
+        return Population::CreateValues<Arena::UniquePtr<Value>>(count, threadPool, seed,
+            std::max(sizeof(IntValue<IncrementIntValueOperationStrategy>),
+                sizeof(FloatValue<IncrementFloatValueOperationStrategy>)),
+            [](Rng::Generator& generator, std::pmr::memory_resource& memoryResource)
+            {
+                return CreateRandomValue(generator, memoryResource);
+            },
+            [placement, &topology, workerCount](
+                const size_t workerIndex) -> std::unique_ptr<std::pmr::memory_resource>
+            {
+                switch(placement)
+                {
+                case Numa::Placement::FirstTouch:
+                    return nullptr;
+                case Numa::Placement::Local:
+                    return std::make_unique<Numa::NodeMemoryResource>(Numa::NodeMemoryResource::CreateLocal(
+                        topology, Numa::GetWorkerNode(workerIndex, workerCount, topology.GetNodeCount())));
+                case Numa::Placement::Interleaved:
+                    return std::make_unique<Numa::NodeMemoryResource>(
+                        Numa::NodeMemoryResource::CreateInterleaved(topology));
+                }
+
+                return nullptr;
+            });
+    }
+}
+
+namespace Numa
+{
+    std::string GetName(const Placement placement)
+    {
+        switch(placement)
+        {
+        case Placement::FirstTouch:
+            return "First Touch";
+        case Placement::Local:
+            return "Local";
+        case Placement::Interleaved:
+            return "Interleaved";
+        }
+
+        return "Unknown";
+    }
+
+    TEST_CASE("Strategy - NUMA - Unit Tests")
+    {
+        const Topology topology{GetTopology()};
+
+        SECTION("Topology")
+        {
+            REQUIRE(topology.GetNodeCount() >= 1);
+            REQUIRE(std::ranges::none_of(topology.m_NodeCpus, [](const auto& cpus){ return cpus.empty(); }));
+            REQUIRE(topology.m_NodeIds.size() == topology.GetNodeCount());
+            REQUIRE(Detail::ParseCpuList("0-3,8,10-11\n") == std::vector<size_t>{0, 1, 2, 3, 8, 10, 11});
+        }
+
+#if defined(NUMA_LINUX)
+        SECTION("Topology with gaps in the node numbers")
+        {
+            // Memory only node0 (e.g. CXL or HBM) and CPU nodes 1 and 3
+            const std::filesystem::path nodeDirectory{
+                std::filesystem::temp_directory_path() / "strategy_pattern_numa_nodes"};
+            std::filesystem::remove_all(nodeDirectory);
+            for(const auto& [name, cpuList]: {std::pair{"node0", ""}, std::pair{"node3", "4-5"},
+                std::pair{"node1", "0-1"}, std::pair{"possible", "0-3"}})
+            {
+                std::filesystem::create_directories(nodeDirectory / name);
+                std::ofstream{nodeDirectory / name / "cpulist"} << cpuList << '\n';
+            }
+
+            const Topology gapTopology{Detail::ReadTopology(nodeDirectory)};
+            std::filesystem::remove_all(nodeDirectory);
+            REQUIRE(gapTopology.m_NodeCpus == std::vector<std::vector<size_t>>{{0, 1}, {4, 5}});
+            REQUIRE(gapTopology.m_NodeIds == std::vector<size_t>{1, 3});
+            REQUIRE(NodeMemoryResource::CreateLocal(gapTopology, 1).GetNodeIds() == std::vector<size_t>{3});
+            REQUIRE(NodeMemoryResource::CreateInterleaved(gapTopology).GetNodeIds() ==
+                std::vector<size_t>{1, 3});
+        }
+#endif
+
+        SECTION("Workers are split into one block per node")
+        {
+            std::vector<size_t> nodes{};
+            for(size_t workerIndex{0}; workerIndex != 6; ++workerIndex)
+            {
+                nodes.push_back(GetWorkerNode(workerIndex, 6, 2));
+            }
+
+            REQUIRE(nodes == std::vector<size_t>{0, 0, 0, 1, 1, 1});
+            REQUIRE(GetWorkerNode(3, 4, 1) == 0);
+        }
+
+        SECTION("Pinned workers")
+        {
+            ThreadPool threadPool{3};
+            const std::vector<size_t> callerCpus{GetCurrentThreadCpus()};
+            const size_t pinnedCount{PinWorkers(threadPool, topology)};
+            REQUIRE(pinnedCount <= 2);
+
+            std::vector<std::vector<size_t>> workerCpus(threadPool.GetThreadCount());
+            threadPool.Run(
+                [&workerCpus](const size_t workerIndex)
+                {
+                    workerCpus[workerIndex] = GetCurrentThreadCpus();
+                });
+
+            // Worker 0 is the calling thread and keeps its affinity. A pinned worker runs on one CPU of its
+            // node, a worker that could not be pinned keeps the process affinity.
+            REQUIRE(workerCpus[0] == callerCpus);
+            size_t pinnedToNodeCount{0};
+            for(size_t workerIndex{1}; workerIndex != workerCpus.size(); ++workerIndex)
+            {
+                const size_t node{GetWorkerNode(workerIndex, workerCpus.size(), topology.GetNodeCount())};
+                const std::vector<size_t>& nodeCpus{topology.m_NodeCpus[node]};
+                const std::vector<size_t>& cpus{workerCpus[workerIndex]};
+                if(cpus.size() == 1 && std::ranges::find(nodeCpus, cpus[0]) != nodeCpus.end())
+                    ++pinnedToNodeCount;
+                else
+                    REQUIRE(cpus == callerCpus);
+            }
+
+            // Without affinity support nothing can be pinned or queried
+            REQUIRE((callerCpus.empty() ? pinnedCount == 0 : pinnedToNodeCount >= pinnedCount));
+        }
+
+        SECTION("NodeMemoryResource")
+        {
+            for(NodeMemoryResource memoryResource: {NodeMemoryResource::CreateLocal(topology, 0),
+                NodeMemoryResource::CreateInterleaved(topology)})
+            {
+                std::pmr::monotonic_buffer_resource arena{1'000, &memoryResource};
+                std::pmr::vector<int32_t> values(100'000, 1, &arena);
+                REQUIRE(std::ranges::all_of(values, [](const int32_t value){ return value == 1; }));
+            }
+        }
+
+        SECTION("Placement does not change the population")
+        {
+            ThreadPool threadPool{4};
+            const ValuePopulation<Arena::UniquePtr<Template::Value>> expected{
+                Template::CreateRandomValues(1'000, threadPool)};
+            for(const Placement placement: {Placement::FirstTouch, Placement::Local, Placement::Interleaved})
+            {
+                const ValuePopulation<Arena::UniquePtr<Template::Value>> population{
+                    Template::CreateRandomValues(1'000, threadPool, placement, topology)};
+                REQUIRE(std::ranges::equal(population.m_Values, expected.m_Values,
+                    [](const auto& value, const auto& expectedValue)
+                    {
+                        return typeid(*value) == typeid(*expectedValue);
+                    }));
+                REQUIRE(population.m_UpstreamResources.size() == 4);
+                REQUIRE((population.m_UpstreamResources[0] != nullptr) ==
+                    (placement != Placement::FirstTouch));
+            }
+        }
+    }
+
+    // On a single node machine every placement is local, the results only differ on NUMA hardware
+    TEST_CASE("Strategy - NUMA - Benchmark")
+    {
+        constexpr uint32_t valueCount{1'000'000};
+        constexpr uint32_t operationCount{4};
+        const Topology topology{GetTopology()};
+        ThreadPool threadPool{};
+        PinWorkers(threadPool, topology);
+        const Parallel::ParallelPolicy policy{.m_ThreadPool = &threadPool};
+
+        // Naive: one thread creates every value, so its node holds the whole population
+        BENCHMARK_ADVANCED("Naive - " + std::to_string(topology.GetNodeCount()) + " Nodes")(
+            Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Template::Value>> values{};
+            values.reserve(valueCount);
+            Rng::Generator generator{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(Template::CreateRandomValue(generator));
+            }
+
+            meter.measure(
+                [&values, &policy]()
+                {
+                    for(uint32_t operation{0}; operation != operationCount; ++operation)
+                    {
+                        Parallel::ParallelApply(values, policy);
+                    }
+                });
+        };
+
+        for(const Placement placement: {Placement::FirstTouch, Placement::Local, Placement::Interleaved})
+        {
+            BENCHMARK_ADVANCED(
+                GetName(placement) + " - " + std::to_string(topology.GetNodeCount()) + " Nodes")(
+                Catch::Benchmark::Chronometer meter)
+            {
+                ValuePopulation<Arena::UniquePtr<Template::Value>> population{
+                    Template::CreateRandomValues(valueCount, threadPool, placement, topology)};
+
+                meter.measure(
+                    [&population, &policy]()
+                    {
+                        for(uint32_t operation{0}; operation != operationCount; ++operation)
+                        {
+                            Parallel::ParallelApply(population.m_Values, policy);
+                        }
+                    });
+            };
+        }
+    }
+}
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random/random.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "externalpolymorphism_examples.h"
+#include "inlinevaluesemantics_examples.h"
+#include "referencesemantics_examples.h"
+#include "rng.h"
+#include "strategycollection_examples.h"
+#include "template_examples.h"
+#include "typelist_examples.h"
+#include "valuesemantics_examples.h"
+#include "variantsemantics_examples.h"
+
+namespace Template
+{
+    constexpr size_t CacheLineSize{64};
+
+    // 16 payloads of 4 bytes, one cache line
+    struct alignas(CacheLineSize) PackedBlock
+    {
+        static constexpr size_t Size{CacheLineSize / sizeof(uint32_t)};
+
+        std::array<uint32_t, Size> m_Payloads{};
+    };
+
+    // Values of a fixed set of TValues (e.g. IntValue<IncrementIntValueOperationStrategy>) in insertion order
+    // at 5 bytes per value: the 4 byte payload in cache line aligned blocks and a 1 byte tag column holding the
+    // index of the value type in TValues. Unlike a StrategyCollection the order of the values is kept.
+    // Operation() applies every Strategy to a whole block and keeps the results whose tag matches, which
+    // vectorizes instead of branching on the tag of each value.
+    template<typename... TValues>
+    class PackedValueCollection
+    {
+    public:
+        using Tag = uint8_t;
+        using Types = TypeList<TValues...>;
+
+        static_assert(((sizeof(typename TValues::ValueType) == sizeof(uint32_t) &&
+            std::is_trivially_copyable_v<typename TValues::ValueType>) && ...), "Payloads are 4 byte trivial types");
+
+        static constexpr size_t BytesPerValue{sizeof(uint32_t) + sizeof(Tag)};
+        // Tag of the unused slots of the last block
+        static constexpr Tag EmptyTag{0xFF};
+
+        static_assert(sizeof...(TValues) <= EmptyTag, "Tags are a single byte");
+
+        template<typename TValue>
+        static constexpr Tag GetTag()
+        {
+            return static_cast<Tag>(IndexOf<TValue, Types>::Value);
+        }
+
+        void Reserve(const size_t count)
+        {
+            const size_t blockCount{(count + PackedBlock::Size - 1) / PackedBlock::Size};
+            m_Blocks.reserve(blockCount);
+            m_Tags.reserve(blockCount * PackedBlock::Size);
+        }
+
+        template<typename TValue>
+        void Add(const typename TValue::ValueType value)
+        {
+            if(m_Size % PackedBlock::Size == 0)
+            {
+                m_Blocks.emplace_back();
+                m_Tags.resize(m_Tags.size() + PackedBlock::Size, EmptyTag);
+            }
+
+            m_Blocks.back().m_Payloads[m_Size % PackedBlock::Size] = std::bit_cast<uint32_t>(value);
+            m_Tags[m_Size] = GetTag<TValue>();
+            ++m_Size;
+        }
+
+        void Operation()
+        {
+            for(size_t block{0}; block != m_Blocks.size(); ++block)
+            {
+                // Local copies, a Tag pointer may alias the payloads, which prevents vectorization
+                std::array<Tag, PackedBlock::Size> tags{};
+                std::copy_n(m_Tags.data() + block * PackedBlock::Size, PackedBlock::Size, tags.begin());
+                std::array<uint32_t, PackedBlock::Size> payloads{m_Blocks[block].m_Payloads};
+
+                (Operation<TValues>(payloads, tags), ...);
+                m_Blocks[block].m_Payloads = payloads;
+            }
+        }
+
+        size_t GetSize() const { return m_Size; }
+        Tag GetTag(const size_t index) const { return m_Tags[index]; }
+
+        template<typename TValueType>
+        TValueType GetValue(const size_t index) const
+        {
+            return std::bit_cast<TValueType>(
+                m_Blocks[index / PackedBlock::Size].m_Payloads[index % PackedBlock::Size]);
+        }
+
+        // Bytes of the payload blocks and the tag column
+        size_t GetMemorySize() const
+        {
+            return m_Blocks.size() * (sizeof(PackedBlock) + PackedBlock::Size * sizeof(Tag));
+        }
+
+        std::span<const PackedBlock> GetBlocks() const { return m_Blocks; }
+    private:
+        template<typename TValue>
+        static void Operation(
+            std::array<uint32_t, PackedBlock::Size>& payloads, const std::array<Tag, PackedBlock::Size>& tags)
+        {
+            using ValueType = typename TValue::ValueType;
+            typename TValue::OperationStrategy operationStrategy{};
+
+            for(size_t i{0}; i != PackedBlock::Size; ++i)
+            {
+                // Selected with a mask instead of a conditional, which compilers turn into an unpredictable
+                // branch. Other payloads are masked to 0 before the Strategy is applied, e.g. a small int read
+                // as a float is a denormal, which is orders of magnitude slower to compute on most CPUs.
+                const uint32_t mask{0u - static_cast<uint32_t>(tags[i] == GetTag<TValue>())};
+                ValueType value{std::bit_cast<ValueType>(payloads[i] & mask)};
+                operationStrategy(value);
+                payloads[i] = (std::bit_cast<uint32_t>(value) & mask) | (payloads[i] & ~mask);
+            }
+        }
+
+        std::vector<PackedBlock> m_Blocks{};
+        // One tag per slot of every block
+        std::vector<Tag> m_Tags{};
+        size_t m_Size{0};
+    };
+
+    using PackedValues = PackedValueCollection<
+        IntValue<IncrementIntValueOperationStrategy>,
+        IntValue<DecrementIntValueOperationStrategy>,
+        FloatValue<IncrementFloatValueOperationStrategy>,
+        FloatValue<DecrementFloatValueOperationStrategy>>;
+
+    void AddValue(PackedValues& values, const bool isIntValue, const bool isIncrement)
+    {
+        if(isIntValue)
+        {
+            if(isIncrement)
+                return values.Add<IntValue<IncrementIntValueOperationStrategy>>(0);
+
+            return values.Add<IntValue<DecrementIntValueOperationStrategy>>(0);
+        }
+
+        if(isIncrement)
+            return values.Add<FloatValue<IncrementFloatValueOperationStrategy>>(0.0f);
+
+        return values.Add<FloatValue<DecrementFloatValueOperationStrategy>>(0.0f);
+    }
+
+    void AddRandomValue(PackedValues& values)
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        AddValue(values, isIntValue, isIncrement);
+    }
+
+    void AddRandomValue(PackedValues& values, Rng::Generator& generator)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        AddValue(values, isIntValue, isIncrement);
+    }
+
+    // Layout
+    // The exact sizes depend on the standard library (e.g. std::function is 32 bytes in libstdc++ and 64 bytes
+    // in MSVC), so only relations that hold on every 64-bit target are asserted.
+    static_assert(sizeof(PackedBlock) == CacheLineSize && alignof(PackedBlock) == CacheLineSize);
+    // vptr, strategy pointer and payload, plus the heap allocated strategy
+    static_assert(sizeof(ReferenceSemantics::IntValue) >= 2 * sizeof(void*) + sizeof(int32_t));
+    static_assert(sizeof(ValueSemantics::IntValue) > sizeof(ReferenceSemantics::IntValue));
+    static_assert(sizeof(Template::IntValue<IncrementIntValueOperationStrategy>) >= sizeof(void*) + sizeof(int32_t));
+    static_assert(sizeof(ExternalPolymorphism::AnyValue) == sizeof(void*) + ExternalPolymorphism::AnyValue::BufferSize);
+    static_assert(sizeof(VariantSemantics::Value) > sizeof(int32_t));
+    // At least 6 times denser than a std::vector<std::unique_ptr<ReferenceSemantics::Value>>
+    static_assert(6 * PackedValues::BytesPerValue <= sizeof(void*) + sizeof(ReferenceSemantics::IntValue) +
+        sizeof(ReferenceSemantics::IncrementIntValueOperationStrategy));
+
+    struct LayoutInfo
+    {
+        const char* m_Name{nullptr};
+        size_t m_Size{0};
+        size_t m_Alignment{0};
+        // Bytes per value of a container of these values, including pointers and heap allocated strategies
+        // (std::function may allocate its callable on top of that)
+        size_t m_BytesPerValue{0};
+    };
+
+    template<typename TValue>
+    LayoutInfo GetLayoutInfo(const char* const name, const size_t extraBytesPerValue = 0)
+    {
+        return LayoutInfo{
+            .m_Name = name,
+            .m_Size = sizeof(TValue),
+            .m_Alignment = alignof(TValue),
+            .m_BytesPerValue = sizeof(TValue) + extraBytesPerValue};
+    }
+
+    std::vector<LayoutInfo> GetLayoutInfos()
+    {
+        constexpr size_t pointerSize{sizeof(std::unique_ptr<Value>)};
+        return {
+            GetLayoutInfo<ReferenceSemantics::IntValue>("ReferenceSemantics::IntValue",
+                pointerSize + sizeof(ReferenceSemantics::IncrementIntValueOperationStrategy)),
+            GetLayoutInfo<ReferenceSemantics::FloatValue>("ReferenceSemantics::FloatValue",
+                pointerSize + sizeof(ReferenceSemantics::IncrementFloatValueOperationStrategy)),
+            GetLayoutInfo<ValueSemantics::IntValue>("ValueSemantics::IntValue", pointerSize),
+            GetLayoutInfo<ValueSemantics::FloatValue>("ValueSemantics::FloatValue", pointerSize),
+            GetLayoutInfo<InlineValueSemantics::IntValue>("InlineValueSemantics::IntValue", pointerSize),
+            GetLayoutInfo<InlineValueSemantics::FloatValue>("InlineValueSemantics::FloatValue", pointerSize),
+            GetLayoutInfo<IntValue<IncrementIntValueOperationStrategy>>("Template::IntValue", pointerSize),
+            GetLayoutInfo<FloatValue<IncrementFloatValueOperationStrategy>>("Template::FloatValue", pointerSize),
+            GetLayoutInfo<ExternalPolymorphism::AnyValue>("ExternalPolymorphism::AnyValue"),
+            GetLayoutInfo<VariantSemantics::Value>("VariantSemantics::Value"),
+            GetLayoutInfo<int32_t>("StrategyPartition payload"),
+            GetLayoutInfo<PackedBlock>("PackedBlock"),
+            LayoutInfo{
+                .m_Name = "PackedValues (payload + tag)",
+                .m_Size = PackedValues::BytesPerValue,
+                .m_Alignment = alignof(PackedBlock),
+                .m_BytesPerValue = PackedValues::BytesPerValue}};
+    }
+
+    TEST_CASE("Strategy - Packed Values - Unit Tests")
+    {
+        SECTION("Operations")
+        {
+            PackedValues values{};
+            for(uint32_t i{0}; i != 40; ++i)
+            {
+                AddValue(values, i % 2 == 0, i % 4 < 2);
+            }
+
+            REQUIRE(values.GetSize() == 40);
+            REQUIRE(values.GetBlocks().size() == 3);
+            REQUIRE(values.GetMemorySize() == 3 * (sizeof(PackedBlock) + PackedBlock::Size));
+
+            values.Operation();
+            values.Operation();
+
+            for(size_t i{0}; i != values.GetSize(); ++i)
+            {
+                const bool isIntValue{i % 2 == 0};
+                const float_t expected{i % 4 < 2 ? 2.0f : -2.0f};
+                if(isIntValue)
+                {
+                    REQUIRE(values.GetValue<int32_t>(i) == static_cast<int32_t>(expected));
+                }
+                else
+                {
+                    REQUIRE(values.GetValue<float_t>(i) == expected);
+                }
+            }
+        }
+
+        SECTION("Insertion Order")
+        {
+            PackedValues values{};
+            values.Add<FloatValue<DecrementFloatValueOperationStrategy>>(1.5f);
+            values.Add<IntValue<IncrementIntValueOperationStrategy>>(7);
+
+            REQUIRE(values.GetTag(0) == PackedValues::GetTag<FloatValue<DecrementFloatValueOperationStrategy>>());
+            REQUIRE(values.GetTag(1) == PackedValues::GetTag<IntValue<IncrementIntValueOperationStrategy>>());
+
+            values.Operation();
+            REQUIRE(values.GetValue<float_t>(0) == 0.5f);
+            REQUIRE(values.GetValue<int32_t>(1) == 8);
+        }
+
+        SECTION("Alignment")
+        {
+            PackedValues values{};
+            for(uint32_t i{0}; i != 100; ++i)
+            {
+                AddRandomValue(values);
+            }
+
+            for(const PackedBlock& block: values.GetBlocks())
+            {
+                REQUIRE(reinterpret_cast<uintptr_t>(&block) % CacheLineSize == 0);
+            }
+        }
+
+        SECTION("Layout")
+        {
+            const std::vector<LayoutInfo> layoutInfos{GetLayoutInfos()};
+            REQUIRE(layoutInfos.size() == 13);
+            // ReferenceSemantics::IntValue
+            REQUIRE(layoutInfos.front().m_BytesPerValue >= 6 * PackedValues::BytesPerValue);
+        }
+    }
+
+    TEST_CASE("Strategy - Packed Values - Benchmark")
+    {
+        constexpr uint32_t valueCount{1'000'000};
+        Rng::Generator generator{};
+
+        std::vector<std::unique_ptr<ReferenceSemantics::Value>> referenceValues{};
+        std::vector<std::unique_ptr<Value>> templateValues{};
+        ValueCollection collection{};
+        PackedValues packedValues{};
+        referenceValues.reserve(valueCount);
+        templateValues.reserve(valueCount);
+        packedValues.Reserve(valueCount);
+
+        for(uint32_t i{0}; i != valueCount; ++i)
+        {
+            const bool isIntValue{generator.NextBool()};
+            const bool isIncrement{generator.NextBool()};
+            referenceValues.push_back(ReferenceSemantics::CreateValue(isIntValue, isIncrement));
+            templateValues.push_back(CreateValue(isIntValue, isIncrement));
+            AddValue(collection, isIntValue, isIncrement);
+            AddValue(packedValues, isIntValue, isIncrement);
+        }
+
+        BENCHMARK("ReferenceSemantics std::unique_ptr")
+        {
+            for(const std::unique_ptr<ReferenceSemantics::Value>& value: referenceValues)
+            {
+                value->Operation();
+            }
+        };
+
+        BENCHMARK("Template std::unique_ptr")
+        {
+            for(const std::unique_ptr<Value>& value: templateValues)
+            {
+                value->Operation();
+            }
+        };
+
+        BENCHMARK("StrategyCollection (unordered)")
+        {
+            collection.Operation();
+        };
+
+        BENCHMARK("PackedValues")
+        {
+            packedValues.Operation();
+        };
+    }
+
+    // Prints sizeof/alignof and bytes per value of every value type, run with "[layout]"
+    TEST_CASE("Strategy - Packed Values - Layout Report", "[.][layout]")
+    {
+        std::cout << std::left << std::setw(36) << "Type" << std::right << std::setw(8) << "sizeof"
+            << std::setw(9) << "alignof" << std::setw(16) << "bytes/value" << '\n';
+
+        for(const LayoutInfo& layoutInfo: GetLayoutInfos())
+        {
+            std::cout << std::left << std::setw(36) << layoutInfo.m_Name << std::right
+                << std::setw(8) << layoutInfo.m_Size << std::setw(9) << layoutInfo.m_Alignment
+                << std::setw(16) << layoutInfo.m_BytesPerValue << '\n';
+        }
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <ranges>
+#include <span>
+
+#include "threadpool.h"
+
+namespace Parallel
+{
+    constexpr size_t CacheLineSize{64};
+
+    enum class Scheduling : uint8_t
+    {
+        // One contiguous chunk per worker, best when every value costs the same
+        Static,
+        // Many small chunks balanced between workers via work stealing, best for values of uneven cost
+        WorkStealing
+    };
+
+    struct ParallelPolicy
+    {
+        // nullptr uses GetDefaultThreadPool()
+        ThreadPool* m_ThreadPool{nullptr};
+        // Ranges smaller than this run serially on the calling thread
+        size_t m_SerialThreshold{16'384};
+        Scheduling m_Scheduling{Scheduling::Static};
+        // Values per task for Scheduling::WorkStealing, rounded up to a whole number of cache lines
+        size_t m_WorkStealingChunkSize{1'024};
+    };
+
+    template<typename TValue>
+    void InvokeOperation(TValue& value)
+    {
+        if constexpr(requires { value->Operation(); })
+        {
+            value->Operation();
+        }
+        else
+        {
+            value.Operation();
+        }
+    }
+
+    // Elements of a range that start a cache line, every m_Period elements from m_First.
+    struct CacheLineBoundaries
+    {
+        size_t m_First{0};
+        // lcm(sizeof(TValue), CacheLineSize) / sizeof(TValue), a whole number of cache lines
+        size_t m_Period{1};
+        // False when no element starts a cache line, only possible for a buffer less aligned than the element
+        // size allows, e.g. 32 byte values in a buffer that is only 16 byte aligned.
+        bool m_IsAligned{false};
+    };
+
+    template<typename TValue>
+    CacheLineBoundaries GetCacheLineBoundaries(const std::span<TValue> values)
+    {
+        constexpr size_t period{std::lcm(sizeof(TValue), CacheLineSize) / sizeof(TValue)};
+        const uintptr_t address{reinterpret_cast<uintptr_t>(values.data())};
+        for(size_t first{0}; first != period; ++first)
+        {
+            if((address + first * sizeof(TValue)) % CacheLineSize == 0)
+                return CacheLineBoundaries{.m_First = first, .m_Period = period, .m_IsAligned = true};
+        }
+
+        return CacheLineBoundaries{.m_First = 0, .m_Period = period, .m_IsAligned = false};
+    }
+
+    // Index of the first element of the chunk used by workerIndex.
+    // Chunk boundaries are placed on elements that start a cache line, so two workers never write to the same
+    // cache line of the range. For element sizes that do not divide the cache line size that is every
+    // lcm(sizeof(TValue), CacheLineSize) bytes. Without any such element (see CacheLineBoundaries) the
+    // boundaries are not aligned. Pointees of pointer-like elements live outside of the range and are not
+    // covered by this.
+    template<typename TValue>
+    size_t GetChunkBegin(const std::span<TValue> values, const size_t workerIndex, const size_t workerCount)
+    {
+        if(workerIndex == 0)
+            return 0;
+
+        if(workerIndex == workerCount)
+            return values.size();
+
+        const size_t ideal{values.size() * workerIndex / workerCount};
+        const CacheLineBoundaries boundaries{GetCacheLineBoundaries(values)};
+        if(!boundaries.m_IsAligned)
+            return ideal;
+
+        if(ideal <= boundaries.m_First)
+            return std::min(boundaries.m_First, values.size());
+
+        const size_t aligned{boundaries.m_First +
+            (ideal - boundaries.m_First) / boundaries.m_Period * boundaries.m_Period};
+        return std::min(aligned, values.size());
+    }
+
+    // Calls Operation() on every value, split between the workers of the thread pool by policy.m_Scheduling.
+    template<std::ranges::contiguous_range TValues>
+    void ParallelApply(TValues& values, const ParallelPolicy& policy = {})
+    {
+        using Value = std::ranges::range_value_t<TValues>;
+        const std::span<Value> span{std::ranges::data(values), std::ranges::size(values)};
+
+        ThreadPool& threadPool{policy.m_ThreadPool ? *policy.m_ThreadPool : GetDefaultThreadPool()};
+        if(span.size() < policy.m_SerialThreshold || threadPool.GetThreadCount() == 1)
+        {
+            for(Value& value: span)
+            {
+                InvokeOperation(value);
+            }
+
+            return;
+        }
+
+        if(policy.m_Scheduling == Scheduling::WorkStealing)
+        {
+            // Chunk i > 0 starts at m_First + i * chunkSize, on an element that starts a cache line like the
+            // boundaries of GetChunkBegin, and chunk 0 also takes the values before m_First.
+            const CacheLineBoundaries boundaries{GetCacheLineBoundaries(span)};
+            const size_t chunkSize{
+                (std::max<size_t>(policy.m_WorkStealingChunkSize, 1) + boundaries.m_Period - 1) /
+                    boundaries.m_Period * boundaries.m_Period};
+            const size_t first{std::min(boundaries.m_First, span.size())};
+            const size_t chunkCount{std::max<size_t>((span.size() - first + chunkSize - 1) / chunkSize, 1)};
+
+            threadPool.RunWorkStealing(chunkCount,
+                [span, chunkSize, first](const size_t chunkIndex)
+                {
+                    const size_t begin{chunkIndex == 0 ? 0 : first + chunkIndex * chunkSize};
+                    const size_t end{std::min(first + (chunkIndex + 1) * chunkSize, span.size())};
+                    for(Value& value: span.subspan(begin, end - begin))
+                    {
+                        InvokeOperation(value);
+                    }
+                });
+
+            return;
+        }
+
+        const size_t workerCount{threadPool.GetThreadCount()};
+        threadPool.Run(
+            [span, workerCount](const size_t workerIndex)
+            {
+                const size_t begin{GetChunkBegin(span, workerIndex, workerCount)};
+                const size_t end{GetChunkBegin(span, workerIndex + 1, workerCount)};
+                for(Value& value: span.subspan(begin, end - begin))
+                {
+                    InvokeOperation(value);
+                }
+            });
+    }
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "parallel.h"
+#include "template_examples.h"
+#include "threadpool.h"
+
+namespace Parallel
+{
+    TEST_CASE("Strategy - Parallel - Unit Tests")
+    {
+        using IntValue = Template::IntValue<Template::IncrementIntValueOperationStrategy>;
+
+        SECTION("ThreadPool Run")
+        {
+            ThreadPool threadPool{4};
+            REQUIRE(threadPool.GetThreadCount() == 4);
+
+            std::vector<std::atomic<uint32_t>> calls(threadPool.GetThreadCount());
+            for(uint32_t i{0}; i != 3; ++i)
+            {
+                threadPool.Run(
+                    [&calls](const size_t workerIndex)
+                    {
+                        ++calls[workerIndex];
+                    });
+            }
+
+            REQUIRE(std::ranges::all_of(calls, [](const std::atomic<uint32_t>& count){ return count == 3; }));
+        }
+
+        SECTION("ThreadPool Current Worker Index")
+        {
+            ThreadPool threadPool{4};
+            REQUIRE_FALSE(ThreadPool::GetCurrentWorkerIndex().has_value());
+
+            std::vector<std::atomic<uint32_t>> mismatches(threadPool.GetThreadCount());
+            threadPool.Run(
+                [&mismatches](const size_t workerIndex)
+                {
+                    if(ThreadPool::GetCurrentWorkerIndex() != workerIndex)
+                        ++mismatches[workerIndex];
+                });
+
+            REQUIRE(std::ranges::all_of(mismatches, [](const std::atomic<uint32_t>& count){ return count == 0; }));
+            REQUIRE_FALSE(ThreadPool::GetCurrentWorkerIndex().has_value());
+        }
+
+        SECTION("ThreadPool Run from several threads")
+        {
+            ThreadPool threadPool{4};
+            std::vector<std::atomic<uint32_t>> calls(threadPool.GetThreadCount());
+            std::vector<std::thread> callers{};
+            for(uint32_t caller{0}; caller != 4; ++caller)
+            {
+                callers.emplace_back(
+                    [&threadPool, &calls]()
+                    {
+                        for(uint32_t i{0}; i != 100; ++i)
+                        {
+                            threadPool.Run(
+                                [&calls](const size_t workerIndex)
+                                {
+                                    ++calls[workerIndex];
+                                });
+                        }
+                    });
+            }
+
+            for(std::thread& caller: callers)
+            {
+                caller.join();
+            }
+
+            REQUIRE(std::ranges::all_of(calls, [](const std::atomic<uint32_t>& count){ return count == 400; }));
+        }
+
+        SECTION("Nested ParallelApply")
+        {
+            ThreadPool threadPool{3};
+            std::vector<std::vector<IntValue>> values(3, std::vector<IntValue>(1'000, IntValue{0}));
+            threadPool.Run(
+                [&threadPool, &values](const size_t workerIndex)
+                {
+                    ParallelApply(values[workerIndex], {.m_ThreadPool = &threadPool, .m_SerialThreshold = 16});
+                });
+
+            REQUIRE(std::ranges::all_of(values,
+                [](const std::vector<IntValue>& workerValues)
+                {
+                    return std::ranges::all_of(workerValues,
+                        [](const IntValue& value){ return value.GetValue() == 1; });
+                }));
+        }
+
+        SECTION("Chunk Boundaries")
+        {
+            std::vector<int32_t> values(1'000);
+            const std::span<int32_t> span{values};
+            constexpr size_t workerCount{7};
+
+            size_t previous{0};
+            for(size_t workerIndex{1}; workerIndex != workerCount; ++workerIndex)
+            {
+                const size_t begin{GetChunkBegin(span, workerIndex, workerCount)};
+                REQUIRE(begin >= previous);
+                REQUIRE(reinterpret_cast<uintptr_t>(span.data() + begin) % CacheLineSize == 0);
+                previous = begin;
+            }
+
+            REQUIRE(GetChunkBegin(span, workerCount, workerCount) == span.size());
+        }
+
+        SECTION("Chunk Boundaries for element sizes that do not divide a cache line")
+        {
+            struct Value12
+            {
+                std::array<int32_t, 3> m_Values{};
+            };
+
+            struct Value24
+            {
+                std::array<int64_t, 3> m_Values{};
+            };
+
+            const auto requireAlignedChunks{
+                [](const auto span)
+                {
+                    constexpr size_t workerCount{7};
+                    size_t previous{0};
+                    for(size_t workerIndex{1}; workerIndex != workerCount; ++workerIndex)
+                    {
+                        const size_t begin{GetChunkBegin(span, workerIndex, workerCount)};
+                        REQUIRE(begin >= previous);
+                        REQUIRE(reinterpret_cast<uintptr_t>(span.data() + begin) % CacheLineSize == 0);
+                        previous = begin;
+                    }
+                }};
+
+            std::vector<Value12> values12(1'000);
+            std::vector<Value24> values24(1'000);
+            // Every start offset within a cache line the element alignment allows
+            for(size_t offset{0}; offset != 16; ++offset)
+            {
+                requireAlignedChunks(std::span<Value12>{values12}.subspan(offset));
+                requireAlignedChunks(std::span<Value24>{values24}.subspan(offset));
+            }
+        }
+
+        SECTION("ParallelApply Values")
+        {
+            ThreadPool threadPool{3};
+            for(const size_t valueCount: {0, 1, 15, 1'000, 100'003})
+            {
+                std::vector<IntValue> values(valueCount, IntValue{0});
+                ParallelApply(values, {.m_ThreadPool = &threadPool, .m_SerialThreshold = 16});
+                ParallelApply(values, {.m_ThreadPool = &threadPool, .m_SerialThreshold = 16});
+
+                REQUIRE(std::ranges::all_of(values, [](const IntValue& value){ return value.GetValue() == 2; }));
+            }
+        }
+
+        SECTION("ParallelApply Pointers")
+        {
+            ThreadPool threadPool{4};
+            std::vector<std::unique_ptr<Template::Value>> values{};
+            for(uint32_t i{0}; i != 50'000; ++i)
+            {
+                values.push_back(std::make_unique<IntValue>(static_cast<int32_t>(i)));
+            }
+
+            ParallelApply(values, {.m_ThreadPool = &threadPool});
+
+            bool isEveryValueIncremented{true};
+            for(uint32_t i{0}; i != values.size(); ++i)
+            {
+                isEveryValueIncremented &=
+                    static_cast<const IntValue&>(*values[i]).GetValue() == static_cast<int32_t>(i + 1);
+            }
+
+            REQUIRE(isEveryValueIncremented);
+        }
+
+        SECTION("ParallelApply Serial Fallback")
+        {
+            ThreadPool threadPool{4};
+            std::vector<IntValue> values(100, IntValue{0});
+            ParallelApply(values, {.m_ThreadPool = &threadPool, .m_SerialThreshold = 1'000});
+
+            REQUIRE(std::ranges::all_of(values, [](const IntValue& value){ return value.GetValue() == 1; }));
+        }
+    }
+
+    TEST_CASE("Strategy - Parallel - Benchmark")
+    {
+        constexpr uint32_t valueCount{1'000'000};
+        std::vector<std::unique_ptr<Template::Value>> values{};
+        values.reserve(valueCount);
+
+        for(uint32_t i{0}; i != valueCount; ++i)
+        {
+            values.push_back(Template::CreateRandomValue());
+        }
+
+        BENCHMARK("Serial")
+        {
+            for(const std::unique_ptr<Template::Value>& value: values)
+            {
+                value->Operation();
+            }
+        };
+
+        for(const size_t threadCount: {1, 2, 4, 8, 16, 32})
+        {
+            ThreadPool threadPool{threadCount};
+            BENCHMARK("ParallelApply - " + std::to_string(threadCount) + " Threads")
+            {
+                ParallelApply(values, {.m_ThreadPool = &threadPool});
+            };
+        }
+    }
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "allocationtracking.h"
+#include "referencesemantics_examples.h"
+#include "rng.h"
+#include "strategycollection_examples.h"
+#include "template_examples.h"
+
+namespace Template
+{
+    // Adds N instead of 1. As a member of IntValue every value owns its N, in a StrategyPartition the strategy
+    // is stateless and N is read from the parameter column.
+    class AddNIntValueOperationStrategy
+    {
+    public:
+        struct Parameters
+        {
+            int32_t m_N{1};
+        };
+
+        AddNIntValueOperationStrategy() = default;
+
+        explicit AddNIntValueOperationStrategy(const Parameters parameters)
+            : m_Parameters{parameters}
+        {
+        }
+
+        void operator()(IntValue<AddNIntValueOperationStrategy>& value)
+        {
+            value.SetValue(value.GetValue() + m_Parameters.m_N);
+        }
+
+        void operator()(int32_t& value, const Parameters& parameters)
+        {
+            value += parameters.m_N;
+        }
+
+        // Two contiguous int32_t streams, vectorized by the compiler
+        void operator()(const std::span<int32_t> values, const std::span<const Parameters> parameters)
+        {
+            for(size_t i{0}; i != values.size(); ++i)
+            {
+                values[i] += parameters[i].m_N;
+            }
+        }
+    private:
+        Parameters m_Parameters{};
+    };
+
+    using AddNIntValue = IntValue<AddNIntValueOperationStrategy>;
+
+    AddNIntValueOperationStrategy::Parameters CreateRandomAddNParameters(Rng::Generator& generator)
+    {
+        return {.m_N = static_cast<int32_t>(generator() % 8) + 1};
+    }
+}
+
+namespace ReferenceSemantics
+{
+    // One heap allocated strategy per value, the only way to give every value its own N
+    class AddNIntValueOperationStrategy final : public IntValue::OperationStrategy
+    {
+    public:
+        explicit AddNIntValueOperationStrategy(const int32_t n)
+            : m_N{n}
+        {
+        }
+
+        void Operation(IntValue& value) override
+        {
+            value.SetValue(value.GetValue() + m_N);
+        }
+    private:
+        int32_t m_N{1};
+    };
+}
+
+namespace Parameterized
+{
+    using Template::AddNIntValue;
+    using Template::AddNIntValueOperationStrategy;
+
+    TEST_CASE("Strategy - Parameterized - Unit Tests")
+    {
+        SECTION("Per object strategies")
+        {
+            AddNIntValue templateValue{10, AddNIntValueOperationStrategy{{.m_N = 3}}};
+            templateValue.Operation();
+            templateValue.Operation();
+            REQUIRE(templateValue.GetValue() == 16);
+
+            ReferenceSemantics::IntValue referenceValue{10,
+                std::make_unique<ReferenceSemantics::AddNIntValueOperationStrategy>(3)};
+            referenceValue.Operation();
+            REQUIRE(referenceValue.GetValue() == 13);
+        }
+
+        SECTION("Parameter column")
+        {
+            Template::StrategyPartition<AddNIntValue> partition{};
+            static_assert(Template::StrategyPartition<AddNIntValue>::IsParameterized);
+            static_assert(!Template::StrategyPartition<
+                Template::IntValue<Template::IncrementIntValueOperationStrategy>>::IsParameterized);
+            // The empty column of a stateless strategy overlaps the other members
+            static_assert(sizeof(Template::StrategyPartition<
+                Template::IntValue<Template::IncrementIntValueOperationStrategy>>) <=
+                sizeof(void*) + sizeof(std::vector<int32_t>));
+
+            partition.Add(0, {.m_N = 1});
+            partition.Add(10, {.m_N = -2});
+            partition.Add(100);
+            partition.Operation();
+            partition.Operation();
+            REQUIRE(std::vector<int32_t>(partition.GetValues().begin(), partition.GetValues().end()) ==
+                std::vector<int32_t>{2, 6, 102});
+
+            partition.GetParameters()[2].m_N = 5;
+            partition.Operation();
+            REQUIRE(partition.GetValues()[2] == 107);
+
+            partition.Clear();
+            REQUIRE(partition.GetSize() == 0);
+            REQUIRE(partition.GetParameters().empty());
+        }
+
+        SECTION("Mixed collection")
+        {
+            Template::StrategyCollection<AddNIntValue, Template::IntValue<Template::IncrementIntValueOperationStrategy>>
+                collection{};
+            collection.Add<AddNIntValue>(0, {.m_N = 4});
+            collection.Add<Template::IntValue<Template::IncrementIntValueOperationStrategy>>(0);
+            collection.Operation();
+            REQUIRE(collection.GetSize() == 2);
+            REQUIRE(collection.GetPartition<AddNIntValue>().GetValues()[0] == 4);
+            REQUIRE(collection.GetPartition<Template::IntValue<Template::IncrementIntValueOperationStrategy>>()
+                .GetValues()[0] == 1);
+        }
+
+        if constexpr(AllocationTracking::IsEnabled)
+        {
+            SECTION("Parameters do not allocate per value")
+            {
+                const AllocationTracking::Scope scope{};
+                Template::StrategyPartition<AddNIntValue> partition{};
+                partition.Reserve(10'000);
+                for(int32_t i{0}; i != 10'000; ++i)
+                {
+                    partition.Add(0, {.m_N = i});
+                }
+
+                REQUIRE(scope.GetStats().m_AllocationCount == 2);
+            }
+        }
+    }
+
+    // One million values with random N in [1, 8]
+    TEST_CASE("Strategy - Parameterized - Benchmark")
+    {
+        constexpr uint32_t valueCount{1'000'000};
+
+        BENCHMARK("Create - Reference Semantics")
+        {
+            std::vector<std::unique_ptr<ReferenceSemantics::Value>> values{};
+            values.reserve(valueCount);
+            Rng::Generator generator{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(std::make_unique<ReferenceSemantics::IntValue>(0,
+                    std::make_unique<ReferenceSemantics::AddNIntValueOperationStrategy>(
+                        Template::CreateRandomAddNParameters(generator).m_N)));
+            }
+
+            return values.size();
+        };
+
+        BENCHMARK("Create - Template")
+        {
+            std::vector<std::unique_ptr<Template::Value>> values{};
+            values.reserve(valueCount);
+            Rng::Generator generator{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(std::make_unique<AddNIntValue>(0,
+                    AddNIntValueOperationStrategy{Template::CreateRandomAddNParameters(generator)}));
+            }
+
+            return values.size();
+        };
+
+        BENCHMARK("Create - Parameter Column")
+        {
+            Template::StrategyPartition<AddNIntValue> partition{};
+            partition.Reserve(valueCount);
+            Rng::Generator generator{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                partition.Add(0, Template::CreateRandomAddNParameters(generator));
+            }
+
+            return partition.GetSize();
+        };
+
+        BENCHMARK_ADVANCED("Operation - Reference Semantics")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<ReferenceSemantics::Value>> values{};
+            values.reserve(valueCount);
+            Rng::Generator generator{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(std::make_unique<ReferenceSemantics::IntValue>(0,
+                    std::make_unique<ReferenceSemantics::AddNIntValueOperationStrategy>(
+                        Template::CreateRandomAddNParameters(generator).m_N)));
+            }
+
+            meter.measure(
+                [&values]()
+                {
+                    for(const std::unique_ptr<ReferenceSemantics::Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("Operation - Template")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Template::Value>> values{};
+            values.reserve(valueCount);
+            Rng::Generator generator{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(std::make_unique<AddNIntValue>(0,
+                    AddNIntValueOperationStrategy{Template::CreateRandomAddNParameters(generator)}));
+            }
+
+            meter.measure(
+                [&values]()
+                {
+                    for(const std::unique_ptr<Template::Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("Operation - Parameter Column")(Catch::Benchmark::Chronometer meter)
+        {
+            Template::StrategyPartition<AddNIntValue> partition{};
+            partition.Reserve(valueCount);
+            Rng::Generator generator{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                partition.Add(0, Template::CreateRandomAddNParameters(generator));
+            }
+
+            meter.measure(
+                [&partition]()
+                {
+                    partition.Operation();
+                });
+        };
+    }
+}
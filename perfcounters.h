@@ -0,0 +1,257 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#if defined(__linux__)
+    #define PERF_COUNTERS_LINUX
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+// Hardware performance counters for the calling thread, read around a measured region.
+// Linux uses perf_event_open(), counters the kernel or the CPU (e.g. in a VM) does not provide, and counters
+// that were multiplexed out for the whole region, are reported as unavailable. Other platforms only expose
+// the PMU through kernel drivers or ETW sessions that require elevation, every counter is unavailable there.
+namespace PerfCounters
+{
+    enum class Counter : uint8_t
+    {
+        Instructions,
+        Cycles,
+        BranchMisses,
+        L1dMisses,
+        LlcMisses,
+        DtlbMisses,
+        Count
+    };
+
+    constexpr size_t CounterCount{static_cast<size_t>(Counter::Count)};
+
+    inline std::string_view GetName(const Counter counter)
+    {
+        switch(counter)
+        {
+        case Counter::Instructions: return "instructions";
+        case Counter::Cycles: return "cycles";
+        case Counter::BranchMisses: return "branch-misses";
+        case Counter::L1dMisses: return "L1d-misses";
+        case Counter::LlcMisses: return "LLC-misses";
+        case Counter::DtlbMisses: return "dTLB-misses";
+        case Counter::Count: break;
+        }
+
+        return "unknown";
+    }
+
+    struct CounterValues
+    {
+        std::array<std::optional<uint64_t>, CounterCount> m_Values{};
+
+        const std::optional<uint64_t>& operator[](const Counter counter) const
+        {
+            return m_Values[static_cast<size_t>(counter)];
+        }
+    };
+
+    // All counters are one perf event group led by Cycles (or the first counter that opens): the kernel
+    // schedules them together, so they count the same slices of the region and ratios between them hold.
+    // Counters that do not fit on the PMU next to the others are left out of the group and unavailable.
+    class CounterGroup
+    {
+    public:
+        CounterGroup()
+        {
+            m_FileDescriptors.fill(-1);
+#if defined(PERF_COUNTERS_LINUX)
+            for(const Counter counter: GroupOrder)
+            {
+                const int fileDescriptor{Open(counter, m_LeaderFileDescriptor)};
+                if(fileDescriptor == -1)
+                    continue;
+
+                if(m_LeaderFileDescriptor == -1)
+                    m_LeaderFileDescriptor = fileDescriptor;
+
+                m_FileDescriptors[static_cast<size_t>(counter)] = fileDescriptor;
+                m_GroupCounters[m_GroupSize++] = counter;
+                if(IsSchedulable())
+                    continue;
+
+                // Closing a member removes it from the group
+                close(fileDescriptor);
+                m_FileDescriptors[static_cast<size_t>(counter)] = -1;
+                --m_GroupSize;
+                if(fileDescriptor == m_LeaderFileDescriptor)
+                    m_LeaderFileDescriptor = -1;
+            }
+#endif
+        }
+
+        CounterGroup(const CounterGroup&) = delete;
+        CounterGroup& operator=(const CounterGroup&) = delete;
+
+        ~CounterGroup()
+        {
+#if defined(PERF_COUNTERS_LINUX)
+            // Members before the leader
+            for(const int fileDescriptor: m_FileDescriptors)
+            {
+                if(fileDescriptor != -1 && fileDescriptor != m_LeaderFileDescriptor)
+                    close(fileDescriptor);
+            }
+
+            if(m_LeaderFileDescriptor != -1)
+                close(m_LeaderFileDescriptor);
+#endif
+        }
+
+        bool IsAvailable(const Counter counter) const
+        {
+            return m_FileDescriptors[static_cast<size_t>(counter)] != -1;
+        }
+
+        void Start()
+        {
+#if defined(PERF_COUNTERS_LINUX)
+            if(m_LeaderFileDescriptor == -1)
+                return;
+
+            ioctl(m_LeaderFileDescriptor, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(m_LeaderFileDescriptor, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        }
+
+        CounterValues Stop()
+        {
+            CounterValues values{};
+#if defined(PERF_COUNTERS_LINUX)
+            if(m_LeaderFileDescriptor == -1)
+                return values;
+
+            ioctl(m_LeaderFileDescriptor, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            const std::optional<GroupReading> reading{Read()};
+            // Never scheduled during the region, multiplexed out the whole time
+            if(!reading || reading->m_TimeRunning == 0)
+                return values;
+
+            // One scale for the whole group, scaled up when the kernel had to multiplex it with other events
+            const double scale{static_cast<double>(reading->m_TimeEnabled) / reading->m_TimeRunning};
+            for(size_t index{0}; index != m_GroupSize; ++index)
+            {
+                values.m_Values[static_cast<size_t>(m_GroupCounters[index])] =
+                    static_cast<uint64_t>(static_cast<double>(reading->m_Values[index]) * scale);
+            }
+#endif
+            return values;
+        }
+
+        template<typename TCallable>
+        CounterValues Measure(TCallable&& callable)
+        {
+            Start();
+            callable();
+            return Stop();
+        }
+    private:
+#if defined(PERF_COUNTERS_LINUX)
+        // Leader first, the fixed function counters before the cache events that compete for generic counters
+        static constexpr std::array<Counter, CounterCount> GroupOrder{Counter::Cycles, Counter::Instructions,
+            Counter::BranchMisses, Counter::L1dMisses, Counter::LlcMisses, Counter::DtlbMisses};
+
+        // PERF_FORMAT_GROUP layout, values in the order the counters joined the group
+        struct GroupReading
+        {
+            uint64_t m_CounterCount;
+            uint64_t m_TimeEnabled;
+            uint64_t m_TimeRunning;
+            std::array<uint64_t, CounterCount> m_Values;
+        };
+
+        std::optional<GroupReading> Read() const
+        {
+            GroupReading reading{};
+            const ssize_t size{read(m_LeaderFileDescriptor, &reading, sizeof(reading))};
+            if(size < static_cast<ssize_t>(3 * sizeof(uint64_t) + m_GroupSize * sizeof(uint64_t)) ||
+                reading.m_CounterCount != m_GroupSize)
+            {
+                return std::nullopt;
+            }
+
+            return reading;
+        }
+
+        // A group is only scheduled as a whole, a member that does not fit would keep every counter from
+        // running
+        bool IsSchedulable()
+        {
+            Start();
+            ioctl(m_LeaderFileDescriptor, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            const std::optional<GroupReading> reading{Read()};
+            return reading && reading->m_TimeRunning != 0;
+        }
+
+        static int Open(const Counter counter, const int leaderFileDescriptor)
+        {
+            const auto cacheMiss{
+                [](const uint64_t cache)
+                {
+                    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                }};
+
+            perf_event_attr attributes{};
+            attributes.size = sizeof(attributes);
+            // Members follow the leader, which is enabled and disabled for the whole group
+            attributes.disabled = leaderFileDescriptor == -1 ? 1 : 0;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format =
+                PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            switch(counter)
+            {
+            case Counter::Instructions:
+                attributes.type = PERF_TYPE_HARDWARE;
+                attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case Counter::Cycles:
+                attributes.type = PERF_TYPE_HARDWARE;
+                attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case Counter::BranchMisses:
+                attributes.type = PERF_TYPE_HARDWARE;
+                attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            case Counter::L1dMisses:
+                attributes.type = PERF_TYPE_HW_CACHE;
+                attributes.config = cacheMiss(PERF_COUNT_HW_CACHE_L1D);
+                break;
+            case Counter::LlcMisses:
+                attributes.type = PERF_TYPE_HW_CACHE;
+                attributes.config = cacheMiss(PERF_COUNT_HW_CACHE_LL);
+                break;
+            case Counter::DtlbMisses:
+                attributes.type = PERF_TYPE_HW_CACHE;
+                attributes.config = cacheMiss(PERF_COUNT_HW_CACHE_DTLB);
+                break;
+            case Counter::Count:
+                return -1;
+            }
+
+            // Calling thread on any CPU
+            return static_cast<int>(
+                syscall(SYS_perf_event_open, &attributes, 0, -1, leaderFileDescriptor, 0));
+        }
+#endif
+
+        std::array<int, CounterCount> m_FileDescriptors{};
+        int m_LeaderFileDescriptor{-1};
+        std::array<Counter, CounterCount> m_GroupCounters{};
+        size_t m_GroupSize{0};
+    };
+}
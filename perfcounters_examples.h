@@ -0,0 +1,122 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmarksuite_examples.h"
+#include "perfcounters.h"
+
+namespace PerfCounters
+{
+    // e.g. "instructions 12.40, cycles 4.10, branch-misses n/a, ..." per Operation() call
+    std::string FormatPerOperation(const CounterValues& values, const uint64_t operationCount)
+    {
+        std::ostringstream stream{};
+        stream << std::fixed << std::setprecision(2);
+        for(size_t counter{0}; counter != CounterCount; ++counter)
+        {
+            stream << (counter == 0 ? "" : ", ") << GetName(static_cast<Counter>(counter)) << ' ';
+            if(values.m_Values[counter])
+                stream << static_cast<double>(*values.m_Values[counter]) / static_cast<double>(operationCount);
+            else
+                stream << "n/a";
+        }
+
+        return stream.str();
+    }
+
+    // Counts one warmed up run of iterationCount passes over the population, printed per Operation() call
+    template<typename TEngine>
+    void ReportEngine(
+        CounterGroup& counterGroup,
+        const std::vector<BenchmarkSuite::ValueKind>& valueKinds,
+        const uint32_t iterationCount)
+    {
+        typename TEngine::Population population{TEngine::Create(valueKinds)};
+        TEngine::Run(population);
+
+        const CounterValues values{counterGroup.Measure(
+            [&population, iterationCount]()
+            {
+                for(uint32_t iteration{0}; iteration != iterationCount; ++iteration)
+                {
+                    TEngine::Run(population);
+                }
+            })};
+
+        std::cout << std::left << std::setw(24) << TEngine::Name
+            << FormatPerOperation(values, valueKinds.size() * iterationCount) << '\n';
+    }
+
+    TEST_CASE("Strategy - Performance Counters - Unit Tests")
+    {
+        SECTION("Names")
+        {
+            REQUIRE(GetName(Counter::Instructions) == "instructions");
+            REQUIRE(GetName(Counter::DtlbMisses) == "dTLB-misses");
+        }
+
+        SECTION("Format")
+        {
+            CounterValues values{};
+            values.m_Values[static_cast<size_t>(Counter::Instructions)] = 1'000;
+            const std::string text{FormatPerOperation(values, 100)};
+            REQUIRE(text.starts_with("instructions 10.00, cycles n/a"));
+        }
+
+        SECTION("Measure")
+        {
+            CounterGroup counterGroup{};
+            volatile uint64_t sum{0};
+            const CounterValues values{counterGroup.Measure(
+                [&sum]()
+                {
+                    for(uint64_t i{0}; i != 100'000; ++i)
+                    {
+                        sum = sum + i;
+                    }
+                })};
+
+            // Counters may be unavailable, e.g. in VMs or when perf_event_paranoid forbids them, and an available
+            // counter has no value when it was multiplexed out for the whole region
+            for(size_t counter{0}; counter != CounterCount; ++counter)
+            {
+                REQUIRE((!values.m_Values[counter] || counterGroup.IsAvailable(static_cast<Counter>(counter))));
+            }
+
+            if(values[Counter::Instructions])
+            {
+                REQUIRE(*values[Counter::Instructions] >= 100'000);
+            }
+        }
+    }
+
+    // Prints hardware counters per Operation() call for every engine, run with "[counters]".
+    // The counts are not part of the Catch2 benchmark output: between the benchmarkStarting and benchmarkEnded
+    // events a listener would see, Catch2 also runs its clock warm-up, which would dominate the counts of
+    // short benchmarks. This measures the same engines and populations as the benchmark suite instead.
+    TEST_CASE("Strategy - Performance Counters - Report", "[.][counters]")
+    {
+        constexpr uint32_t iterationCount{10};
+        CounterGroup counterGroup{};
+
+        for(const size_t valueCount: {10'000, 1'000'000})
+        {
+            const std::vector<BenchmarkSuite::ValueKind> valueKinds{BenchmarkSuite::CreateValueKinds(valueCount, 50)};
+            std::cout << valueCount << " values, " << iterationCount << " iterations, per Operation():\n";
+
+            ReportEngine<BenchmarkSuite::ReferenceSemanticsEngine>(counterGroup, valueKinds, iterationCount);
+            ReportEngine<BenchmarkSuite::ValueSemanticsEngine>(counterGroup, valueKinds, iterationCount);
+            ReportEngine<BenchmarkSuite::InlineValueSemanticsEngine>(counterGroup, valueKinds, iterationCount);
+            ReportEngine<BenchmarkSuite::TemplateEngine>(counterGroup, valueKinds, iterationCount);
+            ReportEngine<BenchmarkSuite::ExternalPolymorphismEngine>(counterGroup, valueKinds, iterationCount);
+            ReportEngine<BenchmarkSuite::VariantSemanticsEngine>(counterGroup, valueKinds, iterationCount);
+            ReportEngine<BenchmarkSuite::StrategyCollectionEngine>(counterGroup, valueKinds, iterationCount);
+        }
+    }
+}
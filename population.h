@@ -0,0 +1,114 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+#include "rng.h"
+#include "threadpool.h"
+
+// Values created in parallel by the workers of a thread pool.
+// Each worker allocates its values from its own arena, so the workers do not contend on the global heap and
+// the memory of a value is first touched by the worker that created it. Only that arena memory is placed:
+// m_Values is sized and first touched by the calling thread, so the handles (and values stored inline in
+// m_Values, e.g. ExternalPolymorphism::AnyValue) live on the node of the caller.
+// The arenas are declared before the values so the values are destroyed first, and the optional upstream
+// resources of the arenas before both.
+template<typename TValue>
+struct ValuePopulation
+{
+    std::vector<std::unique_ptr<std::pmr::memory_resource>> m_UpstreamResources{};
+    std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> m_Arenas{};
+    std::vector<TValue> m_Values{};
+};
+
+namespace Population
+{
+    // CreateRandomValue(Rng::Generator&) draws two booleans per value
+    constexpr uint64_t BoolsPerValue{2};
+
+    // Index of the first value created by workerIndex
+    inline size_t GetRangeBegin(const size_t count, const size_t workerIndex, const size_t workerCount)
+    {
+        return count * workerIndex / workerCount;
+    }
+
+    // Calls createValue(generator, arena) for every value of the population in place. Every worker seeks the
+    // generator to the first value of its range, so the population is the same for every thread count.
+    // bytesPerValue sizes the initial arena block of each worker, 0 creates no arenas for values without
+    // heap storage. createUpstreamResource(workerIndex) runs on the worker and returns the resource its arena
+    // allocates from (e.g. memory bound to the NUMA node of the worker), nullptr for the default resource.
+    template<typename TValue, typename TCreateValue, typename TCreateUpstreamResource>
+    ValuePopulation<TValue> CreateValues(
+        const size_t count,
+        ThreadPool& threadPool,
+        const uint64_t seed,
+        const size_t bytesPerValue,
+        const TCreateValue& createValue,
+        const TCreateUpstreamResource& createUpstreamResource)
+    {
+        ValuePopulation<TValue> population{};
+        const size_t workerCount{threadPool.GetThreadCount()};
+        population.m_UpstreamResources.resize(bytesPerValue == 0 ? 0 : workerCount);
+        population.m_Arenas.resize(bytesPerValue == 0 ? 0 : workerCount);
+
+        // Every element is constructed here, on the calling thread, before the workers overwrite their range
+        if constexpr(std::is_default_constructible_v<TValue>)
+        {
+            population.m_Values.resize(count);
+        }
+        else if(count != 0)
+        {
+            // Placeholders, overwritten by the workers
+            Rng::Generator generator{seed};
+            std::pmr::memory_resource& memoryResource{*std::pmr::null_memory_resource()};
+            population.m_Values.resize(count, createValue(generator, memoryResource));
+        }
+
+        threadPool.Run(
+            [&population, &createValue, &createUpstreamResource, count, seed, bytesPerValue, workerCount](
+                const size_t workerIndex)
+            {
+                const size_t begin{GetRangeBegin(count, workerIndex, workerCount)};
+                const size_t end{GetRangeBegin(count, workerIndex + 1, workerCount)};
+                if(begin == end)
+                    return;
+
+                std::pmr::memory_resource* memoryResource{std::pmr::null_memory_resource()};
+                if(bytesPerValue != 0)
+                {
+                    population.m_UpstreamResources[workerIndex] = createUpstreamResource(workerIndex);
+                    std::pmr::memory_resource* const upstreamResource{population.m_UpstreamResources[workerIndex] ?
+                        population.m_UpstreamResources[workerIndex].get() : std::pmr::get_default_resource()};
+                    population.m_Arenas[workerIndex] = std::make_unique<std::pmr::monotonic_buffer_resource>(
+                        (end - begin) * bytesPerValue, upstreamResource);
+                    memoryResource = population.m_Arenas[workerIndex].get();
+                }
+
+                Rng::Generator generator{seed};
+                generator.SeekBool(begin * BoolsPerValue);
+                for(size_t i{begin}; i != end; ++i)
+                {
+                    population.m_Values[i] = createValue(generator, *memoryResource);
+                }
+            });
+
+        return population;
+    }
+
+    template<typename TValue, typename TCreateValue>
+    ValuePopulation<TValue> CreateValues(
+        const size_t count,
+        ThreadPool& threadPool,
+        const uint64_t seed,
+        const size_t bytesPerValue,
+        const TCreateValue& createValue)
+    {
+        return CreateValues<TValue>(count, threadPool, seed, bytesPerValue, createValue,
+            [](size_t)
+            {
+                return std::unique_ptr<std::pmr::memory_resource>{};
+            });
+    }
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#include "externalpolymorphism_examples.h"
+#include "inlinevaluesemantics_examples.h"
+#include "population.h"
+#include "referencesemantics_examples.h"
+#include "rng.h"
+#include "template_examples.h"
+#include "threadpool.h"
+#include "valuesemantics_examples.h"
+#include "variantsemantics_examples.h"
+
+namespace Population
+{
+    // Whether the population has the dynamic types of count calls of CreateRandomValue(generator)
+    template<typename TValue, typename TCreateRandomValue>
+    bool IsSameAsSerial(const std::vector<TValue>& values, const TCreateRandomValue& createRandomValue)
+    {
+        Rng::Generator generator{};
+        return std::ranges::all_of(values,
+            [&generator, &createRandomValue](const TValue& value)
+            {
+                const auto expected{createRandomValue(generator)};
+                return typeid(*value) == typeid(*expected);
+            });
+    }
+
+    TEST_CASE("Strategy - Population - Unit Tests")
+    {
+        constexpr size_t valueCount{1'001};
+        ThreadPool serialThreadPool{1};
+        ThreadPool threadPool{4};
+
+        SECTION("Ranges")
+        {
+            REQUIRE(GetRangeBegin(valueCount, 0, 4) == 0);
+            REQUIRE(GetRangeBegin(valueCount, 4, 4) == valueCount);
+            REQUIRE(GetRangeBegin(3, 1, 4) == GetRangeBegin(3, 0, 4));
+        }
+
+        SECTION("Independent of Thread Count")
+        {
+            const ValuePopulation<Arena::UniquePtr<Template::Value>> serial{
+                Template::CreateRandomValues(valueCount, serialThreadPool)};
+            const ValuePopulation<Arena::UniquePtr<Template::Value>> parallel{
+                Template::CreateRandomValues(valueCount, threadPool)};
+
+            REQUIRE(serial.m_Values.size() == valueCount);
+            REQUIRE(parallel.m_Values.size() == valueCount);
+            REQUIRE(serial.m_Arenas.size() == 1);
+            REQUIRE(parallel.m_Arenas.size() == 4);
+            REQUIRE(std::ranges::equal(serial.m_Values, parallel.m_Values,
+                [](const auto& first, const auto& second){ return typeid(*first) == typeid(*second); }));
+
+            REQUIRE(IsSameAsSerial(parallel.m_Values,
+                [](Rng::Generator& generator){ return Template::CreateRandomValue(generator); }));
+            REQUIRE(IsSameAsSerial(ReferenceSemantics::CreateRandomValues(valueCount, threadPool).m_Values,
+                [](Rng::Generator& generator){ return ReferenceSemantics::CreateRandomValue(generator); }));
+            REQUIRE(IsSameAsSerial(ValueSemantics::CreateRandomValues(valueCount, threadPool).m_Values,
+                [](Rng::Generator& generator){ return ValueSemantics::CreateRandomValue(generator); }));
+            REQUIRE(IsSameAsSerial(InlineValueSemantics::CreateRandomValues(valueCount, threadPool).m_Values,
+                [](Rng::Generator& generator){ return InlineValueSemantics::CreateRandomValue(generator); }));
+        }
+
+        SECTION("Arena Ownership")
+        {
+            const ValuePopulation<Arena::UniquePtr<ReferenceSemantics::Value>> population{
+                ReferenceSemantics::CreateRandomValues(valueCount, threadPool)};
+
+            REQUIRE(std::ranges::all_of(population.m_Values,
+                [](const Arena::UniquePtr<ReferenceSemantics::Value>& value)
+                {
+                    return value && value.GetOwnership() == Arena::Ownership::Arena;
+                }));
+        }
+
+        SECTION("Inline Values")
+        {
+            ValuePopulation<VariantSemantics::Value> variantPopulation{
+                VariantSemantics::CreateRandomValues(valueCount, threadPool)};
+            REQUIRE(variantPopulation.m_Arenas.empty());
+
+            Rng::Generator generator{};
+            REQUIRE(std::ranges::all_of(variantPopulation.m_Values,
+                [&generator](const VariantSemantics::Value& value)
+                {
+                    return value.index() == VariantSemantics::CreateRandomValue(generator).index();
+                }));
+
+            ValuePopulation<ExternalPolymorphism::AnyValue> anyPopulation{
+                ExternalPolymorphism::CreateRandomValues(valueCount, threadPool)};
+            REQUIRE(anyPopulation.m_Values.size() == valueCount);
+
+            const auto getKind{
+                [](ExternalPolymorphism::AnyValue& value)
+                {
+                    using namespace Template;
+                    return (value.Get<IntValue<IncrementIntValueOperationStrategy>>() ? 1 : 0) +
+                        (value.Get<IntValue<DecrementIntValueOperationStrategy>>() ? 2 : 0) +
+                        (value.Get<FloatValue<IncrementFloatValueOperationStrategy>>() ? 3 : 0);
+                }};
+
+            generator.Seek(0);
+            bool isSameType{true};
+            for(ExternalPolymorphism::AnyValue& value: anyPopulation.m_Values)
+            {
+                ExternalPolymorphism::AnyValue expected{ExternalPolymorphism::CreateRandomValue(generator)};
+                isSameType &= getKind(value) == getKind(expected);
+            }
+
+            REQUIRE(isSameType);
+        }
+
+        SECTION("Empty")
+        {
+            REQUIRE(Template::CreateRandomValues(0, threadPool).m_Values.empty());
+            REQUIRE(ExternalPolymorphism::CreateRandomValues(0, threadPool).m_Values.empty());
+            REQUIRE(Template::CreateRandomValues(3, threadPool).m_Values.size() == 3);
+        }
+    }
+
+    // Startup time of a population, serial push_back of heap values vs. parallel creation into per-thread arenas
+    TEST_CASE("Strategy - Population - Benchmark")
+    {
+        constexpr size_t valueCount{1'000'000};
+
+        BENCHMARK("Template::CreateRandomValue() push_back")
+        {
+            std::vector<std::unique_ptr<Template::Value>> values{};
+            values.reserve(valueCount);
+
+            for(size_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(Template::CreateRandomValue());
+            }
+
+            return values.size();
+        };
+
+        std::vector<size_t> threadCounts{1, 2, 4};
+        if(const size_t hardwareThreadCount{std::thread::hardware_concurrency()};
+            hardwareThreadCount > threadCounts.back())
+        {
+            threadCounts.push_back(hardwareThreadCount);
+        }
+
+        for(const size_t threadCount: threadCounts)
+        {
+            ThreadPool threadPool{threadCount};
+            const std::string suffix{" (" + std::to_string(threadCount) + " threads)"};
+
+            BENCHMARK("Template::CreateRandomValues" + suffix)
+            {
+                return Template::CreateRandomValues(valueCount, threadPool).m_Values.size();
+            };
+
+            BENCHMARK("ReferenceSemantics::CreateRandomValues" + suffix)
+            {
+                return ReferenceSemantics::CreateRandomValues(valueCount, threadPool).m_Values.size();
+            };
+
+            BENCHMARK("VariantSemantics::CreateRandomValues" + suffix)
+            {
+                return VariantSemantics::CreateRandomValues(valueCount, threadPool).m_Values.size();
+            };
+        }
+    }
+}
@@ -3,6 +3,19 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <random/random.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "allocationtracking.h"
+#include "arena.h"
+#include "population.h"
+#include "rng.h"
+#include "telemetry.h"
+#include "threadpool.h"
 
 namespace ReferenceSemantics
 {
@@ -21,6 +34,58 @@ namespace ReferenceSemantics
         virtual void Operation(TValue&) = 0;
     };
 
+    template<typename TValue, size_t TSlotCount>
+    class StrategyTable;
+
+    // Pointer-sized, non-owning handle to a strategy that outlives every value using it. Handles are only
+    // given out by the flyweight registry (GetSharedOperationStrategy()) and by StrategyTable, so a value can
+    // not silently end up referencing a stack local or a stateful strategy that somebody else owns.
+    template<typename TValue>
+    class SharedOperationStrategy
+    {
+    public:
+        // Stateless strategies hold no data besides their vptr, so one instance per type is shared by all
+        // values (flyweight)
+        template<typename TOperationStrategy>
+        static SharedOperationStrategy GetRegistered()
+        {
+            static_assert(std::is_polymorphic_v<TOperationStrategy> && sizeof(TOperationStrategy) == sizeof(void*),
+                "Only stateless strategies can be shared");
+
+            static TOperationStrategy operationStrategy{};
+            return SharedOperationStrategy{operationStrategy};
+        }
+
+        OperationStrategy<TValue>& Get() const { return *m_OperationStrategy; }
+
+        bool operator==(const SharedOperationStrategy&) const = default;
+    private:
+        template<typename, size_t>
+        friend class StrategyTable;
+
+        explicit SharedOperationStrategy(OperationStrategy<TValue>& operationStrategy)
+            : m_OperationStrategy{&operationStrategy}
+        {
+        }
+
+        OperationStrategy<TValue>* m_OperationStrategy{nullptr};
+    };
+
+    namespace Detail
+    {
+        template<typename TValue>
+        TValue* GetStrategyValue(const OperationStrategy<TValue>&);
+    }
+
+    // Setting a shared strategy stores a tagged pointer and never allocates
+    template<typename TOperationStrategy>
+    auto GetSharedOperationStrategy()
+    {
+        using StrategyValue = std::remove_pointer_t<
+            decltype(Detail::GetStrategyValue(std::declval<const TOperationStrategy&>()))>;
+        return SharedOperationStrategy<StrategyValue>::template GetRegistered<TOperationStrategy>();
+    }
+
     // IntValue
     class IntValue final : public Value
     {
@@ -28,27 +93,46 @@ namespace ReferenceSemantics
         using OperationStrategy = OperationStrategy<IntValue>;
 
         explicit IntValue(
-            const int32_t value, std::unique_ptr<OperationStrategy>&& operationStrategy)
+            const int32_t value, Arena::UniquePtr<OperationStrategy>&& operationStrategy)
             : m_OperationStrategy{std::move(operationStrategy)}
             , m_Value{value}
+            , m_TelemetrySite{*m_OperationStrategy}
+        {
+        }
+
+        explicit IntValue(
+            const int32_t value, const SharedOperationStrategy<IntValue> sharedOperationStrategy)
+            : m_OperationStrategy{Arena::MakeNonOwning(sharedOperationStrategy.Get())}
+            , m_Value{value}
+            , m_TelemetrySite{*m_OperationStrategy}
         {
         }
 
-        void SetOperationStrategy(std::unique_ptr<OperationStrategy>&& operationStrategy)
+        void SetOperationStrategy(Arena::UniquePtr<OperationStrategy>&& operationStrategy)
         {
             m_OperationStrategy = std::move(operationStrategy);
+            m_TelemetrySite = Telemetry::DynamicSite<>{*m_OperationStrategy};
+        }
+
+        void SetOperationStrategy(const SharedOperationStrategy<IntValue> sharedOperationStrategy)
+        {
+            m_OperationStrategy = Arena::MakeNonOwning(sharedOperationStrategy.Get());
+            m_TelemetrySite = Telemetry::DynamicSite<>{*m_OperationStrategy};
         }
 
         void Operation() override
         {
+            const Telemetry::ScopedDynamicSample sample{m_TelemetrySite};
             m_OperationStrategy->Operation(*this);
         }
 
         int32_t GetValue() const { return m_Value; }
         void SetValue(const int32_t value) { m_Value = value; }
     private:
-        std::unique_ptr<OperationStrategy> m_OperationStrategy{};
+        Arena::UniquePtr<OperationStrategy> m_OperationStrategy{};
         int32_t m_Value{0};
+        // Keyed by the dynamic type of the strategy
+        Telemetry::DynamicSite<> m_TelemetrySite{};
     };
 
     class IncrementIntValueOperationStrategy final : public IntValue::OperationStrategy
@@ -76,27 +160,46 @@ namespace ReferenceSemantics
         using OperationStrategy = OperationStrategy<FloatValue>;
 
         explicit FloatValue(
-            const float_t value, std::unique_ptr<OperationStrategy>&& operationStrategy)
+            const float_t value, Arena::UniquePtr<OperationStrategy>&& operationStrategy)
             : m_OperationStrategy{std::move(operationStrategy)}
             , m_Value{value}
+            , m_TelemetrySite{*m_OperationStrategy}
         {
         }
 
-        void SetOperationStrategy(std::unique_ptr<OperationStrategy>&& operationStrategy)
+        explicit FloatValue(
+            const float_t value, const SharedOperationStrategy<FloatValue> sharedOperationStrategy)
+            : m_OperationStrategy{Arena::MakeNonOwning(sharedOperationStrategy.Get())}
+            , m_Value{value}
+            , m_TelemetrySite{*m_OperationStrategy}
+        {
+        }
+
+        void SetOperationStrategy(Arena::UniquePtr<OperationStrategy>&& operationStrategy)
         {
             m_OperationStrategy = std::move(operationStrategy);
+            m_TelemetrySite = Telemetry::DynamicSite<>{*m_OperationStrategy};
+        }
+
+        void SetOperationStrategy(const SharedOperationStrategy<FloatValue> sharedOperationStrategy)
+        {
+            m_OperationStrategy = Arena::MakeNonOwning(sharedOperationStrategy.Get());
+            m_TelemetrySite = Telemetry::DynamicSite<>{*m_OperationStrategy};
         }
 
         void Operation() override
         {
+            const Telemetry::ScopedDynamicSample sample{m_TelemetrySite};
             m_OperationStrategy->Operation(*this);
         }
 
         float_t GetValue() const { return m_Value; }
         void SetValue(const float_t value) { m_Value = value; }
     private:
-        std::unique_ptr<OperationStrategy> m_OperationStrategy{};
+        Arena::UniquePtr<OperationStrategy> m_OperationStrategy{};
         float_t m_Value{0.0f};
+        // Keyed by the dynamic type of the strategy
+        Telemetry::DynamicSite<> m_TelemetrySite{};
     };
 
     class IncrementFloatValueOperationStrategy final : public FloatValue::OperationStrategy
@@ -117,14 +220,14 @@ namespace ReferenceSemantics
         }
     };
 
-    std::unique_ptr<Value> CreateRandomValue()
+    std::unique_ptr<Value> CreateValue(const bool isIntValue, const bool isIncrement)
     {
-        if(Random::RandomBool())
+        if(isIntValue)
         {
             std::unique_ptr<IntValue::OperationStrategy> operationStrategy{
-                []() -> std::unique_ptr<IntValue::OperationStrategy>
+                [isIncrement]() -> std::unique_ptr<IntValue::OperationStrategy>
                 {
-                    if(Random::RandomBool())
+                    if(isIncrement)
                         return std::make_unique<IncrementIntValueOperationStrategy>();
 
                     return std::make_unique<DecrementIntValueOperationStrategy>();
@@ -134,9 +237,9 @@ namespace ReferenceSemantics
         }
 
         std::unique_ptr<FloatValue::OperationStrategy> operationStrategy{
-            []() -> std::unique_ptr<FloatValue::OperationStrategy>
+            [isIncrement]() -> std::unique_ptr<FloatValue::OperationStrategy>
             {
-                if(Random::RandomBool())
+                if(isIncrement)
                     return std::make_unique<IncrementFloatValueOperationStrategy>();
 
                 return std::make_unique<DecrementFloatValueOperationStrategy>();
@@ -145,6 +248,113 @@ namespace ReferenceSemantics
         return std::make_unique<FloatValue>(0.0f, std::move(operationStrategy));
     }
 
+    std::unique_ptr<Value> CreateRandomValue()
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    std::unique_ptr<Value> CreateRandomValue(Rng::Generator& generator)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    std::unique_ptr<Value> CreateRandomFlyweightValue()
+    {
+        if(Random::RandomBool())
+        {
+            const SharedOperationStrategy<IntValue> operationStrategy{
+                Random::RandomBool() ?
+                    GetSharedOperationStrategy<IncrementIntValueOperationStrategy>() :
+                    GetSharedOperationStrategy<DecrementIntValueOperationStrategy>()};
+
+            return std::make_unique<IntValue>(0, operationStrategy);
+        }
+
+        const SharedOperationStrategy<FloatValue> operationStrategy{
+            Random::RandomBool() ?
+                GetSharedOperationStrategy<IncrementFloatValueOperationStrategy>() :
+                GetSharedOperationStrategy<DecrementFloatValueOperationStrategy>()};
+
+        return std::make_unique<FloatValue>(0.0f, operationStrategy);
+    }
+
+    Arena::UniquePtr<Value> CreateValue(
+        const bool isIntValue, const bool isIncrement, std::pmr::memory_resource& memoryResource)
+    {
+        if(isIntValue)
+        {
+            Arena::UniquePtr<IntValue::OperationStrategy> operationStrategy{
+                [isIncrement, &memoryResource]() -> Arena::UniquePtr<IntValue::OperationStrategy>
+                {
+                    if(isIncrement)
+                        return Arena::MakeUnique<IncrementIntValueOperationStrategy>(memoryResource);
+
+                    return Arena::MakeUnique<DecrementIntValueOperationStrategy>(memoryResource);
+                }()};
+
+            return Arena::MakeUnique<IntValue>(memoryResource, 0, std::move(operationStrategy));
+        }
+
+        Arena::UniquePtr<FloatValue::OperationStrategy> operationStrategy{
+            [isIncrement, &memoryResource]() -> Arena::UniquePtr<FloatValue::OperationStrategy>
+            {
+                if(isIncrement)
+                    return Arena::MakeUnique<IncrementFloatValueOperationStrategy>(memoryResource);
+
+                return Arena::MakeUnique<DecrementFloatValueOperationStrategy>(memoryResource);
+            }()};
+
+        return Arena::MakeUnique<FloatValue>(memoryResource, 0.0f, std::move(operationStrategy));
+    }
+
+    Arena::UniquePtr<Value> CreateRandomValue(std::pmr::memory_resource& memoryResource)
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        return CreateValue(isIntValue, isIncrement, memoryResource);
+    }
+
+    Arena::UniquePtr<Value> CreateRandomValue(Rng::Generator& generator, std::pmr::memory_resource& memoryResource)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement, memoryResource);
+    }
+
+    // Same values as count calls of CreateRandomValue(generator) for every thread count
+    ValuePopulation<Arena::UniquePtr<Value>> CreateRandomValues(
+        const size_t count, ThreadPool& threadPool = GetDefaultThreadPool(), const uint64_t seed = Rng::DefaultSeed)
+    {
+        // Value and strategy
+        return Population::CreateValues<Arena::UniquePtr<Value>>(count, threadPool, seed,
+            std::max(sizeof(IntValue), sizeof(FloatValue)) + sizeof(IncrementIntValueOperationStrategy),
+            [](Rng::Generator& generator, std::pmr::memory_resource& memoryResource)
+            {
+                return CreateRandomValue(generator, memoryResource);
+            });
+    }
+
+    // Stateful, can not be shared
+    class StepIntValueOperationStrategy final : public IntValue::OperationStrategy
+    {
+    public:
+        explicit StepIntValueOperationStrategy(const int32_t step)
+            : m_Step{step}
+        {
+        }
+
+        void Operation(IntValue& value) override
+        {
+            value.SetValue(value.GetValue() + m_Step);
+        }
+    private:
+        int32_t m_Step{1};
+    };
+
     TEST_CASE("Strategy - Reference Semantics - Unit Tests")
     {
         SECTION("IntValue Operations")
@@ -186,13 +396,74 @@ namespace ReferenceSemantics
             value->Operation();
             REQUIRE(floatValue.GetValue() == 0.0f);
         }
+
+        SECTION("Shared Operation Strategy")
+        {
+            const SharedOperationStrategy<IntValue> incrementOperationStrategy{
+                GetSharedOperationStrategy<IncrementIntValueOperationStrategy>()};
+            REQUIRE(incrementOperationStrategy == GetSharedOperationStrategy<IncrementIntValueOperationStrategy>());
+            REQUIRE(incrementOperationStrategy != GetSharedOperationStrategy<DecrementIntValueOperationStrategy>());
+            static_assert(sizeof(SharedOperationStrategy<IntValue>) == sizeof(void*));
+            static_assert(sizeof(IntValue) == sizeof(void*) + sizeof(std::unique_ptr<IntValue::OperationStrategy>) +
+                std::max(sizeof(int32_t), alignof(IntValue)));
+            static_assert(!std::is_constructible_v<SharedOperationStrategy<IntValue>, IntValue::OperationStrategy&>);
+
+            IntValue firstIntValue{0, incrementOperationStrategy};
+            IntValue secondIntValue{10, incrementOperationStrategy};
+            firstIntValue.Operation();
+            secondIntValue.Operation();
+            REQUIRE(firstIntValue.GetValue() == 1);
+            REQUIRE(secondIntValue.GetValue() == 11);
+
+            firstIntValue.SetOperationStrategy(GetSharedOperationStrategy<DecrementIntValueOperationStrategy>());
+            firstIntValue.Operation();
+            REQUIRE(firstIntValue.GetValue() == 0);
+
+            // Strategies that are not registered, e.g. stateful ones, are owned by the value
+            secondIntValue.SetOperationStrategy(std::make_unique<StepIntValueOperationStrategy>(-5));
+            secondIntValue.Operation();
+            REQUIRE(secondIntValue.GetValue() == 6);
+
+            std::unique_ptr<Value> randomValue{CreateRandomFlyweightValue()};
+            randomValue->Operation();
+        }
+
+        SECTION("Arena Allocation")
+        {
+            std::array<std::byte, 1024> buffer{};
+            std::pmr::monotonic_buffer_resource memoryResource{
+                buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+            Arena::UniquePtr<IntValue> intValue{Arena::MakeUnique<IntValue>(memoryResource,
+                0, Arena::MakeUnique<IncrementIntValueOperationStrategy>(memoryResource))};
+            REQUIRE(intValue.GetOwnership() == Arena::Ownership::Arena);
+
+            Value* const value{intValue.get()};
+            value->Operation();
+            REQUIRE(intValue->GetValue() == 1);
+
+            intValue->SetOperationStrategy(std::make_unique<DecrementIntValueOperationStrategy>());
+            value->Operation();
+            REQUIRE(intValue->GetValue() == 0);
+
+            const Arena::UniquePtr<Value> randomValue{CreateRandomValue(memoryResource)};
+            const std::byte* const address{reinterpret_cast<const std::byte*>(randomValue.get())};
+            REQUIRE(address >= buffer.data());
+            REQUIRE(address < buffer.data() + buffer.size());
+        }
     }
 
     TEST_CASE("Strategy - Reference Semantics - Benchmark")
     {
-        BENCHMARK("Benchmark")
+        constexpr uint32_t valueCount{50'000};
+        constexpr size_t arenaSize{valueCount * (sizeof(FloatValue) + sizeof(IncrementFloatValueOperationStrategy))};
+
+        // Allocations per run, printed with STRATEGY_PATTERN_TRACK_ALLOCATIONS
+        AllocationTracking::BenchmarkReport allocations{};
+
+        BENCHMARK("Construction")
         {
-            constexpr uint32_t valueCount{50'000};
+            const auto run{allocations.Track("Construction")};
             std::vector<std::unique_ptr<Value>> values{};
             values.reserve(valueCount);
 
@@ -201,10 +472,100 @@ namespace ReferenceSemantics
                 values.push_back(CreateRandomValue());
             }
 
-            for(const std::unique_ptr<Value>& value: values)
+            return values.size();
+        };
+
+        BENCHMARK("Flyweight Construction")
+        {
+            const auto run{allocations.Track("Flyweight Construction")};
+            std::vector<std::unique_ptr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
             {
-                value->Operation();
+                values.push_back(CreateRandomFlyweightValue());
             }
+
+            return values.size();
+        };
+
+        BENCHMARK("Arena Construction")
+        {
+            const auto run{allocations.Track("Arena Construction")};
+            std::pmr::monotonic_buffer_resource memoryResource{arenaSize};
+            std::vector<Arena::UniquePtr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue(memoryResource));
+            }
+
+            return values.size();
+        };
+
+        BENCHMARK_ADVANCED("Operation")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue());
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("Operation")};
+                    for(const std::unique_ptr<Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("Flyweight Operation")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomFlyweightValue());
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("Flyweight Operation")};
+                    for(const std::unique_ptr<Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("Arena Operation")(Catch::Benchmark::Chronometer meter)
+        {
+            std::pmr::monotonic_buffer_resource memoryResource{arenaSize};
+            std::vector<Arena::UniquePtr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue(memoryResource));
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("Arena Operation")};
+                    for(const Arena::UniquePtr<Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
         };
     }
 }
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+
+// Seedable counter-based random number generation.
+// Value n of a stream is a pure function of (seed, stream, n) (SplitMix64 finalizer applied to a Weyl sequence),
+// so any position can be reached in O(1) with Seek() and batches are filled without a dependency between
+// elements, which lets the compiler vectorize the fill loops.
+// A Generator holds no shared state, every thread uses its own, e.g. one stream per worker, or one stream
+// seeked to the first element of each worker's range so the result does not depend on the thread count.
+namespace Rng
+{
+    constexpr uint64_t DefaultSeed{0x5EED'1234'ABCD'0001};
+
+    constexpr uint64_t Mix(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xBF58'476D'1CE4'E5B9;
+        value = (value ^ (value >> 27)) * 0x94D0'49BB'1331'11EB;
+        return value ^ (value >> 31);
+    }
+
+    class Generator
+    {
+    public:
+        using result_type = uint64_t;
+
+        explicit constexpr Generator(const uint64_t seed = DefaultSeed, const uint64_t stream = 0)
+            : m_Key{Mix(seed) ^ Mix(stream + Increment)}
+        {
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        // Value at counter without advancing the generator
+        constexpr uint64_t At(const uint64_t counter) const
+        {
+            return Mix(m_Key + (counter + 1) * Increment);
+        }
+
+        constexpr uint64_t operator()()
+        {
+            m_BitCount = 0;
+            return At(m_Counter++);
+        }
+
+        // Consumes one bit, 64 booleans per generated value
+        constexpr bool NextBool()
+        {
+            if(m_BitCount == 0)
+            {
+                m_Bits = At(m_Counter++);
+                m_BitCount = 64;
+            }
+
+            const bool value{(m_Bits & 1) != 0};
+            m_Bits >>= 1;
+            --m_BitCount;
+            return value;
+        }
+
+        // Continues at bit bitIndex of the NextBool() sequence
+        constexpr void SeekBool(const uint64_t bitIndex)
+        {
+            m_Counter = bitIndex / 64;
+            m_BitCount = 0;
+            if(const uint32_t offset{static_cast<uint32_t>(bitIndex % 64)}; offset != 0)
+            {
+                m_Bits = At(m_Counter++) >> offset;
+                m_BitCount = 64 - offset;
+            }
+        }
+
+        constexpr void Seek(const uint64_t counter)
+        {
+            m_Counter = counter;
+            m_BitCount = 0;
+        }
+
+        // Same booleans as calling NextBool() values.size() times
+        void FillBools(const std::span<bool> values)
+        {
+            size_t i{0};
+            for(; i != values.size() && m_BitCount != 0; ++i)
+            {
+                values[i] = NextBool();
+            }
+
+            const size_t wordCount{(values.size() - i) / 64};
+            for(size_t word{0}; word != wordCount; ++word)
+            {
+                const uint64_t bits{At(m_Counter + word)};
+                for(uint32_t bit{0}; bit != 64; ++bit)
+                {
+                    values[i + word * 64 + bit] = ((bits >> bit) & 1) != 0;
+                }
+            }
+
+            m_Counter += wordCount;
+            for(i += wordCount * 64; i != values.size(); ++i)
+            {
+                values[i] = NextBool();
+            }
+        }
+
+        // Uniform indices in [0, typeCount), one generated value per index (multiply-shift on the top 32 bits)
+        void FillTypeIndices(const std::span<uint8_t> typeIndices, const uint32_t typeCount)
+        {
+            for(size_t i{0}; i != typeIndices.size(); ++i)
+            {
+                typeIndices[i] = static_cast<uint8_t>(((At(m_Counter + i) >> 32) * typeCount) >> 32);
+            }
+
+            m_Counter += typeIndices.size();
+            m_BitCount = 0;
+        }
+    private:
+        // Golden ratio, odd so the Weyl sequence visits every 64-bit value
+        static constexpr uint64_t Increment{0x9E37'79B9'7F4A'7C15};
+
+        uint64_t m_Key{0};
+        uint64_t m_Counter{0};
+        uint64_t m_Bits{0};
+        uint32_t m_BitCount{0};
+    };
+}
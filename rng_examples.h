@@ -0,0 +1,174 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random/random.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <typeinfo>
+#include <vector>
+
+#include "rng.h"
+#include "strategycollection_examples.h"
+#include "template_examples.h"
+#include "variantsemantics_examples.h"
+
+namespace Rng
+{
+    TEST_CASE("Strategy - Rng - Unit Tests")
+    {
+        SECTION("Determinism")
+        {
+            Generator first{42};
+            Generator second{42};
+            Generator otherSeed{43};
+            Generator otherStream{42, 1};
+
+            bool isSameSequence{true};
+            bool isOtherSeedDifferent{false};
+            bool isOtherStreamDifferent{false};
+            for(uint64_t i{0}; i != 1'000; ++i)
+            {
+                const uint64_t value{first()};
+                isSameSequence &= value == second() && value == first.At(i);
+                isOtherSeedDifferent |= value != otherSeed();
+                isOtherStreamDifferent |= value != otherStream();
+            }
+
+            REQUIRE(isSameSequence);
+            REQUIRE(isOtherSeedDifferent);
+            REQUIRE(isOtherStreamDifferent);
+        }
+
+        SECTION("Booleans")
+        {
+            Generator generator{};
+            std::array<bool, 1'000> expected{};
+            for(bool& value: expected)
+            {
+                value = generator.NextBool();
+            }
+
+            REQUIRE(std::ranges::count(expected, true) > 400);
+            REQUIRE(std::ranges::count(expected, true) < 600);
+
+            // Batch fill from an unaligned position
+            std::array<bool, 900> values{};
+            generator.SeekBool(100);
+            generator.FillBools(values);
+            REQUIRE(std::ranges::equal(values, std::span{expected}.subspan(100)));
+
+            for(const uint64_t bitIndex: {0, 1, 63, 64, 65, 999})
+            {
+                generator.SeekBool(bitIndex);
+                REQUIRE(generator.NextBool() == expected[bitIndex]);
+            }
+        }
+
+        SECTION("Type Indices")
+        {
+            Generator generator{};
+            std::array<uint8_t, 10'000> typeIndices{};
+            generator.FillTypeIndices(typeIndices, 3);
+
+            std::array<uint32_t, 3> counts{};
+            bool isEveryIndexInRange{true};
+            for(const uint8_t typeIndex: typeIndices)
+            {
+                isEveryIndexInRange &= typeIndex < 3;
+                ++counts[std::min<uint8_t>(typeIndex, 2)];
+            }
+
+            REQUIRE(isEveryIndexInRange);
+            REQUIRE(std::ranges::all_of(counts, [](const uint32_t count){ return count > 3'000 && count < 3'700; }));
+        }
+
+        SECTION("Repeatable Values")
+        {
+            Generator first{7};
+            Generator second{7};
+
+            bool isSameType{true};
+            for(uint32_t i{0}; i != 100; ++i)
+            {
+                const std::unique_ptr<Template::Value> firstValue{Template::CreateRandomValue(first)};
+                const std::unique_ptr<Template::Value> secondValue{Template::CreateRandomValue(second)};
+                isSameType &= typeid(*firstValue) == typeid(*secondValue);
+            }
+
+            REQUIRE(isSameType);
+
+            const VariantSemantics::Value variantValue{VariantSemantics::CreateRandomValue(first)};
+            REQUIRE(variantValue.index() == VariantSemantics::CreateRandomValue(second).index());
+
+            Template::ValueCollection firstCollection{};
+            Template::ValueCollection secondCollection{};
+            for(uint32_t i{0}; i != 100; ++i)
+            {
+                Template::AddRandomValue(firstCollection, first);
+                Template::AddRandomValue(secondCollection, second);
+            }
+
+            REQUIRE(firstCollection.GetPartition<Template::IntValue<Template::IncrementIntValueOperationStrategy>>()
+                .GetSize() == secondCollection.GetPartition<
+                    Template::IntValue<Template::IncrementIntValueOperationStrategy>>().GetSize());
+        }
+    }
+
+    TEST_CASE("Strategy - Rng - Benchmark")
+    {
+        constexpr uint32_t valueCount{1'000'000};
+        std::unique_ptr<bool[]> boolArray{std::make_unique<bool[]>(valueCount)};
+        Generator generator{};
+
+        BENCHMARK("Random::RandomBool")
+        {
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                boolArray[i] = Random::RandomBool();
+            }
+        };
+
+        BENCHMARK("Generator::NextBool")
+        {
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                boolArray[i] = generator.NextBool();
+            }
+        };
+
+        BENCHMARK("Generator::FillBools")
+        {
+            generator.FillBools({boolArray.get(), valueCount});
+        };
+
+        constexpr uint32_t createCount{50'000};
+        BENCHMARK("Template::CreateRandomValue()")
+        {
+            std::vector<std::unique_ptr<Template::Value>> values{};
+            values.reserve(createCount);
+
+            for(uint32_t i{0}; i != createCount; ++i)
+            {
+                values.push_back(Template::CreateRandomValue());
+            }
+
+            return values.size();
+        };
+
+        BENCHMARK("Template::CreateRandomValue(Generator&)")
+        {
+            std::vector<std::unique_ptr<Template::Value>> values{};
+            values.reserve(createCount);
+
+            for(uint32_t i{0}; i != createCount; ++i)
+            {
+                values.push_back(Template::CreateRandomValue(generator));
+            }
+
+            return values.size();
+        };
+    }
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define SIMD_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    #define SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+// MSVC allows intrinsics of any instruction set in any function, GCC/Clang need the target enabled per function.
+#if defined(SIMD_X86) && !defined(_MSC_VER)
+    #define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+    #define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define SIMD_TARGET_SSE2
+    #define SIMD_TARGET_AVX2
+#endif
+
+namespace Simd
+{
+    enum class InstructionSet : uint8_t
+    {
+        Scalar,
+        Sse2,
+        Avx2,
+        Neon
+    };
+
+    namespace Detail
+    {
+        template<typename T>
+        void AddScalar(const std::span<T> values, const T amount)
+        {
+            for(T& value: values)
+            {
+                value += amount;
+            }
+        }
+
+#if defined(SIMD_X86)
+        SIMD_TARGET_SSE2 inline void AddSse2(const std::span<int32_t> values, const int32_t amount)
+        {
+            const __m128i amounts{_mm_set1_epi32(amount)};
+            size_t i{0};
+            for(; i + 4 <= values.size(); i += 4)
+            {
+                __m128i* const address{reinterpret_cast<__m128i*>(values.data() + i)};
+                _mm_storeu_si128(address, _mm_add_epi32(_mm_loadu_si128(address), amounts));
+            }
+
+            AddScalar(values.subspan(i), amount);
+        }
+
+        SIMD_TARGET_SSE2 inline void AddSse2(const std::span<float_t> values, const float_t amount)
+        {
+            const __m128 amounts{_mm_set1_ps(amount)};
+            size_t i{0};
+            for(; i + 4 <= values.size(); i += 4)
+            {
+                float_t* const address{values.data() + i};
+                _mm_storeu_ps(address, _mm_add_ps(_mm_loadu_ps(address), amounts));
+            }
+
+            AddScalar(values.subspan(i), amount);
+        }
+
+        SIMD_TARGET_AVX2 inline void AddAvx2(const std::span<int32_t> values, const int32_t amount)
+        {
+            const __m256i amounts{_mm256_set1_epi32(amount)};
+            size_t i{0};
+            for(; i + 8 <= values.size(); i += 8)
+            {
+                __m256i* const address{reinterpret_cast<__m256i*>(values.data() + i)};
+                _mm256_storeu_si256(address, _mm256_add_epi32(_mm256_loadu_si256(address), amounts));
+            }
+
+            AddScalar(values.subspan(i), amount);
+        }
+
+        SIMD_TARGET_AVX2 inline void AddAvx2(const std::span<float_t> values, const float_t amount)
+        {
+            const __m256 amounts{_mm256_set1_ps(amount)};
+            size_t i{0};
+            for(; i + 8 <= values.size(); i += 8)
+            {
+                float_t* const address{values.data() + i};
+                _mm256_storeu_ps(address, _mm256_add_ps(_mm256_loadu_ps(address), amounts));
+            }
+
+            AddScalar(values.subspan(i), amount);
+        }
+#endif
+
+#if defined(SIMD_NEON)
+        inline void AddNeon(const std::span<int32_t> values, const int32_t amount)
+        {
+            const int32x4_t amounts{vdupq_n_s32(amount)};
+            size_t i{0};
+            for(; i + 4 <= values.size(); i += 4)
+            {
+                int32_t* const address{values.data() + i};
+                vst1q_s32(address, vaddq_s32(vld1q_s32(address), amounts));
+            }
+
+            AddScalar(values.subspan(i), amount);
+        }
+
+        inline void AddNeon(const std::span<float_t> values, const float_t amount)
+        {
+            const float32x4_t amounts{vdupq_n_f32(amount)};
+            size_t i{0};
+            for(; i + 4 <= values.size(); i += 4)
+            {
+                float_t* const address{values.data() + i};
+                vst1q_f32(address, vaddq_f32(vld1q_f32(address), amounts));
+            }
+
+            AddScalar(values.subspan(i), amount);
+        }
+#endif
+
+        inline InstructionSet DetectInstructionSet()
+        {
+#if defined(SIMD_X86)
+    #if defined(_MSC_VER)
+            int32_t registers[4]{};
+            __cpuid(registers, 0);
+            const int32_t functionCount{registers[0]};
+
+            __cpuid(registers, 1);
+            const bool hasSse2{(registers[3] & (1 << 26)) != 0};
+            const bool hasOsXSave{(registers[2] & (1 << 27)) != 0};
+            const bool hasAvx{(registers[2] & (1 << 28)) != 0};
+
+            bool hasAvx2{false};
+            if(functionCount >= 7 && hasOsXSave && hasAvx)
+            {
+                // The OS must save the YMM registers on a context switch
+                const bool osSavesYmm{(_xgetbv(0) & 0b110) == 0b110};
+                __cpuidex(registers, 7, 0);
+                hasAvx2 = osSavesYmm && (registers[1] & (1 << 5)) != 0;
+            }
+
+            if(hasAvx2)
+                return InstructionSet::Avx2;
+
+            if(hasSse2)
+                return InstructionSet::Sse2;
+    #else
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2"))
+                return InstructionSet::Avx2;
+
+            if(__builtin_cpu_supports("sse2"))
+                return InstructionSet::Sse2;
+    #endif
+#elif defined(SIMD_NEON)
+            return InstructionSet::Neon;
+#endif
+            return InstructionSet::Scalar;
+        }
+    }
+
+    // The best instruction set supported by the CPU, detected once on first use.
+    inline InstructionSet GetInstructionSet()
+    {
+        static const InstructionSet instructionSet{Detail::DetectInstructionSet()};
+        return instructionSet;
+    }
+
+    inline bool IsSupported(const InstructionSet instructionSet)
+    {
+        switch(instructionSet)
+        {
+        case InstructionSet::Scalar:
+            return true;
+        case InstructionSet::Sse2:
+            return GetInstructionSet() == InstructionSet::Sse2 || GetInstructionSet() == InstructionSet::Avx2;
+        case InstructionSet::Avx2:
+        case InstructionSet::Neon:
+            return GetInstructionSet() == instructionSet;
+        }
+
+        return false;
+    }
+
+    // Adds amount to every value using the given instruction set, which must be supported.
+    template<typename T>
+    void Add(const std::span<T> values, const T amount, const InstructionSet instructionSet)
+    {
+        switch(instructionSet)
+        {
+#if defined(SIMD_X86)
+        case InstructionSet::Avx2:
+            return Detail::AddAvx2(values, amount);
+        case InstructionSet::Sse2:
+            return Detail::AddSse2(values, amount);
+#elif defined(SIMD_NEON)
+        case InstructionSet::Neon:
+            return Detail::AddNeon(values, amount);
+#endif
+        default:
+            return Detail::AddScalar(values, amount);
+        }
+    }
+
+    template<typename T>
+    void Add(const std::span<T> values, const T amount)
+    {
+        Add(values, amount, GetInstructionSet());
+    }
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "simd.h"
+#include "strategycollection_examples.h"
+#include "template_examples.h"
+
+namespace Simd
+{
+    constexpr InstructionSet InstructionSets[]{
+        InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2, InstructionSet::Neon};
+
+    std::string GetName(const InstructionSet instructionSet)
+    {
+        switch(instructionSet)
+        {
+        case InstructionSet::Scalar:
+            return "Scalar";
+        case InstructionSet::Sse2:
+            return "SSE2";
+        case InstructionSet::Avx2:
+            return "AVX2";
+        case InstructionSet::Neon:
+            return "NEON";
+        }
+
+        return "Unknown";
+    }
+
+    void RunBenchmarks(const uint32_t valueCount, const bool includeTemplate)
+    {
+        const std::string suffix{" - " + std::to_string(valueCount)};
+
+        if(includeTemplate)
+        {
+            BENCHMARK_ADVANCED("Template" + suffix)(Catch::Benchmark::Chronometer meter)
+            {
+                std::vector<std::unique_ptr<Template::Value>> values{};
+                values.reserve(valueCount);
+
+                for(uint32_t i{0}; i != valueCount; ++i)
+                {
+                    values.push_back(Template::CreateRandomValue());
+                }
+
+                meter.measure(
+                    [&values]()
+                    {
+                        for(const std::unique_ptr<Template::Value>& value: values)
+                        {
+                            value->Operation();
+                        }
+                    });
+            };
+        }
+
+        BENCHMARK_ADVANCED("Strategy Collection" + suffix)(Catch::Benchmark::Chronometer meter)
+        {
+            Template::ValueCollection collection{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                Template::AddRandomValue(collection);
+            }
+
+            meter.measure(
+                [&collection]()
+                {
+                    collection.Operation();
+                });
+        };
+
+        for(const InstructionSet instructionSet: InstructionSets)
+        {
+            if(!IsSupported(instructionSet))
+                continue;
+
+            BENCHMARK_ADVANCED(GetName(instructionSet) + suffix)(Catch::Benchmark::Chronometer meter)
+            {
+                std::vector<int32_t> values(valueCount, 0);
+
+                meter.measure(
+                    [&values, instructionSet]()
+                    {
+                        Add(std::span<int32_t>{values}, 1, instructionSet);
+                    });
+            };
+        }
+    }
+
+    TEST_CASE("Strategy - SIMD - Unit Tests")
+    {
+        SECTION("IntValue Add")
+        {
+            for(const InstructionSet instructionSet: InstructionSets)
+            {
+                if(!IsSupported(instructionSet))
+                    continue;
+
+                // Not a multiple of the vector width, so the scalar tail is tested too
+                std::vector<int32_t> values(37, 0);
+                Add(std::span<int32_t>{values}, 2, instructionSet);
+                Add(std::span<int32_t>{values}, -1, instructionSet);
+                REQUIRE(std::ranges::all_of(values, [](const int32_t value){ return value == 1; }));
+            }
+        }
+
+        SECTION("FloatValue Add")
+        {
+            for(const InstructionSet instructionSet: InstructionSets)
+            {
+                if(!IsSupported(instructionSet))
+                    continue;
+
+                std::vector<float_t> values(37, 0.0f);
+                Add(std::span<float_t>{values}, 2.0f, instructionSet);
+                Add(std::span<float_t>{values}, -1.0f, instructionSet);
+                REQUIRE(std::ranges::all_of(values, [](const float_t value){ return value == 1.0f; }));
+            }
+        }
+
+        SECTION("Batch Operation Strategy")
+        {
+            std::vector<int32_t> intValues(19, 0);
+            Template::IncrementIntValueOperationStrategy{}(std::span<int32_t>{intValues});
+            Template::IncrementIntValueOperationStrategy{}(std::span<int32_t>{intValues});
+            Template::DecrementIntValueOperationStrategy{}(std::span<int32_t>{intValues});
+            REQUIRE(std::ranges::all_of(intValues, [](const int32_t value){ return value == 1; }));
+
+            std::vector<float_t> floatValues(19, 0.0f);
+            Template::DecrementFloatValueOperationStrategy{}(std::span<float_t>{floatValues});
+            REQUIRE(std::ranges::all_of(floatValues, [](const float_t value){ return value == -1.0f; }));
+        }
+    }
+
+    TEST_CASE("Strategy - SIMD - Benchmark")
+    {
+        RunBenchmarks(50'000, true);
+        RunBenchmarks(1'000'000, true);
+    }
+
+    // 100 million heap allocated Template values do not fit in memory on most machines,
+    // so only the batch implementations are compared at this size.
+    TEST_CASE("Strategy - SIMD - Large Benchmark", "[.][large]")
+    {
+        RunBenchmarks(100'000'000, false);
+    }
+}
@@ -0,0 +1,373 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+    #define SNAPSHOT_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+    #define SNAPSHOT_POSIX
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #if defined(__linux__)
+        #include <linux/magic.h>
+        #include <sys/vfs.h>
+    #endif
+#endif
+
+// Binary snapshot of a value population, loaded without copying by mapping the file.
+// Layout: a Header, a table of BlockCount Blocks, then one Structure of Arrays block per strategy type holding
+// the int32_t/float_t payloads, every block aligned to BlockAlignment. Strategies are stored as StrategyId, so
+// a snapshot holds no pointers and does not depend on the address space of the process that wrote it.
+// Files use the byte order of the writing machine, a snapshot with a different byte order is rejected.
+// The mapping is private (copy on write), engines can modify the mapped payloads, the file is never changed.
+namespace Snapshot
+{
+    enum class StrategyId : uint8_t
+    {
+        IncrementInt,
+        DecrementInt,
+        IncrementFloat,
+        DecrementFloat,
+        Count
+    };
+
+    enum class PayloadType : uint8_t
+    {
+        Int32,
+        Float32
+    };
+
+    constexpr PayloadType GetPayloadType(const StrategyId strategyId)
+    {
+        return strategyId == StrategyId::IncrementInt || strategyId == StrategyId::DecrementInt ?
+            PayloadType::Int32 : PayloadType::Float32;
+    }
+
+    template<typename TPayload>
+    constexpr PayloadType PayloadTypeOf{std::is_same_v<TPayload, float_t> ? PayloadType::Float32 : PayloadType::Int32};
+
+    constexpr std::array<char, 8> Magic{'S', 'T', 'R', 'A', 'T', 'S', 'N', 'P'};
+    constexpr uint32_t Version{1};
+    constexpr uint32_t ByteOrderMark{0x0102'0304};
+    // Cache line, and a multiple of every payload alignment
+    constexpr uint64_t BlockAlignment{64};
+
+    struct Header
+    {
+        std::array<char, 8> m_Magic{Magic};
+        uint32_t m_Version{Version};
+        uint32_t m_ByteOrderMark{ByteOrderMark};
+        uint64_t m_FileSize{0};
+        uint32_t m_BlockCount{0};
+        uint32_t m_Reserved{0};
+    };
+
+    struct Block
+    {
+        // Byte offset from the start of the file
+        uint64_t m_Offset{0};
+        uint64_t m_Count{0};
+        StrategyId m_StrategyId{StrategyId::Count};
+        PayloadType m_PayloadType{PayloadType::Int32};
+        std::array<uint8_t, 6> m_Reserved{};
+    };
+
+    static_assert(sizeof(Header) == 32 && sizeof(Block) == 24, "The file layout must not depend on the compiler");
+    static_assert(sizeof(int32_t) == 4 && sizeof(float_t) == 4);
+
+    // Read only file mapped copy on write
+    class MappedFile
+    {
+    public:
+        static std::optional<MappedFile> Open(const std::filesystem::path& path)
+        {
+#if defined(SNAPSHOT_POSIX)
+            const int fileDescriptor{open(path.c_str(), O_RDONLY)};
+            if(fileDescriptor == -1)
+                return std::nullopt;
+
+            struct stat status{};
+            void* data{MAP_FAILED};
+            if(fstat(fileDescriptor, &status) == 0 && status.st_size > 0)
+            {
+                data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                    fileDescriptor, 0);
+            }
+
+            // The mapping keeps its own reference to the file
+            close(fileDescriptor);
+            if(data == MAP_FAILED)
+                return std::nullopt;
+
+            return MappedFile{static_cast<std::byte*>(data), static_cast<size_t>(status.st_size)};
+#elif defined(SNAPSHOT_WINDOWS)
+            const HANDLE file{CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL, nullptr)};
+            if(file == INVALID_HANDLE_VALUE)
+                return std::nullopt;
+
+            LARGE_INTEGER fileSize{};
+            HANDLE mapping{nullptr};
+            if(GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+            {
+                mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            }
+
+            CloseHandle(file);
+            if(!mapping)
+                return std::nullopt;
+
+            void* const data{MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0)};
+            CloseHandle(mapping);
+            if(!data)
+                return std::nullopt;
+
+            return MappedFile{static_cast<std::byte*>(data), static_cast<size_t>(fileSize.QuadPart)};
+#else
+            (void)path;
+            return std::nullopt;
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+            : m_Data{std::exchange(other.m_Data, nullptr)}
+            , m_Size{std::exchange(other.m_Size, 0)}
+        {
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if(this != &other)
+            {
+                Unmap();
+                m_Data = std::exchange(other.m_Data, nullptr);
+                m_Size = std::exchange(other.m_Size, 0);
+            }
+
+            return *this;
+        }
+
+        ~MappedFile()
+        {
+            Unmap();
+        }
+
+        std::span<std::byte> GetData() const { return {m_Data, m_Size}; }
+    private:
+        MappedFile(std::byte* const data, const size_t size)
+            : m_Data{data}
+            , m_Size{size}
+        {
+        }
+
+        void Unmap()
+        {
+            if(!m_Data)
+                return;
+
+#if defined(SNAPSHOT_POSIX)
+            munmap(m_Data, m_Size);
+#elif defined(SNAPSHOT_WINDOWS)
+            UnmapViewOfFile(m_Data);
+#endif
+            m_Data = nullptr;
+        }
+
+        std::byte* m_Data{nullptr};
+        size_t m_Size{0};
+    };
+
+    // Collects the payload blocks of a snapshot and writes the file
+    class Writer
+    {
+    public:
+        template<typename TPayload>
+        void AddBlock(const StrategyId strategyId, const std::span<const TPayload> payloads)
+        {
+            static_assert(std::is_same_v<TPayload, int32_t> || std::is_same_v<TPayload, float_t>);
+
+            BlockData& block{m_Blocks.emplace_back()};
+            block.m_StrategyId = strategyId;
+            block.m_PayloadType = PayloadTypeOf<TPayload>;
+            block.m_Count = payloads.size();
+            block.m_Bytes.resize(payloads.size_bytes());
+            if(!payloads.empty())
+                std::memcpy(block.m_Bytes.data(), payloads.data(), payloads.size_bytes());
+        }
+
+        bool Write(const std::filesystem::path& path) const
+        {
+            Header header{};
+            header.m_BlockCount = static_cast<uint32_t>(m_Blocks.size());
+
+            std::vector<Block> blocks(m_Blocks.size());
+            uint64_t offset{AlignUp(sizeof(Header) + blocks.size() * sizeof(Block))};
+            for(size_t i{0}; i != m_Blocks.size(); ++i)
+            {
+                blocks[i].m_Offset = offset;
+                blocks[i].m_Count = m_Blocks[i].m_Count;
+                blocks[i].m_StrategyId = m_Blocks[i].m_StrategyId;
+                blocks[i].m_PayloadType = m_Blocks[i].m_PayloadType;
+                offset = AlignUp(offset + m_Blocks[i].m_Bytes.size());
+            }
+
+            header.m_FileSize = offset;
+
+            std::ofstream file{path, std::ios::binary | std::ios::trunc};
+            if(!file)
+                return false;
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(blocks.data()),
+                static_cast<std::streamsize>(blocks.size() * sizeof(Block)));
+            for(size_t i{0}; i != m_Blocks.size(); ++i)
+            {
+                Pad(file, blocks[i].m_Offset);
+                file.write(reinterpret_cast<const char*>(m_Blocks[i].m_Bytes.data()),
+                    static_cast<std::streamsize>(m_Blocks[i].m_Bytes.size()));
+            }
+
+            Pad(file, header.m_FileSize);
+            return static_cast<bool>(file.flush());
+        }
+    private:
+        struct BlockData
+        {
+            StrategyId m_StrategyId{StrategyId::Count};
+            PayloadType m_PayloadType{PayloadType::Int32};
+            uint64_t m_Count{0};
+            std::vector<std::byte> m_Bytes{};
+        };
+
+        static uint64_t AlignUp(const uint64_t offset)
+        {
+            return (offset + BlockAlignment - 1) / BlockAlignment * BlockAlignment;
+        }
+
+        static void Pad(std::ofstream& file, const uint64_t offset)
+        {
+            constexpr std::array<char, BlockAlignment> zeros{};
+            const uint64_t position{static_cast<uint64_t>(file.tellp())};
+            file.write(zeros.data(), static_cast<std::streamsize>(offset - position));
+        }
+
+        std::vector<BlockData> m_Blocks{};
+    };
+
+    // A validated mapped snapshot, the payload spans point into the mapped pages
+    class View
+    {
+    public:
+        // std::nullopt if the file cannot be mapped or is not a valid snapshot
+        static std::optional<View> Open(const std::filesystem::path& path)
+        {
+            std::optional<MappedFile> mappedFile{MappedFile::Open(path)};
+            if(!mappedFile)
+                return std::nullopt;
+
+            const std::span<std::byte> data{mappedFile->GetData()};
+            if(data.size() < sizeof(Header))
+                return std::nullopt;
+
+            Header header{};
+            std::memcpy(&header, data.data(), sizeof(header));
+            if(header.m_Magic != Magic || header.m_Version != Version || header.m_ByteOrderMark != ByteOrderMark ||
+                header.m_FileSize != data.size() ||
+                header.m_BlockCount > (data.size() - sizeof(Header)) / sizeof(Block))
+            {
+                return std::nullopt;
+            }
+
+            std::vector<Block> blocks(header.m_BlockCount);
+            std::memcpy(blocks.data(), data.data() + sizeof(Header), blocks.size() * sizeof(Block));
+            for(const Block& block: blocks)
+            {
+                if(block.m_StrategyId >= StrategyId::Count ||
+                    block.m_PayloadType != GetPayloadType(block.m_StrategyId) ||
+                    block.m_Offset % BlockAlignment != 0 || block.m_Offset > data.size() ||
+                    block.m_Count > (data.size() - block.m_Offset) / sizeof(uint32_t))
+                {
+                    return std::nullopt;
+                }
+            }
+
+            return View{std::move(*mappedFile), std::move(blocks)};
+        }
+
+        std::span<const Block> GetBlocks() const { return m_Blocks; }
+
+        template<typename TPayload>
+        std::span<TPayload> GetPayloads(const Block& block) const
+        {
+            static_assert(std::is_same_v<TPayload, int32_t> || std::is_same_v<TPayload, float_t>);
+            if(block.m_PayloadType != PayloadTypeOf<TPayload>)
+                return {};
+
+            // Aligned by construction, the mapping starts at a page boundary
+            return {reinterpret_cast<TPayload*>(m_MappedFile.GetData().data() + block.m_Offset),
+                static_cast<size_t>(block.m_Count)};
+        }
+
+        size_t GetFileSize() const { return m_MappedFile.GetData().size(); }
+    private:
+        View(MappedFile&& mappedFile, std::vector<Block>&& blocks)
+            : m_MappedFile{std::move(mappedFile)}
+            , m_Blocks{std::move(blocks)}
+        {
+        }
+
+        MappedFile m_MappedFile;
+        std::vector<Block> m_Blocks{};
+    };
+
+    // Drops the cached pages of path so the next load reads from the device, returns false if unsupported.
+    // Files on tmpfs/ramfs only live in the page cache, posix_fadvise() succeeds there without evicting anything.
+    inline bool EvictFromPageCache(const std::filesystem::path& path)
+    {
+#if defined(SNAPSHOT_POSIX) && defined(POSIX_FADV_DONTNEED)
+        const int fileDescriptor{open(path.c_str(), O_RDONLY)};
+        if(fileDescriptor == -1)
+            return false;
+
+    #if defined(__linux__)
+        struct statfs fileSystem{};
+        if(fstatfs(fileDescriptor, &fileSystem) != 0 ||
+            fileSystem.f_type == TMPFS_MAGIC || fileSystem.f_type == RAMFS_MAGIC)
+        {
+            close(fileDescriptor);
+            return false;
+        }
+    #endif
+
+        const bool isEvicted{fdatasync(fileDescriptor) == 0 &&
+            posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_DONTNEED) == 0};
+        close(fileDescriptor);
+        return isEvicted;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+}
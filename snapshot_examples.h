@@ -0,0 +1,368 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rng.h"
+#include "snapshot.h"
+#include "strategycollection_examples.h"
+#include "template_examples.h"
+
+namespace Template
+{
+    template<typename TValue>
+    constexpr Snapshot::StrategyId StrategyIdOf{Snapshot::StrategyId::Count};
+
+    template<>
+    constexpr Snapshot::StrategyId StrategyIdOf<IntValue<IncrementIntValueOperationStrategy>>{
+        Snapshot::StrategyId::IncrementInt};
+
+    template<>
+    constexpr Snapshot::StrategyId StrategyIdOf<IntValue<DecrementIntValueOperationStrategy>>{
+        Snapshot::StrategyId::DecrementInt};
+
+    template<>
+    constexpr Snapshot::StrategyId StrategyIdOf<FloatValue<IncrementFloatValueOperationStrategy>>{
+        Snapshot::StrategyId::IncrementFloat};
+
+    template<>
+    constexpr Snapshot::StrategyId StrategyIdOf<FloatValue<DecrementFloatValueOperationStrategy>>{
+        Snapshot::StrategyId::DecrementFloat};
+
+    // Writes one block per partition of collection
+    template<typename... TValues>
+    bool SaveSnapshot(const StrategyCollection<TValues...>& collection, const std::filesystem::path& path)
+    {
+        static_assert(((StrategyIdOf<TValues> != Snapshot::StrategyId::Count) && ...),
+            "Every value type needs a StrategyId");
+
+        Snapshot::Writer writer{};
+        (writer.AddBlock(
+            StrategyIdOf<TValues>, collection.template GetPartition<TValues>().GetValues()), ...);
+        return writer.Write(path);
+    }
+
+    template<typename TValue, typename... TValues>
+    bool LoadBlock(StrategyCollection<TValues...>& collection, const Snapshot::View& view,
+        const Snapshot::Block& block)
+    {
+        if(block.m_StrategyId != StrategyIdOf<TValue>)
+            return false;
+
+        StrategyPartition<TValue>& partition{collection.template GetPartition<TValue>()};
+        const std::span<const typename TValue::ValueType> payloads{
+            view.template GetPayloads<typename TValue::ValueType>(block)};
+        partition.Reserve(partition.GetSize() + payloads.size());
+        for(const typename TValue::ValueType value: payloads)
+        {
+            partition.Add(value);
+        }
+
+        return true;
+    }
+
+    // Copies a snapshot into collection, the baseline for the zero-copy MappedStrategyCollection
+    template<typename... TValues>
+    bool LoadSnapshot(StrategyCollection<TValues...>& collection, const std::filesystem::path& path)
+    {
+        const std::optional<Snapshot::View> view{Snapshot::View::Open(path)};
+        if(!view)
+            return false;
+
+        for(const Snapshot::Block& block: view->GetBlocks())
+        {
+            const bool isKnown{(LoadBlock<TValues>(collection, *view, block) || ...)};
+            if(!isKnown)
+                return false;
+        }
+
+        return true;
+    }
+
+    // StrategyCollection operating in place on the mapped pages of a snapshot.
+    // Loading only validates the header and the block table, a page is read from the file when Operation()
+    // first touches it. Modified pages are private to the process.
+    template<typename... TValues>
+    class MappedStrategyCollection
+    {
+    public:
+        static std::optional<MappedStrategyCollection> Open(const std::filesystem::path& path)
+        {
+            std::optional<Snapshot::View> view{Snapshot::View::Open(path)};
+            if(!view)
+                return std::nullopt;
+
+            MappedStrategyCollection collection{std::move(*view)};
+            for(const Snapshot::Block& block: collection.m_View.GetBlocks())
+            {
+                const bool isKnown{(collection.template MapBlock<TValues>(block) || ...)};
+                if(!isKnown)
+                    return std::nullopt;
+            }
+
+            return collection;
+        }
+
+        void Operation()
+        {
+            (Operation<TValues>(), ...);
+        }
+
+        size_t GetSize() const
+        {
+            return (GetValues<TValues>().size() + ...);
+        }
+
+        template<typename TValue>
+        std::span<const typename TValue::ValueType> GetValues() const
+        {
+            return std::get<Partition<TValue>>(m_Partitions).m_Values;
+        }
+    private:
+        template<typename TValue>
+        struct Partition
+        {
+            typename TValue::OperationStrategy m_OperationStrategy{};
+            std::span<typename TValue::ValueType> m_Values{};
+        };
+
+        explicit MappedStrategyCollection(Snapshot::View&& view)
+            : m_View{std::move(view)}
+        {
+        }
+
+        // One block per value type, as written by SaveSnapshot
+        template<typename TValue>
+        bool MapBlock(const Snapshot::Block& block)
+        {
+            Partition<TValue>& partition{std::get<Partition<TValue>>(m_Partitions)};
+            if(block.m_StrategyId != StrategyIdOf<TValue> || !partition.m_Values.empty())
+                return false;
+
+            partition.m_Values = m_View.template GetPayloads<typename TValue::ValueType>(block);
+            return true;
+        }
+
+        template<typename TValue>
+        void Operation()
+        {
+            Partition<TValue>& partition{std::get<Partition<TValue>>(m_Partitions)};
+            using ValueType = typename TValue::ValueType;
+            if constexpr(std::is_invocable_v<typename TValue::OperationStrategy&, std::span<ValueType>>)
+            {
+                partition.m_OperationStrategy(partition.m_Values);
+            }
+            else
+            {
+                for(ValueType& value: partition.m_Values)
+                {
+                    partition.m_OperationStrategy(value);
+                }
+            }
+        }
+
+        Snapshot::View m_View;
+        std::tuple<Partition<TValues>...> m_Partitions{};
+    };
+
+    using MappedValueCollection = MappedStrategyCollection<
+        IntValue<IncrementIntValueOperationStrategy>,
+        IntValue<DecrementIntValueOperationStrategy>,
+        FloatValue<IncrementFloatValueOperationStrategy>,
+        FloatValue<DecrementFloatValueOperationStrategy>>;
+
+    std::filesystem::path GetSnapshotPath(
+        const std::string& name,
+        const std::filesystem::path& directory = std::filesystem::temp_directory_path())
+    {
+        return directory / ("strategy-pattern-" + name + ".snapshot");
+    }
+
+    // First of the temporary and the working directory where a copy of snapshotPath can be evicted from the
+    // page cache. The temporary directory is often tmpfs on Linux, which cannot be evicted.
+    std::optional<std::filesystem::path> FindEvictableDirectory(const std::filesystem::path& snapshotPath)
+    {
+        const std::array<std::filesystem::path, 2> directories{
+            std::filesystem::temp_directory_path(), std::filesystem::current_path()};
+        for(const std::filesystem::path& directory: directories)
+        {
+            const std::filesystem::path probePath{GetSnapshotPath("eviction-probe", directory)};
+            std::error_code error{};
+            std::filesystem::copy_file(
+                snapshotPath, probePath, std::filesystem::copy_options::overwrite_existing, error);
+            const bool isEvicted{!error && Snapshot::EvictFromPageCache(probePath)};
+            std::filesystem::remove(probePath, error);
+            if(isEvicted)
+                return directory;
+        }
+
+        return std::nullopt;
+    }
+
+    TEST_CASE("Strategy - Snapshot - Unit Tests")
+    {
+        ValueCollection collection{};
+        Rng::Generator generator{};
+        for(uint32_t i{0}; i != 1'000; ++i)
+        {
+            AddRandomValue(collection, generator);
+        }
+
+        collection.Operation();
+        const std::filesystem::path path{GetSnapshotPath("unittests")};
+        REQUIRE(SaveSnapshot(collection, path));
+
+        SECTION("Mapped payloads match the saved collection")
+        {
+            std::optional<MappedValueCollection> mappedCollection{MappedValueCollection::Open(path)};
+            REQUIRE(mappedCollection.has_value());
+            REQUIRE(mappedCollection->GetSize() == collection.GetSize());
+
+            mappedCollection->Operation();
+            collection.Operation();
+            const auto requireEqual{
+                [&]<typename TValue>(std::type_identity<TValue>)
+                {
+                    const auto expected{collection.GetPartition<TValue>().GetValues()};
+                    const auto actual{mappedCollection->GetValues<TValue>()};
+                    REQUIRE(std::equal(expected.begin(), expected.end(), actual.begin(), actual.end()));
+                }};
+
+            requireEqual(std::type_identity<IntValue<IncrementIntValueOperationStrategy>>{});
+            requireEqual(std::type_identity<IntValue<DecrementIntValueOperationStrategy>>{});
+            requireEqual(std::type_identity<FloatValue<IncrementFloatValueOperationStrategy>>{});
+            requireEqual(std::type_identity<FloatValue<DecrementFloatValueOperationStrategy>>{});
+        }
+
+        SECTION("Operations on the mapping do not modify the file")
+        {
+            {
+                std::optional<MappedValueCollection> mappedCollection{MappedValueCollection::Open(path)};
+                REQUIRE(mappedCollection.has_value());
+                mappedCollection->Operation();
+            }
+
+            ValueCollection loadedCollection{};
+            REQUIRE(LoadSnapshot(loadedCollection, path));
+            using IncrementIntValue = IntValue<IncrementIntValueOperationStrategy>;
+            const auto expected{collection.GetPartition<IncrementIntValue>().GetValues()};
+            const auto actual{loadedCollection.GetPartition<IncrementIntValue>().GetValues()};
+            REQUIRE(std::equal(expected.begin(), expected.end(), actual.begin(), actual.end()));
+        }
+
+        SECTION("Invalid snapshots are rejected")
+        {
+            REQUIRE_FALSE(MappedValueCollection::Open(GetSnapshotPath("missing")).has_value());
+
+            const std::uintmax_t fileSize{std::filesystem::file_size(path)};
+            std::filesystem::resize_file(path, fileSize - Snapshot::BlockAlignment);
+            REQUIRE_FALSE(MappedValueCollection::Open(path).has_value());
+
+            std::filesystem::resize_file(path, fileSize);
+            {
+                std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+                file.write("INVALID!", 8);
+            }
+
+            REQUIRE_FALSE(MappedValueCollection::Open(path).has_value());
+        }
+
+        SECTION("Blocks of unknown value types are rejected")
+        {
+            using IntCollection = MappedStrategyCollection<IntValue<IncrementIntValueOperationStrategy>>;
+            REQUIRE_FALSE(IntCollection::Open(path).has_value());
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE("Strategy - Snapshot - Benchmark")
+    {
+        constexpr uint32_t valueCount{1'000'000};
+        ValueCollection collection{};
+        Rng::Generator generator{};
+        for(uint32_t i{0}; i != valueCount; ++i)
+        {
+            AddRandomValue(collection, generator);
+        }
+
+        const std::filesystem::path path{GetSnapshotPath("benchmark")};
+        REQUIRE(SaveSnapshot(collection, path));
+
+        // Startup: from nothing to the first Operation() pass over every value
+        BENCHMARK("Startup Create")
+        {
+            ValueCollection createdCollection{};
+            Rng::Generator createGenerator{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                AddRandomValue(createdCollection, createGenerator);
+            }
+
+            createdCollection.Operation();
+            return createdCollection.GetSize();
+        };
+
+        BENCHMARK("Startup Copy Load (Warm Page Cache)")
+        {
+            ValueCollection loadedCollection{};
+            LoadSnapshot(loadedCollection, path);
+            loadedCollection.Operation();
+            return loadedCollection.GetSize();
+        };
+
+        BENCHMARK("Startup Mapped (Warm Page Cache)")
+        {
+            std::optional<MappedValueCollection> mappedCollection{MappedValueCollection::Open(path)};
+            mappedCollection->Operation();
+            return mappedCollection->GetSize();
+        };
+
+        // Every run maps its own copy, evicted up front, so only the first touch of each page is measured.
+        // Without eviction support (e.g. Windows, or tmpfs for both directories) this measures the warm page
+        // cache again, the name says so.
+        const std::optional<std::filesystem::path> coldDirectory{FindEvictableDirectory(path)};
+        BENCHMARK_ADVANCED(std::string{"Startup Mapped (Cold Page Cache)"} +
+            (coldDirectory ? "" : " (eviction unsupported)"))(
+            Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::filesystem::path> paths(static_cast<size_t>(meter.runs()));
+            for(size_t i{0}; i != paths.size(); ++i)
+            {
+                paths[i] = GetSnapshotPath("benchmark-cold-" + std::to_string(i),
+                    coldDirectory.value_or(std::filesystem::temp_directory_path()));
+                std::filesystem::copy_file(path, paths[i], std::filesystem::copy_options::overwrite_existing);
+                if(coldDirectory)
+                    REQUIRE(Snapshot::EvictFromPageCache(paths[i]));
+            }
+
+            meter.measure(
+                [&paths](const int run)
+                {
+                    std::optional<MappedValueCollection> mappedCollection{
+                        MappedValueCollection::Open(paths[run])};
+                    mappedCollection->Operation();
+                    return mappedCollection->GetSize();
+                });
+
+            for(const std::filesystem::path& coldPath: paths)
+            {
+                std::filesystem::remove(coldPath);
+            }
+        };
+
+        std::filesystem::remove(path);
+    }
+}
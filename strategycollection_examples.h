@@ -0,0 +1,277 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random/random.h>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "rng.h"
+#include "template_examples.h"
+
+namespace Template
+{
+    // Strategies with per-instance state declare it as a nested Parameters type and are applied with
+    // operator()(ValueType&, const Parameters&) or the batch form operator()(std::span<ValueType>,
+    // std::span<const Parameters>), so the strategy object itself stays stateless and shared.
+    template<typename TOperationStrategy>
+    concept ParameterizedStrategy = requires { typename TOperationStrategy::Parameters; };
+
+    template<typename TOperationStrategy>
+    struct StrategyParameters
+    {
+        struct Type{};
+    };
+
+    template<ParameterizedStrategy TOperationStrategy>
+    struct StrategyParameters<TOperationStrategy>
+    {
+        using Type = typename TOperationStrategy::Parameters;
+    };
+
+    // Stores the payload of every TValue (e.g. IntValue<IncrementIntValueOperationStrategy>) contiguously.
+    // The Strategy is known per partition, so it is applied in a tight loop without any virtual dispatch.
+    // Parameters of a ParameterizedStrategy are kept in a column parallel to the payloads.
+    template<typename TValue>
+    class StrategyPartition
+    {
+    public:
+        using OperationStrategy = typename TValue::OperationStrategy;
+        using ValueType = typename TValue::ValueType;
+        using Parameters = typename StrategyParameters<OperationStrategy>::Type;
+
+        static constexpr bool IsParameterized{ParameterizedStrategy<OperationStrategy>};
+
+        void Reserve(const size_t count)
+        {
+            m_Values.reserve(count);
+            if constexpr(IsParameterized)
+                m_Parameters.reserve(count);
+        }
+
+        // Values of a ParameterizedStrategy added without parameters get default constructed ones
+        void Add(const ValueType value)
+        {
+            Add(value, Parameters{});
+        }
+
+        void Add(const ValueType value, const Parameters& parameters)
+        {
+            m_Values.push_back(value);
+            if constexpr(IsParameterized)
+                m_Parameters.push_back(parameters);
+        }
+
+        // Keeps the capacity, so a reused partition does not allocate again
+        void Clear()
+        {
+            m_Values.clear();
+            if constexpr(IsParameterized)
+                m_Parameters.clear();
+        }
+
+        // Strategies can optionally provide a batch entry point, e.g. operator()(std::span<int32_t>),
+        // which is used instead of applying the Strategy to each value.
+        void Operation()
+        {
+            if constexpr(IsParameterized)
+            {
+                if constexpr(std::is_invocable_v<OperationStrategy&, std::span<ValueType>, std::span<const Parameters>>)
+                {
+                    m_OperationStrategy(std::span<ValueType>{m_Values}, std::span<const Parameters>{m_Parameters});
+                }
+                else
+                {
+                    for(size_t i{0}; i != m_Values.size(); ++i)
+                    {
+                        m_OperationStrategy(m_Values[i], m_Parameters[i]);
+                    }
+                }
+            }
+            else if constexpr(std::is_invocable_v<OperationStrategy&, std::span<ValueType>>)
+            {
+                m_OperationStrategy(std::span<ValueType>{m_Values});
+            }
+            else
+            {
+                for(ValueType& value: m_Values)
+                {
+                    m_OperationStrategy(value);
+                }
+            }
+        }
+
+        size_t GetSize() const { return m_Values.size(); }
+        std::span<const ValueType> GetValues() const { return m_Values; }
+
+        std::span<const Parameters> GetParameters() const requires IsParameterized { return m_Parameters; }
+        std::span<Parameters> GetParameters() requires IsParameterized { return m_Parameters; }
+    private:
+        // Stateless strategies pay neither for the column nor for its bookkeeping
+        struct NoParameters{};
+        using ParameterColumn = std::conditional_t<IsParameterized, std::vector<Parameters>, NoParameters>;
+
+        OperationStrategy m_OperationStrategy{};
+        std::vector<ValueType> m_Values{};
+        TEMPLATE_NO_UNIQUE_ADDRESS ParameterColumn m_Parameters{};
+    };
+
+    // A Type-partitioned (Structure of Arrays) collection of values.
+    // The mix of value types is fixed at compile time, dispatch happens once per partition instead of
+    // once per value.
+    template<typename... TValues>
+    class StrategyCollection
+    {
+    public:
+        template<typename TValue>
+        void Reserve(const size_t count)
+        {
+            GetPartition<TValue>().Reserve(count);
+        }
+
+        template<typename TValue>
+        void Add(const typename TValue::ValueType value)
+        {
+            GetPartition<TValue>().Add(value);
+        }
+
+        template<typename TValue>
+        void Add(const typename TValue::ValueType value,
+            const typename StrategyPartition<TValue>::Parameters& parameters)
+        {
+            GetPartition<TValue>().Add(value, parameters);
+        }
+
+        void Clear()
+        {
+            (std::get<StrategyPartition<TValues>>(m_Partitions).Clear(), ...);
+        }
+
+        void Operation()
+        {
+            (std::get<StrategyPartition<TValues>>(m_Partitions).Operation(), ...);
+        }
+
+        size_t GetSize() const
+        {
+            return (std::get<StrategyPartition<TValues>>(m_Partitions).GetSize() + ...);
+        }
+
+        template<typename TValue>
+        StrategyPartition<TValue>& GetPartition()
+        {
+            return std::get<StrategyPartition<TValue>>(m_Partitions);
+        }
+
+        template<typename TValue>
+        const StrategyPartition<TValue>& GetPartition() const
+        {
+            return std::get<StrategyPartition<TValue>>(m_Partitions);
+        }
+    private:
+        std::tuple<StrategyPartition<TValues>...> m_Partitions{};
+    };
+
+    using ValueCollection = StrategyCollection<
+        IntValue<IncrementIntValueOperationStrategy>,
+        IntValue<DecrementIntValueOperationStrategy>,
+        FloatValue<IncrementFloatValueOperationStrategy>,
+        FloatValue<DecrementFloatValueOperationStrategy>>;
+
+    void AddValue(ValueCollection& collection, const bool isIntValue, const bool isIncrement)
+    {
+        if(isIntValue)
+        {
+            if(isIncrement)
+                return collection.Add<IntValue<IncrementIntValueOperationStrategy>>(0);
+
+            return collection.Add<IntValue<DecrementIntValueOperationStrategy>>(0);
+        }
+
+        if(isIncrement)
+            return collection.Add<FloatValue<IncrementFloatValueOperationStrategy>>(0.0f);
+
+        return collection.Add<FloatValue<DecrementFloatValueOperationStrategy>>(0.0f);
+    }
+
+    void AddRandomValue(ValueCollection& collection)
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        AddValue(collection, isIntValue, isIncrement);
+    }
+
+    void AddRandomValue(ValueCollection& collection, Rng::Generator& generator)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        AddValue(collection, isIntValue, isIncrement);
+    }
+
+    TEST_CASE("Strategy - Strategy Collection - Unit Tests")
+    {
+        SECTION("IntValue Operations")
+        {
+            ValueCollection collection{};
+            collection.Add<IntValue<IncrementIntValueOperationStrategy>>(0);
+            collection.Add<IntValue<IncrementIntValueOperationStrategy>>(10);
+            collection.Add<IntValue<DecrementIntValueOperationStrategy>>(0);
+            REQUIRE(collection.GetSize() == 3);
+
+            collection.Operation();
+            collection.Operation();
+
+            const auto& increments{collection.GetPartition<IntValue<IncrementIntValueOperationStrategy>>()};
+            REQUIRE(increments.GetSize() == 2);
+            REQUIRE(increments.GetValues()[0] == 2);
+            REQUIRE(increments.GetValues()[1] == 12);
+
+            const auto& decrements{collection.GetPartition<IntValue<DecrementIntValueOperationStrategy>>()};
+            REQUIRE(decrements.GetSize() == 1);
+            REQUIRE(decrements.GetValues()[0] == -2);
+        }
+
+        SECTION("FloatValue Operations")
+        {
+            ValueCollection collection{};
+            collection.Add<FloatValue<IncrementFloatValueOperationStrategy>>(0.0f);
+            collection.Add<FloatValue<DecrementFloatValueOperationStrategy>>(0.0f);
+            collection.Add<FloatValue<DecrementFloatValueOperationStrategy>>(10.0f);
+            REQUIRE(collection.GetSize() == 3);
+
+            collection.Operation();
+            collection.Operation();
+
+            const auto& increments{collection.GetPartition<FloatValue<IncrementFloatValueOperationStrategy>>()};
+            REQUIRE(increments.GetSize() == 1);
+            REQUIRE(increments.GetValues()[0] == 2.0f);
+
+            const auto& decrements{collection.GetPartition<FloatValue<DecrementFloatValueOperationStrategy>>()};
+            REQUIRE(decrements.GetSize() == 2);
+            REQUIRE(decrements.GetValues()[0] == -2.0f);
+            REQUIRE(decrements.GetValues()[1] == 8.0f);
+        }
+    }
+
+    TEST_CASE("Strategy - Strategy Collection - Benchmark")
+    {
+        BENCHMARK("Benchmark")
+        {
+            constexpr uint32_t valueCount{50'000};
+            ValueCollection collection{};
+            collection.Reserve<IntValue<IncrementIntValueOperationStrategy>>(valueCount);
+            collection.Reserve<IntValue<DecrementIntValueOperationStrategy>>(valueCount);
+            collection.Reserve<FloatValue<IncrementFloatValueOperationStrategy>>(valueCount);
+            collection.Reserve<FloatValue<DecrementFloatValueOperationStrategy>>(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                AddRandomValue(collection);
+            }
+
+            collection.Operation();
+        };
+    }
+}
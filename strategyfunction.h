@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// A move-only, type-erased callable that always stores the callable inside of its own buffer.
+// Unlike std::function it never allocates, a callable that does not fit is a compile error.
+template<typename TSignature, size_t TBufferSize = 3 * sizeof(void*)>
+class StrategyFunction;
+
+template<typename TReturn, typename... TArgs, size_t TBufferSize>
+class StrategyFunction<TReturn(TArgs...), TBufferSize>
+{
+public:
+    static constexpr size_t BufferSize{TBufferSize};
+    static constexpr size_t BufferAlignment{alignof(void*)};
+
+    template<typename TCallable>
+    static constexpr bool CanStore{
+        sizeof(TCallable) <= BufferSize &&
+        alignof(TCallable) <= BufferAlignment &&
+        std::is_nothrow_move_constructible_v<TCallable>};
+
+    StrategyFunction() = default;
+
+    template<typename TCallable>
+        requires (!std::is_same_v<std::remove_cvref_t<TCallable>, StrategyFunction>) &&
+            std::is_invocable_r_v<TReturn, std::remove_cvref_t<TCallable>&, TArgs...>
+    StrategyFunction(TCallable&& callable)
+    {
+        using Callable = std::remove_cvref_t<TCallable>;
+        static_assert(sizeof(Callable) <= BufferSize, "Callable does not fit into the StrategyFunction buffer");
+        static_assert(alignof(Callable) <= BufferAlignment, "Callable is over aligned for the StrategyFunction buffer");
+        static_assert(std::is_nothrow_move_constructible_v<Callable>, "Callable must be nothrow move constructible");
+
+        ::new(static_cast<void*>(m_Buffer)) Callable(std::forward<TCallable>(callable));
+        m_VTable = &s_VTable<Callable>;
+    }
+
+    StrategyFunction(StrategyFunction&& other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    StrategyFunction& operator=(StrategyFunction&& other) noexcept
+    {
+        if(this != &other)
+        {
+            Reset();
+            MoveFrom(other);
+        }
+
+        return *this;
+    }
+
+    StrategyFunction(const StrategyFunction&) = delete;
+    StrategyFunction& operator=(const StrategyFunction&) = delete;
+
+    ~StrategyFunction()
+    {
+        Reset();
+    }
+
+    TReturn operator()(TArgs... args)
+    {
+        return m_VTable->m_Invoke(m_Buffer, std::forward<TArgs>(args)...);
+    }
+
+    explicit operator bool() const { return m_VTable != nullptr; }
+private:
+    struct VTable
+    {
+        TReturn(*m_Invoke)(void*, TArgs...);
+        void(*m_MoveConstruct)(void* destination, void* source) noexcept;
+        void(*m_Destroy)(void*) noexcept;
+    };
+
+    template<typename TCallable>
+    static constexpr VTable s_VTable{
+        [](void* callable, TArgs... args) -> TReturn
+        {
+            return (*static_cast<TCallable*>(callable))(std::forward<TArgs>(args)...);
+        },
+        [](void* destination, void* source) noexcept
+        {
+            ::new(destination) TCallable(std::move(*static_cast<TCallable*>(source)));
+        },
+        [](void* callable) noexcept
+        {
+            static_cast<TCallable*>(callable)->~TCallable();
+        }};
+
+    void MoveFrom(StrategyFunction& other) noexcept
+    {
+        if(!other.m_VTable)
+            return;
+
+        other.m_VTable->m_MoveConstruct(m_Buffer, other.m_Buffer);
+        m_VTable = other.m_VTable;
+        other.Reset();
+    }
+
+    void Reset() noexcept
+    {
+        if(!m_VTable)
+            return;
+
+        m_VTable->m_Destroy(m_Buffer);
+        m_VTable = nullptr;
+    }
+
+    const VTable* m_VTable{nullptr};
+    alignas(BufferAlignment) std::byte m_Buffer[BufferSize]{};
+};
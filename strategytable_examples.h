@@ -0,0 +1,286 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "epoch.h"
+#include "referencesemantics_examples.h"
+
+namespace ReferenceSemantics
+{
+    // Strategies shared by slot. Values are bound to a slot once, through the forwarding strategy returned by
+    // GetSlotOperationStrategy(), after that every value of a slot is switched by a single SetOperationStrategy()
+    // on the table, no matter how many values reference it.
+    // The slots are double buffered, an update fills the inactive buffer and swaps it in atomically, readers
+    // never take a lock. Epoch based reclamation makes sure no reader still uses a buffer before it is reused.
+    // Strategies are shared ones from GetSharedOperationStrategy(), which outlive the table.
+    template<typename TValue, size_t TSlotCount = 16>
+    class StrategyTable
+    {
+    public:
+        using OperationStrategy = typename TValue::OperationStrategy;
+
+        static constexpr size_t SlotCount{TSlotCount};
+
+        explicit StrategyTable(const SharedOperationStrategy<TValue> defaultOperationStrategy)
+        {
+            m_Buffers[0].fill(&defaultOperationStrategy.Get());
+            for(size_t slot{0}; slot != SlotCount; ++slot)
+            {
+                m_SlotOperationStrategies[slot].m_Table = this;
+                m_SlotOperationStrategies[slot].m_Slot = slot;
+            }
+        }
+
+        // Slot strategies point back to the table
+        StrategyTable(const StrategyTable&) = delete;
+        StrategyTable& operator=(const StrategyTable&) = delete;
+
+        // Strategy to set on values, e.g. value.SetOperationStrategy(table.GetSlotOperationStrategy(slot))
+        // The slot strategies live as long as the table, values bound to them must not outlive it
+        SharedOperationStrategy<TValue> GetSlotOperationStrategy(const size_t slot)
+        {
+            return SharedOperationStrategy<TValue>{m_SlotOperationStrategies[slot]};
+        }
+
+        SharedOperationStrategy<TValue> GetOperationStrategy(const size_t slot) const
+        {
+            const Epoch::Guard guard{};
+            return SharedOperationStrategy<TValue>{*(*m_Current.load())[slot]};
+        }
+
+        void SetOperationStrategy(const size_t slot, const SharedOperationStrategy<TValue> operationStrategy)
+        {
+            Publish(
+                [slot, operationStrategy](Buffer& buffer)
+                {
+                    buffer[slot] = &operationStrategy.Get();
+                });
+        }
+
+        // Every slot at once
+        void SetOperationStrategy(const SharedOperationStrategy<TValue> operationStrategy)
+        {
+            Publish(
+                [operationStrategy](Buffer& buffer)
+                {
+                    buffer.fill(&operationStrategy.Get());
+                });
+        }
+    private:
+        using Buffer = std::array<OperationStrategy*, SlotCount>;
+
+        class SlotOperationStrategy final : public OperationStrategy
+        {
+        public:
+            void Operation(TValue& value) override
+            {
+                // Nested inside a caller's Guard this only touches thread local state
+                const Epoch::Guard guard{};
+                (*m_Table->m_Current.load())[m_Slot]->Operation(value);
+            }
+        private:
+            friend StrategyTable;
+
+            const StrategyTable* m_Table{nullptr};
+            size_t m_Slot{0};
+        };
+
+        template<typename TUpdate>
+        void Publish(const TUpdate& update)
+        {
+            const std::scoped_lock lock{m_WriterMutex};
+            const Buffer* const current{m_Current.load(std::memory_order_relaxed)};
+            Buffer& next{m_Buffers[current == &m_Buffers[0] ? 1 : 0]};
+
+            next = *current;
+            update(next);
+            m_Current.store(&next);
+
+            // Readers that loaded current are gone after this, the next Publish may overwrite it
+            Epoch::Synchronize();
+        }
+
+        std::array<Buffer, 2> m_Buffers{};
+        std::atomic<const Buffer*> m_Current{&m_Buffers[0]};
+        std::array<SlotOperationStrategy, SlotCount> m_SlotOperationStrategies{};
+        std::mutex m_WriterMutex{};
+    };
+
+    TEST_CASE("Strategy - Strategy Table - Unit Tests")
+    {
+        const SharedOperationStrategy<IntValue> incrementOperationStrategy{
+            GetSharedOperationStrategy<IncrementIntValueOperationStrategy>()};
+        const SharedOperationStrategy<IntValue> decrementOperationStrategy{
+            GetSharedOperationStrategy<DecrementIntValueOperationStrategy>()};
+
+        SECTION("Epoch Guard")
+        {
+            {
+                const Epoch::Guard guard{};
+                const Epoch::Guard nestedGuard{};
+            }
+
+            // Returns immediately, the calling thread left its Guards
+            Epoch::Synchronize();
+        }
+
+        SECTION("Hot-Swap")
+        {
+            StrategyTable<IntValue, 2> table{incrementOperationStrategy};
+            REQUIRE(table.GetOperationStrategy(0) == incrementOperationStrategy);
+
+            IntValue firstIntValue{0, table.GetSlotOperationStrategy(0)};
+            IntValue secondIntValue{10, table.GetSlotOperationStrategy(0)};
+            IntValue thirdIntValue{20, table.GetSlotOperationStrategy(1)};
+
+            firstIntValue.Operation();
+            secondIntValue.Operation();
+            thirdIntValue.Operation();
+            REQUIRE(firstIntValue.GetValue() == 1);
+            REQUIRE(secondIntValue.GetValue() == 11);
+            REQUIRE(thirdIntValue.GetValue() == 21);
+
+            table.SetOperationStrategy(0, decrementOperationStrategy);
+            REQUIRE(table.GetOperationStrategy(0) == decrementOperationStrategy);
+            REQUIRE(table.GetOperationStrategy(1) == incrementOperationStrategy);
+
+            firstIntValue.Operation();
+            secondIntValue.Operation();
+            thirdIntValue.Operation();
+            REQUIRE(firstIntValue.GetValue() == 0);
+            REQUIRE(secondIntValue.GetValue() == 10);
+            REQUIRE(thirdIntValue.GetValue() == 22);
+
+            table.SetOperationStrategy(decrementOperationStrategy);
+            thirdIntValue.Operation();
+            REQUIRE(thirdIntValue.GetValue() == 21);
+        }
+
+        SECTION("Concurrent Hot-Swap")
+        {
+            StrategyTable<IntValue, 1> table{incrementOperationStrategy};
+            std::vector<std::unique_ptr<Value>> values{};
+            for(uint32_t i{0}; i != 1'000; ++i)
+            {
+                values.push_back(std::make_unique<IntValue>(0, table.GetSlotOperationStrategy(0)));
+            }
+
+            std::atomic<bool> stop{false};
+            std::atomic<uint32_t> passCount{0};
+            std::thread worker{
+                [&values, &stop, &passCount]()
+                {
+                    while(!stop.load(std::memory_order_relaxed))
+                    {
+                        const Epoch::Guard guard{};
+                        for(const std::unique_ptr<Value>& value: values)
+                        {
+                            value->Operation();
+                        }
+
+                        passCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }};
+
+            for(uint32_t i{0}; i != 100; ++i)
+            {
+                table.SetOperationStrategy(0, i % 2 == 0 ? decrementOperationStrategy : incrementOperationStrategy);
+            }
+
+            while(passCount.load(std::memory_order_relaxed) == 0)
+            {
+                std::this_thread::yield();
+            }
+
+            stop = true;
+            worker.join();
+
+            // Once SetOperationStrategy() has returned every value sees the new strategy
+            std::vector<int32_t> previousValues{};
+            for(const std::unique_ptr<Value>& value: values)
+            {
+                previousValues.push_back(static_cast<const IntValue&>(*value).GetValue());
+                value->Operation();
+            }
+
+            bool isEveryValueIncremented{true};
+            for(uint32_t i{0}; i != values.size(); ++i)
+            {
+                isEveryValueIncremented &= static_cast<const IntValue&>(*values[i]).GetValue() == previousValues[i] + 1;
+            }
+
+            REQUIRE(isEveryValueIncremented);
+        }
+    }
+
+    TEST_CASE("Strategy - Strategy Table - Benchmark")
+    {
+        constexpr uint32_t valueCount{50'000};
+        const SharedOperationStrategy<IntValue> incrementOperationStrategy{
+            GetSharedOperationStrategy<IncrementIntValueOperationStrategy>()};
+        const SharedOperationStrategy<IntValue> decrementOperationStrategy{
+            GetSharedOperationStrategy<DecrementIntValueOperationStrategy>()};
+
+        StrategyTable<IntValue> table{incrementOperationStrategy};
+        std::vector<std::unique_ptr<IntValue>> flyweightValues{};
+        std::vector<std::unique_ptr<IntValue>> tableValues{};
+        flyweightValues.reserve(valueCount);
+        tableValues.reserve(valueCount);
+
+        for(uint32_t i{0}; i != valueCount; ++i)
+        {
+            flyweightValues.push_back(std::make_unique<IntValue>(0, incrementOperationStrategy));
+            tableValues.push_back(std::make_unique<IntValue>(0, table.GetSlotOperationStrategy(0)));
+        }
+
+        bool isIncrement{false};
+        BENCHMARK("Swap - Per-Value SetOperationStrategy")
+        {
+            isIncrement = !isIncrement;
+            const SharedOperationStrategy<IntValue> operationStrategy{isIncrement ?
+                incrementOperationStrategy : decrementOperationStrategy};
+
+            for(const std::unique_ptr<IntValue>& value: flyweightValues)
+            {
+                value->SetOperationStrategy(operationStrategy);
+            }
+        };
+
+        BENCHMARK("Swap - StrategyTable")
+        {
+            isIncrement = !isIncrement;
+            table.SetOperationStrategy(0, isIncrement ? incrementOperationStrategy : decrementOperationStrategy);
+        };
+
+        BENCHMARK("Operation - Flyweight")
+        {
+            for(const std::unique_ptr<IntValue>& value: flyweightValues)
+            {
+                value->Operation();
+            }
+        };
+
+        BENCHMARK("Operation - StrategyTable")
+        {
+            const Epoch::Guard guard{};
+            for(const std::unique_ptr<IntValue>& value: tableValues)
+            {
+                value->Operation();
+            }
+        };
+
+        BENCHMARK("Operation - StrategyTable Without Batch Guard")
+        {
+            for(const std::unique_ptr<IntValue>& value: tableValues)
+            {
+                value->Operation();
+            }
+        };
+    }
+}
@@ -0,0 +1,495 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "allocationtracking.h"
+#include "rng.h"
+#include "snapshot.h"
+#include "snapshot_examples.h"
+#include "strategycollection_examples.h"
+#include "template_examples.h"
+#include "threadpool.h"
+
+namespace Template
+{
+    // One value of a value stream file, the payload holds the bits of the int32_t/float_t
+    struct ValueRecord
+    {
+        uint32_t m_Payload{0};
+        Snapshot::StrategyId m_StrategyId{Snapshot::StrategyId::Count};
+        std::array<uint8_t, 3> m_Reserved{};
+    };
+
+    static_assert(sizeof(ValueRecord) == 8);
+
+    template<typename... TValues>
+    bool AddRecord(StrategyCollection<TValues...>& collection, const ValueRecord record)
+    {
+        return ((record.m_StrategyId == StrategyIdOf<TValues> &&
+            (collection.template Add<TValues>(std::bit_cast<typename TValues::ValueType>(record.m_Payload)), true)) ||
+            ...);
+    }
+
+    // Read() clears chunk and refills it with at most maxCount values, 0 marks the end of the stream
+    template<typename TSource, typename TCollection>
+    concept ValueSource = requires(TSource& source, TCollection& chunk, const size_t maxCount)
+    {
+        { source.Read(chunk, maxCount) } -> std::same_as<size_t>;
+    };
+
+    template<typename TSink, typename TCollection>
+    concept ValueSink = requires(TSink& sink, const TCollection& chunk)
+    {
+        sink.Write(chunk);
+    };
+
+    // Creates count random values, as a population of CreateRandomValue(generator) would
+    class GeneratorValueSource
+    {
+    public:
+        explicit GeneratorValueSource(const size_t count, const uint64_t seed = Rng::DefaultSeed)
+            : m_RemainingCount{count}
+            , m_Generator{seed}
+        {
+        }
+
+        size_t Read(ValueCollection& chunk, const size_t maxCount)
+        {
+            chunk.Clear();
+            const size_t count{std::min(maxCount, m_RemainingCount)};
+            for(size_t i{0}; i != count; ++i)
+            {
+                AddRandomValue(chunk, m_Generator);
+            }
+
+            m_RemainingCount -= count;
+            return count;
+        }
+    private:
+        size_t m_RemainingCount{0};
+        Rng::Generator m_Generator;
+    };
+
+    // Copies the mapped payloads of a snapshot chunk by chunk, pages are only touched when their chunk is read
+    class SnapshotValueSource
+    {
+    public:
+        explicit SnapshotValueSource(const Snapshot::View& view)
+            : m_View{view}
+        {
+        }
+
+        template<typename... TValues>
+        size_t Read(StrategyCollection<TValues...>& chunk, const size_t maxCount)
+        {
+            chunk.Clear();
+            const std::span<const Snapshot::Block> blocks{m_View.GetBlocks()};
+            size_t count{0};
+            while(count != maxCount && m_BlockIndex != blocks.size() && m_IsValid)
+            {
+                const Snapshot::Block& block{blocks[m_BlockIndex]};
+                const size_t readCount{std::min<size_t>(block.m_Count - m_Offset, maxCount - count)};
+                m_IsValid = (ReadBlock<TValues>(chunk, block, readCount) || ...);
+                count += readCount;
+                m_Offset += readCount;
+                if(m_Offset == block.m_Count)
+                {
+                    ++m_BlockIndex;
+                    m_Offset = 0;
+                }
+            }
+
+            return m_IsValid ? count : 0;
+        }
+
+        // false if the snapshot contains a value type the chunks cannot hold
+        bool IsValid() const { return m_IsValid; }
+    private:
+        template<typename TValue, typename... TValues>
+        bool ReadBlock(StrategyCollection<TValues...>& chunk, const Snapshot::Block& block, const size_t count) const
+        {
+            if(block.m_StrategyId != StrategyIdOf<TValue>)
+                return false;
+
+            const auto payloads{m_View.GetPayloads<typename TValue::ValueType>(block).subspan(m_Offset, count)};
+            StrategyPartition<TValue>& partition{chunk.template GetPartition<TValue>()};
+            for(const typename TValue::ValueType value: payloads)
+            {
+                partition.Add(value);
+            }
+
+            return true;
+        }
+
+        const Snapshot::View& m_View;
+        size_t m_BlockIndex{0};
+        size_t m_Offset{0};
+        bool m_IsValid{true};
+    };
+
+    class FileValueSource
+    {
+    public:
+        explicit FileValueSource(const std::filesystem::path& path)
+            : m_File{path, std::ios::binary}
+            , m_IsValid{static_cast<bool>(m_File)}
+        {
+        }
+
+        template<typename... TValues>
+        size_t Read(StrategyCollection<TValues...>& chunk, const size_t maxCount)
+        {
+            chunk.Clear();
+            if(!m_IsValid)
+                return 0;
+
+            m_Records.resize(maxCount);
+            m_File.read(reinterpret_cast<char*>(m_Records.data()),
+                static_cast<std::streamsize>(maxCount * sizeof(ValueRecord)));
+            const size_t count{static_cast<size_t>(m_File.gcount()) / sizeof(ValueRecord)};
+            for(size_t i{0}; i != count && m_IsValid; ++i)
+            {
+                m_IsValid = AddRecord(chunk, m_Records[i]);
+            }
+
+            return m_IsValid ? count : 0;
+        }
+
+        // false if the file could not be opened or contains a value type the chunks cannot hold
+        bool IsValid() const { return m_IsValid; }
+    private:
+        std::ifstream m_File;
+        std::vector<ValueRecord> m_Records{};
+        bool m_IsValid{false};
+    };
+
+    // Writes the values of each chunk grouped by value type
+    class FileValueSink
+    {
+    public:
+        explicit FileValueSink(const std::filesystem::path& path)
+            : m_File{path, std::ios::binary | std::ios::trunc}
+        {
+        }
+
+        template<typename... TValues>
+        void Write(const StrategyCollection<TValues...>& chunk)
+        {
+            m_Records.clear();
+            (AddRecords<TValues>(chunk), ...);
+            m_File.write(reinterpret_cast<const char*>(m_Records.data()),
+                static_cast<std::streamsize>(m_Records.size() * sizeof(ValueRecord)));
+        }
+
+        bool IsValid() const { return static_cast<bool>(m_File); }
+    private:
+        template<typename TValue, typename... TValues>
+        void AddRecords(const StrategyCollection<TValues...>& chunk)
+        {
+            for(const typename TValue::ValueType value: chunk.template GetPartition<TValue>().GetValues())
+            {
+                m_Records.push_back(ValueRecord{std::bit_cast<uint32_t>(value), StrategyIdOf<TValue>});
+            }
+        }
+
+        std::ofstream m_File;
+        std::vector<ValueRecord> m_Records{};
+    };
+
+    // Sums the values instead of storing them
+    class SumValueSink
+    {
+    public:
+        template<typename... TValues>
+        void Write(const StrategyCollection<TValues...>& chunk)
+        {
+            (AddValues<TValues>(chunk), ...);
+            m_MaxChunkSize = std::max(m_MaxChunkSize, chunk.GetSize());
+        }
+
+        double GetSum() const { return m_Sum; }
+        size_t GetCount() const { return m_Count; }
+        size_t GetMaxChunkSize() const { return m_MaxChunkSize; }
+    private:
+        template<typename TValue, typename... TValues>
+        void AddValues(const StrategyCollection<TValues...>& chunk)
+        {
+            const std::span<const typename TValue::ValueType> values{chunk.template GetPartition<TValue>().GetValues()};
+            for(const typename TValue::ValueType value: values)
+            {
+                m_Sum += value;
+            }
+
+            m_Count += values.size();
+        }
+
+        double m_Sum{0.0};
+        size_t m_Count{0};
+        size_t m_MaxChunkSize{0};
+    };
+
+    // Applies the strategies of a population that does not have to fit in memory.
+    // Values flow from the source to the sink in chunks of chunkSize values. While a chunk is operated on, an
+    // I/O thread that serves the whole Run() writes the previous chunk and then reads the next one into the
+    // same second chunk, so peak memory depends on chunkSize and not on the size of the population.
+    // The source and the sink are only used by one thread at a time and see the chunks in stream order.
+    template<typename TCollection = ValueCollection>
+    class StreamingExecutor
+    {
+    public:
+        explicit StreamingExecutor(const size_t chunkSize, const bool isPrefetching = true)
+            : m_ChunkSize{std::max<size_t>(chunkSize, 1)}
+            , m_IsPrefetching{isPrefetching}
+        {
+        }
+
+        // Returns the number of values streamed, every value receives operationCount Operation() calls
+        template<ValueSource<TCollection> TSource, ValueSink<TCollection> TSink>
+        size_t Run(TSource& source, TSink& sink, const uint32_t operationCount = 1) const
+        {
+            // Worker 1 of the pool is the I/O thread, it lives for the whole Run() instead of one per chunk
+            std::optional<ThreadPool> threadPool{};
+            if(m_IsPrefetching)
+                threadPool.emplace(2);
+
+            std::array<TCollection, 2> chunks{};
+            size_t chunkIndex{0};
+            size_t count{source.Read(chunks[chunkIndex], m_ChunkSize)};
+            size_t totalCount{0};
+            while(count != 0)
+            {
+                TCollection& chunk{chunks[chunkIndex]};
+                TCollection& nextChunk{chunks[chunkIndex ^ 1]};
+                const auto operate{
+                    [&chunk, operationCount]()
+                    {
+                        for(uint32_t operation{0}; operation != operationCount; ++operation)
+                        {
+                            chunk.Operation();
+                        }
+                    }};
+
+                size_t nextCount{0};
+                if(threadPool)
+                {
+                    // nextChunk still holds the previous chunk, it is written before the next one is read into it
+                    const bool isWriting{totalCount != 0};
+                    threadPool->Run(
+                        [this, &source, &sink, &nextChunk, &nextCount, &operate, isWriting](const size_t workerIndex)
+                        {
+                            if(workerIndex == 0)
+                            {
+                                operate();
+                                return;
+                            }
+
+                            if(isWriting)
+                                sink.Write(nextChunk);
+
+                            nextCount = source.Read(nextChunk, m_ChunkSize);
+                        });
+                }
+                else
+                {
+                    operate();
+                    sink.Write(chunk);
+                    nextCount = source.Read(nextChunk, m_ChunkSize);
+                }
+
+                totalCount += count;
+                count = nextCount;
+                chunkIndex ^= 1;
+            }
+
+            // The last chunk, the loop only writes a chunk while operating on its successor
+            if(threadPool && totalCount != 0)
+                sink.Write(chunks[chunkIndex ^ 1]);
+
+            return totalCount;
+        }
+
+        size_t GetChunkSize() const { return m_ChunkSize; }
+    private:
+        size_t m_ChunkSize{1};
+        bool m_IsPrefetching{true};
+    };
+
+    TEST_CASE("Strategy - Streaming - Unit Tests")
+    {
+        constexpr size_t valueCount{10'000};
+        constexpr size_t chunkSize{1'000};
+
+        // Reference: the whole population in memory
+        ValueCollection collection{};
+        Rng::Generator generator{};
+        for(size_t i{0}; i != valueCount; ++i)
+        {
+            AddRandomValue(collection, generator);
+        }
+
+        collection.Operation();
+        collection.Operation();
+        SumValueSink expected{};
+        expected.Write(collection);
+
+        SECTION("Generator source")
+        {
+            for(const bool isPrefetching: {true, false})
+            {
+                GeneratorValueSource source{valueCount};
+                SumValueSink sink{};
+                const StreamingExecutor executor{chunkSize, isPrefetching};
+                REQUIRE(executor.Run(source, sink, 2) == valueCount);
+                REQUIRE(sink.GetCount() == valueCount);
+                REQUIRE(sink.GetSum() == expected.GetSum());
+                REQUIRE(sink.GetMaxChunkSize() <= chunkSize);
+            }
+        }
+
+        SECTION("Writes keep the stream order")
+        {
+            const auto readStream{
+                [](const bool isPrefetching)
+                {
+                    const std::filesystem::path path{GetSnapshotPath("streaming-order")};
+                    {
+                        GeneratorValueSource source{valueCount};
+                        FileValueSink sink{path};
+                        StreamingExecutor{chunkSize, isPrefetching}.Run(source, sink);
+                    }
+
+                    std::ifstream file{path, std::ios::binary};
+                    const std::vector<char> bytes{
+                        std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+                    file.close();
+                    std::filesystem::remove(path);
+                    return bytes;
+                }};
+
+            const std::vector<char> sequential{readStream(false)};
+            REQUIRE(sequential.size() == valueCount * sizeof(ValueRecord));
+            REQUIRE(readStream(true) == sequential);
+        }
+
+        SECTION("Snapshot source to file sink to file source")
+        {
+            ValueCollection initialCollection{};
+            Rng::Generator initialGenerator{};
+            for(size_t i{0}; i != valueCount; ++i)
+            {
+                AddRandomValue(initialCollection, initialGenerator);
+            }
+
+            const std::filesystem::path snapshotPath{GetSnapshotPath("streaming")};
+            const std::filesystem::path streamPath{GetSnapshotPath("streaming-values")};
+            REQUIRE(SaveSnapshot(initialCollection, snapshotPath));
+            {
+                const std::optional<Snapshot::View> view{Snapshot::View::Open(snapshotPath)};
+                REQUIRE(view.has_value());
+                SnapshotValueSource source{*view};
+                FileValueSink sink{streamPath};
+                REQUIRE(StreamingExecutor{chunkSize}.Run(source, sink) == valueCount);
+                REQUIRE(source.IsValid());
+                REQUIRE(sink.IsValid());
+            }
+
+            REQUIRE(std::filesystem::file_size(streamPath) == valueCount * sizeof(ValueRecord));
+            FileValueSource source{streamPath};
+            SumValueSink sink{};
+            REQUIRE(StreamingExecutor{chunkSize}.Run(source, sink) == valueCount);
+            REQUIRE(source.IsValid());
+            REQUIRE(sink.GetSum() == expected.GetSum());
+
+            std::filesystem::remove(snapshotPath);
+            std::filesystem::remove(streamPath);
+        }
+
+        SECTION("Invalid sources end the stream")
+        {
+            FileValueSource missingSource{GetSnapshotPath("missing")};
+            SumValueSink sink{};
+            REQUIRE(StreamingExecutor{chunkSize}.Run(missingSource, sink) == 0);
+            REQUIRE_FALSE(missingSource.IsValid());
+
+            const std::filesystem::path snapshotPath{GetSnapshotPath("streaming")};
+            REQUIRE(SaveSnapshot(collection, snapshotPath));
+            {
+                const std::optional<Snapshot::View> view{Snapshot::View::Open(snapshotPath)};
+                REQUIRE(view.has_value());
+                using IntCollection = StrategyCollection<IntValue<IncrementIntValueOperationStrategy>>;
+                SnapshotValueSource source{*view};
+                SumValueSink intSink{};
+                StreamingExecutor<IntCollection>{chunkSize}.Run(source, intSink);
+                REQUIRE_FALSE(source.IsValid());
+            }
+
+            std::filesystem::remove(snapshotPath);
+        }
+
+        if constexpr(AllocationTracking::IsEnabled)
+        {
+            SECTION("Peak memory is bounded by the chunk size")
+            {
+                const auto getPeakLiveBytes{
+                    [](const size_t count)
+                    {
+                        const AllocationTracking::Scope scope{};
+                        GeneratorValueSource source{count};
+                        SumValueSink sink{};
+                        StreamingExecutor{chunkSize}.Run(source, sink);
+                        return scope.GetStats().m_PeakLiveBytes;
+                    }};
+
+                REQUIRE(getPeakLiveBytes(valueCount * 10) < 2 * getPeakLiveBytes(valueCount));
+            }
+        }
+    }
+
+    TEST_CASE("Strategy - Streaming - Benchmark")
+    {
+        constexpr size_t valueCount{4'000'000};
+        constexpr size_t chunkSize{64 * 1024};
+        constexpr uint32_t operationCount{4};
+
+        const std::filesystem::path path{GetSnapshotPath("streaming-benchmark")};
+        {
+            GeneratorValueSource source{valueCount};
+            FileValueSink sink{path};
+            StreamingExecutor{chunkSize}.Run(source, sink, 0);
+        }
+
+        for(const bool isPrefetching: {false, true})
+        {
+            const StreamingExecutor executor{chunkSize, isPrefetching};
+            BENCHMARK(isPrefetching ? "Generator Source Double Buffered" : "Generator Source Sequential")
+            {
+                GeneratorValueSource source{valueCount};
+                SumValueSink sink{};
+                executor.Run(source, sink, operationCount);
+                return sink.GetSum();
+            };
+
+            BENCHMARK(isPrefetching ? "File Source Double Buffered" : "File Source Sequential")
+            {
+                FileValueSource source{path};
+                SumValueSink sink{};
+                executor.Run(source, sink, operationCount);
+                return sink.GetSum();
+            };
+        }
+
+        std::filesystem::remove(path);
+    }
+}
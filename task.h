@@ -0,0 +1,136 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// Lazily started coroutine without a result.
+// The coroutine runs when the Task is awaited and resumes the awaiting coroutine when it completes
+// (symmetric transfer, so long chains of synchronously completing Tasks do not grow the stack).
+// Exceptions are rethrown into the awaiting coroutine.
+class [[nodiscard]] Task
+{
+public:
+    struct promise_type
+    {
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(const std::coroutine_handle<promise_type> handle) const noexcept
+            {
+                return handle.promise().m_Continuation;
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        Task get_return_object()
+        {
+            return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            m_Exception = std::current_exception();
+        }
+
+        std::coroutine_handle<> m_Continuation{std::noop_coroutine()};
+        std::exception_ptr m_Exception{};
+    };
+
+    Task() = default;
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task(Task&& other) noexcept
+        : m_Handle{std::exchange(other.m_Handle, nullptr)}
+    {
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if(this != &other)
+        {
+            if(m_Handle)
+                m_Handle.destroy();
+
+            m_Handle = std::exchange(other.m_Handle, nullptr);
+        }
+
+        return *this;
+    }
+
+    ~Task()
+    {
+        if(m_Handle)
+            m_Handle.destroy();
+    }
+
+    auto operator co_await() const noexcept
+    {
+        struct Awaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return !m_Handle || m_Handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(const std::coroutine_handle<> continuation) const noexcept
+            {
+                m_Handle.promise().m_Continuation = continuation;
+                return m_Handle;
+            }
+
+            void await_resume() const
+            {
+                if(m_Handle && m_Handle.promise().m_Exception)
+                    std::rethrow_exception(m_Handle.promise().m_Exception);
+            }
+
+            std::coroutine_handle<promise_type> m_Handle{};
+        };
+
+        return Awaiter{m_Handle};
+    }
+
+    bool IsDone() const { return !m_Handle || m_Handle.done(); }
+private:
+    explicit Task(const std::coroutine_handle<promise_type> handle)
+        : m_Handle{handle}
+    {
+    }
+
+    std::coroutine_handle<promise_type> m_Handle{};
+};
+
+// Eagerly started coroutine that destroys itself when it completes, used to drive Tasks from
+// non-coroutine code. Nothing can await it, so completion has to be signalled explicitly (e.g. a std::latch).
+struct FireAndForget
+{
+    struct promise_type
+    {
+        FireAndForget get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception() const noexcept
+        {
+            std::terminate();
+        }
+    };
+};
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define TELEMETRY_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define TELEMETRY_RDTSC
+#endif
+
+#if defined(__GNUC__)
+    #include <cxxabi.h>
+#endif
+
+// Call counts and sampled timings of the hot Operation() paths.
+// Instrumentation is compiled in when STRATEGY_PATTERN_ENABLE_TELEMETRY is defined, otherwise ScopedSample is
+// an empty type and the instrumented paths compile to the same code as without it.
+// Sites are keyed by strategy type: at compile time with ScopedSample, or through a DynamicSite resolved when a
+// strategy behind a pointer or std::function is set.
+// Every thread counts into its own block of cache line padded counters, no counter is shared between threads.
+// Blocks are published in a lock-free list and live until the process exits, so GetSnapshot() also includes
+// threads that have already finished.
+namespace Telemetry
+{
+#if defined(STRATEGY_PATTERN_ENABLE_TELEMETRY)
+    constexpr bool IsEnabled{true};
+#else
+    constexpr bool IsEnabled{false};
+#endif
+
+    // Sites registered beyond the capacity share the last one
+    constexpr size_t MaxSiteCount{64};
+    // One in SampleInterval calls per thread and site is timed
+    constexpr uint64_t SampleInterval{64};
+
+    struct SiteStats
+    {
+        std::string m_Name{};
+        uint64_t m_CallCount{0};
+        uint64_t m_SampleCount{0};
+        // Timestamp counter ticks (nanoseconds without rdtsc) of the sampled calls, including the timer itself
+        uint64_t m_SampledTicks{0};
+
+        double GetMeanTicks() const
+        {
+            return m_SampleCount == 0 ? 0.0 : static_cast<double>(m_SampledTicks) / static_cast<double>(m_SampleCount);
+        }
+    };
+
+    namespace Detail
+    {
+        // Written only by the owning thread: relaxed load and store instead of a locked read-modify-write,
+        // atomic only so that GetSnapshot() can read them concurrently
+        struct alignas(64) SiteCounters
+        {
+            std::atomic<uint64_t> m_CallCount{0};
+            std::atomic<uint64_t> m_SampleCount{0};
+            std::atomic<uint64_t> m_SampledTicks{0};
+        };
+
+        struct ThreadBlock
+        {
+            std::array<SiteCounters, MaxSiteCount> m_Sites{};
+            ThreadBlock* m_Next{nullptr};
+        };
+
+        inline std::atomic<ThreadBlock*> ThreadBlocks{nullptr};
+        inline std::atomic<size_t> SiteCount{0};
+        inline std::array<std::atomic<const std::type_info*>, MaxSiteCount> SiteTypes{};
+
+        inline ThreadBlock& CreateThreadBlock()
+        {
+            ThreadBlock* const threadBlock{new ThreadBlock{}};
+            threadBlock->m_Next = ThreadBlocks.load(std::memory_order_relaxed);
+            while(!ThreadBlocks.compare_exchange_weak(threadBlock->m_Next, threadBlock,
+                std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+
+            return *threadBlock;
+        }
+
+        // Constant initialized, so the hot path pays no thread_local initialization guard
+        inline thread_local ThreadBlock* CurrentThreadBlock{nullptr};
+
+        inline ThreadBlock& GetThreadBlock()
+        {
+            if(!CurrentThreadBlock)
+                CurrentThreadBlock = &CreateThreadBlock();
+
+            return *CurrentThreadBlock;
+        }
+
+        inline size_t RegisterSite(const std::type_info& type)
+        {
+            const size_t siteIndex{std::min(SiteCount.fetch_add(1, std::memory_order_relaxed), MaxSiteCount - 1)};
+            const std::type_info* expected{nullptr};
+            SiteTypes[siteIndex].compare_exchange_strong(expected, &type, std::memory_order_release);
+            return siteIndex;
+        }
+
+        // Registered during static initialization, no guard on the hot path
+        template<typename TSite>
+        inline const size_t SiteIndex{RegisterSite(typeid(TSite))};
+
+        inline std::mutex DynamicSiteMutex{};
+
+        // Sites of types only known at runtime reuse the index of an earlier registration of the same type
+        inline size_t FindOrRegisterSite(const std::type_info& type)
+        {
+            const std::scoped_lock lock{DynamicSiteMutex};
+            const size_t siteCount{std::min(SiteCount.load(std::memory_order_relaxed), MaxSiteCount)};
+            for(size_t siteIndex{0}; siteIndex != siteCount; ++siteIndex)
+            {
+                const std::type_info* const siteType{SiteTypes[siteIndex].load(std::memory_order_acquire)};
+                if(siteType && *siteType == type)
+                    return siteIndex;
+            }
+
+            return RegisterSite(type);
+        }
+
+        inline std::string GetName(const std::type_info& type)
+        {
+#if defined(__GNUC__)
+            int status{0};
+            const std::unique_ptr<char, decltype(&std::free)> name{
+                abi::__cxa_demangle(type.name(), nullptr, nullptr, &status), &std::free};
+            if(status == 0 && name)
+                return name.get();
+#endif
+            return type.name();
+        }
+
+        inline uint64_t ReadTimestamp()
+        {
+#if defined(TELEMETRY_RDTSC)
+            return __rdtsc();
+#else
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        inline void Increment(std::atomic<uint64_t>& counter, const uint64_t amount = 1)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+    }
+
+    namespace Detail
+    {
+        class SampleScope
+        {
+        public:
+            explicit SampleScope(const size_t siteIndex)
+                : m_Counters{GetThreadBlock().m_Sites[siteIndex]}
+            {
+                const uint64_t callCount{m_Counters.m_CallCount.load(std::memory_order_relaxed) + 1};
+                m_Counters.m_CallCount.store(callCount, std::memory_order_relaxed);
+                if(callCount % SampleInterval == 0)
+                    m_Start = ReadTimestamp();
+            }
+
+            SampleScope(const SampleScope&) = delete;
+            SampleScope& operator=(const SampleScope&) = delete;
+
+            ~SampleScope()
+            {
+                if(m_Start == 0)
+                    return;
+
+                Increment(m_Counters.m_SampledTicks, ReadTimestamp() - m_Start);
+                Increment(m_Counters.m_SampleCount);
+            }
+        private:
+            SiteCounters& m_Counters;
+            uint64_t m_Start{0};
+        };
+    }
+
+    // Counts the enclosing call as a call of TSite (e.g. the strategy type), and times it if it is sampled.
+    // TIsEnabled defaults to IsEnabled, the explicit value allows to compare both variants in one build.
+    template<typename TSite, bool TIsEnabled = IsEnabled>
+    class ScopedSample
+    {
+    public:
+        ScopedSample()
+            : m_Scope{Detail::SiteIndex<TSite>}
+        {
+        }
+    private:
+        Detail::SampleScope m_Scope;
+    };
+
+    template<typename TSite>
+    class ScopedSample<TSite, false>
+    {
+    public:
+        ScopedSample() = default;
+        ScopedSample(const ScopedSample&) = delete;
+        ScopedSample& operator=(const ScopedSample&) = delete;
+    };
+
+    // The site of a strategy whose type is only known at runtime: the dynamic type of a polymorphic object or
+    // the target type of a std::function. Resolved when the strategy is set, so the sampled call pays no lookup.
+    // The index fits into the padding after a 32 bit value, the disabled variant is empty.
+    template<bool TIsEnabled = IsEnabled>
+    class DynamicSite
+    {
+    public:
+        DynamicSite() = default;
+
+        template<typename TObject>
+        explicit DynamicSite(const TObject& object)
+            : m_SiteIndex{static_cast<uint32_t>(Detail::FindOrRegisterSite(typeid(object)))}
+        {
+        }
+
+        template<typename TSignature>
+        explicit DynamicSite(const std::function<TSignature>& function)
+            : m_SiteIndex{static_cast<uint32_t>(Detail::FindOrRegisterSite(function.target_type()))}
+        {
+        }
+
+        size_t GetSiteIndex() const { return m_SiteIndex; }
+    private:
+        uint32_t m_SiteIndex{MaxSiteCount - 1};
+    };
+
+    template<>
+    class DynamicSite<false>
+    {
+    public:
+        DynamicSite() = default;
+
+        template<typename TObject>
+        explicit DynamicSite(const TObject&)
+        {
+        }
+    };
+
+    // ScopedSample for a DynamicSite
+    template<bool TIsEnabled = IsEnabled>
+    class ScopedDynamicSample
+    {
+    public:
+        explicit ScopedDynamicSample(const DynamicSite<TIsEnabled>& site)
+            : m_Scope{site.GetSiteIndex()}
+        {
+        }
+    private:
+        Detail::SampleScope m_Scope;
+    };
+
+    template<>
+    class ScopedDynamicSample<false>
+    {
+    public:
+        explicit ScopedDynamicSample(const DynamicSite<false>&)
+        {
+        }
+
+        ScopedDynamicSample(const ScopedDynamicSample&) = delete;
+        ScopedDynamicSample& operator=(const ScopedDynamicSample&) = delete;
+    };
+
+    static_assert(std::is_empty_v<ScopedSample<int, false>>);
+    static_assert(std::is_empty_v<DynamicSite<false>> && std::is_empty_v<ScopedDynamicSample<false>>);
+
+    // The counters of all threads summed per site, without stopping the instrumented threads
+    inline std::vector<SiteStats> GetSnapshot()
+    {
+        const size_t siteCount{std::min(Detail::SiteCount.load(std::memory_order_relaxed), MaxSiteCount)};
+        std::vector<SiteStats> snapshot(siteCount);
+        for(size_t siteIndex{0}; siteIndex != siteCount; ++siteIndex)
+        {
+            const std::type_info* const type{Detail::SiteTypes[siteIndex].load(std::memory_order_acquire)};
+            snapshot[siteIndex].m_Name = type ? Detail::GetName(*type) : std::string{};
+        }
+
+        for(const Detail::ThreadBlock* threadBlock{Detail::ThreadBlocks.load(std::memory_order_acquire)};
+            threadBlock; threadBlock = threadBlock->m_Next)
+        {
+            for(size_t siteIndex{0}; siteIndex != siteCount; ++siteIndex)
+            {
+                const Detail::SiteCounters& counters{threadBlock->m_Sites[siteIndex]};
+                snapshot[siteIndex].m_CallCount += counters.m_CallCount.load(std::memory_order_relaxed);
+                snapshot[siteIndex].m_SampleCount += counters.m_SampleCount.load(std::memory_order_relaxed);
+                snapshot[siteIndex].m_SampledTicks += counters.m_SampledTicks.load(std::memory_order_relaxed);
+            }
+        }
+
+        return snapshot;
+    }
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "referencesemantics_examples.h"
+#include "rng.h"
+#include "telemetry.h"
+#include "template_examples.h"
+#include "valuesemantics_examples.h"
+
+namespace Telemetry
+{
+    std::optional<SiteStats> FindSite(const std::vector<SiteStats>& snapshot, const std::string_view name)
+    {
+        for(const SiteStats& siteStats: snapshot)
+        {
+            if(siteStats.m_Name == name)
+                return siteStats;
+        }
+
+        return std::nullopt;
+    }
+
+    uint64_t GetCallCount(const std::string_view name)
+    {
+        const std::optional<SiteStats> siteStats{FindSite(GetSnapshot(), name)};
+        return siteStats ? siteStats->m_CallCount : 0;
+    }
+
+    void PrintSnapshot(const std::vector<SiteStats>& snapshot)
+    {
+        for(const SiteStats& siteStats: snapshot)
+        {
+            std::cout << std::left << std::setw(56) << siteStats.m_Name << ' ' << std::fixed << std::setprecision(2)
+                << "calls " << siteStats.m_CallCount << ", samples " << siteStats.m_SampleCount
+                << ", mean ticks " << siteStats.GetMeanTicks() << '\n';
+        }
+    }
+
+    struct UnitTestSite{};
+    struct BenchmarkSite{};
+
+    TEST_CASE("Strategy - Telemetry - Unit Tests")
+    {
+        SECTION("Counters of all threads are aggregated")
+        {
+            constexpr uint64_t callCount{SampleInterval * 100};
+            const uint64_t initialCallCount{GetCallCount("Telemetry::UnitTestSite")};
+
+            std::vector<std::thread> threads{};
+            for(uint32_t threadIndex{0}; threadIndex != 4; ++threadIndex)
+            {
+                threads.emplace_back(
+                    []()
+                    {
+                        for(uint64_t call{0}; call != callCount; ++call)
+                        {
+                            const ScopedSample<UnitTestSite, true> sample{};
+                        }
+                    });
+            }
+
+            for(std::thread& thread: threads)
+            {
+                thread.join();
+            }
+
+            // Each thread counts in its own block, so the threads also sample independently
+            const std::optional<SiteStats> siteStats{FindSite(GetSnapshot(), "Telemetry::UnitTestSite")};
+            REQUIRE(siteStats.has_value());
+            REQUIRE(siteStats->m_CallCount - initialCallCount == 4 * callCount);
+            REQUIRE(siteStats->m_SampleCount * SampleInterval == siteStats->m_CallCount);
+            REQUIRE(siteStats->m_SampledTicks > 0);
+        }
+
+        if constexpr(IsEnabled)
+        {
+            SECTION("Operation() is counted per strategy type")
+            {
+                const uint64_t initialTemplateCount{GetCallCount("Template::IncrementIntValueOperationStrategy")};
+                const uint64_t initialReferenceIncrementCount{
+                    GetCallCount("ReferenceSemantics::IncrementFloatValueOperationStrategy")};
+                const uint64_t initialReferenceDecrementCount{
+                    GetCallCount("ReferenceSemantics::DecrementFloatValueOperationStrategy")};
+                const uint64_t initialValueCount{GetCallCount("ValueSemantics::IncrementIntValueOperationStrategy")};
+
+                const std::unique_ptr<Template::Value> templateValue{Template::CreateValue(true, true)};
+                const std::unique_ptr<ReferenceSemantics::Value> referenceIncrementValue{
+                    ReferenceSemantics::CreateValue(false, true)};
+                const std::unique_ptr<ReferenceSemantics::Value> referenceDecrementValue{
+                    ReferenceSemantics::CreateValue(false, false)};
+                const std::unique_ptr<ValueSemantics::Value> valueSemanticsValue{
+                    ValueSemantics::CreateValue(true, true)};
+                for(uint32_t i{0}; i != 10; ++i)
+                {
+                    templateValue->Operation();
+                    referenceIncrementValue->Operation();
+                    valueSemanticsValue->Operation();
+                }
+
+                referenceDecrementValue->Operation();
+
+                REQUIRE(GetCallCount("Template::IncrementIntValueOperationStrategy") - initialTemplateCount == 10);
+                REQUIRE(GetCallCount("ReferenceSemantics::IncrementFloatValueOperationStrategy") -
+                    initialReferenceIncrementCount == 10);
+                REQUIRE(GetCallCount("ReferenceSemantics::DecrementFloatValueOperationStrategy") -
+                    initialReferenceDecrementCount == 1);
+                REQUIRE(GetCallCount("ValueSemantics::IncrementIntValueOperationStrategy") - initialValueCount == 10);
+            }
+
+            SECTION("SetOperationStrategy() moves the calls to the site of the new strategy")
+            {
+                const uint64_t initialIncrementCount{
+                    GetCallCount("ReferenceSemantics::IncrementIntValueOperationStrategy")};
+                const uint64_t initialDecrementCount{
+                    GetCallCount("ReferenceSemantics::DecrementIntValueOperationStrategy")};
+
+                ReferenceSemantics::IntValue value{
+                    0, std::make_unique<ReferenceSemantics::IncrementIntValueOperationStrategy>()};
+                value.Operation();
+                value.SetOperationStrategy(std::make_unique<ReferenceSemantics::DecrementIntValueOperationStrategy>());
+                value.Operation();
+                value.Operation();
+
+                REQUIRE(GetCallCount("ReferenceSemantics::IncrementIntValueOperationStrategy") -
+                    initialIncrementCount == 1);
+                REQUIRE(GetCallCount("ReferenceSemantics::DecrementIntValueOperationStrategy") -
+                    initialDecrementCount == 2);
+            }
+        }
+    }
+
+    // The same Template population with the call site not instrumented, instrumentation compiled out and
+    // instrumentation compiled in. Operation() itself follows STRATEGY_PATTERN_ENABLE_TELEMETRY, so the
+    // comparison is only meaningful in builds without it.
+    TEST_CASE("Strategy - Telemetry - Benchmark")
+    {
+        constexpr uint32_t valueCount{1'000'000};
+        std::vector<std::unique_ptr<Template::Value>> values{};
+        values.reserve(valueCount);
+        Rng::Generator generator{};
+        for(uint32_t i{0}; i != valueCount; ++i)
+        {
+            values.push_back(Template::CreateRandomValue(generator));
+        }
+
+        BENCHMARK("Not Instrumented")
+        {
+            for(const std::unique_ptr<Template::Value>& value: values)
+            {
+                value->Operation();
+            }
+        };
+
+        BENCHMARK("Compiled Out")
+        {
+            for(const std::unique_ptr<Template::Value>& value: values)
+            {
+                const ScopedSample<BenchmarkSite, false> sample{};
+                value->Operation();
+            }
+        };
+
+        BENCHMARK("Compiled In")
+        {
+            for(const std::unique_ptr<Template::Value>& value: values)
+            {
+                const ScopedSample<BenchmarkSite, true> sample{};
+                value->Operation();
+            }
+        };
+    }
+
+    TEST_CASE("Strategy - Telemetry - Report", "[.][telemetry]")
+    {
+        PrintSnapshot(GetSnapshot());
+    }
+}
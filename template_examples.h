@@ -3,6 +3,27 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <random/random.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+
+#include "allocationtracking.h"
+#include "arena.h"
+#include "population.h"
+#include "rng.h"
+#include "simd.h"
+#include "telemetry.h"
+#include "threadpool.h"
+
+// MSVC accepts [[no_unique_address]] but ignores it to keep its ABI, empty members only overlap with its own
+// spelling of the attribute
+#if defined(_MSC_VER)
+    #define TEMPLATE_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+    #define TEMPLATE_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
 
 namespace Template
 {
@@ -13,18 +34,56 @@ namespace Template
         virtual void Operation() = 0;
     };
 
+    // CRTP base for Strategies that only define operator() on the payload (e.g. int32_t&), adds the overloads for
+    // value objects (through GetValue/SetValue) and for spans of payloads. TOperationStrategy brings them into
+    // its overload set with `using PayloadOperationStrategy<...>::operator();` and can still define its own,
+    // e.g. a SIMD span overload, which is preferred over the template of the base.
+    template<typename TOperationStrategy>
+    class PayloadOperationStrategy
+    {
+    public:
+        template<typename TValue>
+            requires requires(TValue& value) { value.SetValue(value.GetValue()); }
+        void operator()(TValue& value)
+        {
+            auto payload{value.GetValue()};
+            static_cast<TOperationStrategy&>(*this)(payload);
+            value.SetValue(payload);
+        }
+
+        template<typename TValueType>
+        void operator()(const std::span<TValueType> values)
+        {
+            for(TValueType& value: values)
+            {
+                static_cast<TOperationStrategy&>(*this)(value);
+            }
+        }
+    };
+
     // IntValue
     template<typename TOperationStrategy>
     class IntValue final : public Value
     {
     public:
+        using OperationStrategy = TOperationStrategy;
+        using ValueType = int32_t;
+
         explicit IntValue(const int32_t value)
             : m_Value{value}
         {
         }
 
+        // For strategies carrying per-instance state, e.g. AddNIntValueOperationStrategy
+        IntValue(const int32_t value, const TOperationStrategy& operationStrategy)
+            : m_OperationStrategy{operationStrategy}
+            , m_Value{value}
+        {
+        }
+
         void Operation() override
         {
+            const Telemetry::ScopedSample<TOperationStrategy> sample{};
             m_OperationStrategy(*this);
         }
 
@@ -42,6 +101,16 @@ namespace Template
         {
             value.SetValue(value.GetValue() + 1);
         }
+
+        void operator()(int32_t& value)
+        {
+            value += 1;
+        }
+
+        void operator()(const std::span<int32_t> values)
+        {
+            Simd::Add(values, 1);
+        }
     };
 
     class DecrementIntValueOperationStrategy
@@ -51,6 +120,16 @@ namespace Template
         {
             value.SetValue(value.GetValue() - 1);
         }
+
+        void operator()(int32_t& value)
+        {
+            value -= 1;
+        }
+
+        void operator()(const std::span<int32_t> values)
+        {
+            Simd::Add(values, -1);
+        }
     };
 
     // FloatValue
@@ -58,13 +137,24 @@ namespace Template
     class FloatValue final : public Value
     {
     public:
+        using OperationStrategy = TOperationStrategy;
+        using ValueType = float_t;
+
         explicit FloatValue(const float_t value)
             : m_Value{value}
         {
         }
 
+        // For strategies carrying per-instance state, e.g. AddNIntValueOperationStrategy
+        FloatValue(const float_t value, const TOperationStrategy& operationStrategy)
+            : m_OperationStrategy{operationStrategy}
+            , m_Value{value}
+        {
+        }
+
         void Operation() override
         {
+            const Telemetry::ScopedSample<TOperationStrategy> sample{};
             m_OperationStrategy(*this);
         }
 
@@ -82,6 +172,16 @@ namespace Template
         {
             value.SetValue(value.GetValue() + 1.0f);
         }
+
+        void operator()(float_t& value)
+        {
+            value += 1.0f;
+        }
+
+        void operator()(const std::span<float_t> values)
+        {
+            Simd::Add(values, 1.0f);
+        }
     };
 
     class DecrementFloatValueOperationStrategy
@@ -91,24 +191,92 @@ namespace Template
         {
             value.SetValue(value.GetValue() - 1.0f);
         }
+
+        void operator()(float_t& value)
+        {
+            value -= 1.0f;
+        }
+
+        void operator()(const std::span<float_t> values)
+        {
+            Simd::Add(values, -1.0f);
+        }
     };
 
-    std::unique_ptr<Value> CreateRandomValue()
+    std::unique_ptr<Value> CreateValue(const bool isIntValue, const bool isIncrement)
     {
-        if(Random::RandomBool())
+        if(isIntValue)
         {
-            if(Random::RandomBool())
+            if(isIncrement)
                 return std::make_unique<IntValue<IncrementIntValueOperationStrategy>>(0);
 
             return std::make_unique<IntValue<DecrementIntValueOperationStrategy>>(0);
         }
 
-        if(Random::RandomBool())
+        if(isIncrement)
             return std::make_unique<FloatValue<IncrementFloatValueOperationStrategy>>(0.0f);
 
         return std::make_unique<FloatValue<DecrementFloatValueOperationStrategy>>(0.0f);
     }
 
+    std::unique_ptr<Value> CreateRandomValue()
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    std::unique_ptr<Value> CreateRandomValue(Rng::Generator& generator)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    Arena::UniquePtr<Value> CreateValue(
+        const bool isIntValue, const bool isIncrement, std::pmr::memory_resource& memoryResource)
+    {
+        if(isIntValue)
+        {
+            if(isIncrement)
+                return Arena::MakeUnique<IntValue<IncrementIntValueOperationStrategy>>(memoryResource, 0);
+
+            return Arena::MakeUnique<IntValue<DecrementIntValueOperationStrategy>>(memoryResource, 0);
+        }
+
+        if(isIncrement)
+            return Arena::MakeUnique<FloatValue<IncrementFloatValueOperationStrategy>>(memoryResource, 0.0f);
+
+        return Arena::MakeUnique<FloatValue<DecrementFloatValueOperationStrategy>>(memoryResource, 0.0f);
+    }
+
+    Arena::UniquePtr<Value> CreateRandomValue(std::pmr::memory_resource& memoryResource)
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        return CreateValue(isIntValue, isIncrement, memoryResource);
+    }
+
+    Arena::UniquePtr<Value> CreateRandomValue(Rng::Generator& generator, std::pmr::memory_resource& memoryResource)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement, memoryResource);
+    }
+
+    // Same values as count calls of CreateRandomValue(generator) for every thread count
+    ValuePopulation<Arena::UniquePtr<Value>> CreateRandomValues(
+        const size_t count, ThreadPool& threadPool = GetDefaultThreadPool(), const uint64_t seed = Rng::DefaultSeed)
+    {
+        return Population::CreateValues<Arena::UniquePtr<Value>>(count, threadPool, seed,
+            std::max(sizeof(IntValue<IncrementIntValueOperationStrategy>),
+                sizeof(FloatValue<IncrementFloatValueOperationStrategy>)),
+            [](Rng::Generator& generator, std::pmr::memory_resource& memoryResource)
+            {
+                return CreateRandomValue(generator, memoryResource);
+            });
+    }
+
     TEST_CASE("Strategy - Template - Unit Tests")
     {
         SECTION("IntValue Increment Operation")
@@ -158,13 +326,39 @@ namespace Template
             value->Operation();
             REQUIRE(floatValue.GetValue() == -2.0f);
         }
+
+        SECTION("Arena Allocation")
+        {
+            std::array<std::byte, 1024> buffer{};
+            std::pmr::monotonic_buffer_resource memoryResource{
+                buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+            Arena::UniquePtr<IntValue<IncrementIntValueOperationStrategy>> intValue{
+                Arena::MakeUnique<IntValue<IncrementIntValueOperationStrategy>>(memoryResource, 0)};
+            REQUIRE(intValue.GetOwnership() == Arena::Ownership::Arena);
+
+            Value* const value{intValue.get()};
+            value->Operation();
+            REQUIRE(intValue->GetValue() == 1);
+
+            const Arena::UniquePtr<Value> randomValue{CreateRandomValue(memoryResource)};
+            const std::byte* const address{reinterpret_cast<const std::byte*>(randomValue.get())};
+            REQUIRE(address >= buffer.data());
+            REQUIRE(address < buffer.data() + buffer.size());
+        }
     }
 
     TEST_CASE("Strategy - Template - Benchmark")
     {
-        BENCHMARK("Benchmark")
+        constexpr uint32_t valueCount{50'000};
+        constexpr size_t arenaSize{valueCount * sizeof(FloatValue<IncrementFloatValueOperationStrategy>)};
+
+        // Allocations per run, printed with STRATEGY_PATTERN_TRACK_ALLOCATIONS
+        AllocationTracking::BenchmarkReport allocations{};
+
+        BENCHMARK("Construction")
         {
-            constexpr uint32_t valueCount{50'000};
+            const auto run{allocations.Track("Construction")};
             std::vector<std::unique_ptr<Value>> values{};
             values.reserve(valueCount);
 
@@ -173,10 +367,65 @@ namespace Template
                 values.push_back(CreateRandomValue());
             }
 
-            for(const std::unique_ptr<Value>& value: values)
+            return values.size();
+        };
+
+        BENCHMARK("Arena Construction")
+        {
+            const auto run{allocations.Track("Arena Construction")};
+            std::pmr::monotonic_buffer_resource memoryResource{arenaSize};
+            std::vector<Arena::UniquePtr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
             {
-                value->Operation();
+                values.push_back(CreateRandomValue(memoryResource));
             }
+
+            return values.size();
+        };
+
+        BENCHMARK_ADVANCED("Operation")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue());
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("Operation")};
+                    for(const std::unique_ptr<Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("Arena Operation")(Catch::Benchmark::Chronometer meter)
+        {
+            std::pmr::monotonic_buffer_resource memoryResource{arenaSize};
+            std::vector<Arena::UniquePtr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue(memoryResource));
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("Arena Operation")};
+                    for(const Arena::UniquePtr<Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
         };
     }
 }
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "workstealingdeque.h"
+
+// Persistent pool of worker threads for fork/join style parallel loops.
+// The calling thread takes part in each Run() as worker 0, so a pool of one thread runs serially.
+// Runs from different threads are serialized, one pool executes one Run() at a time. A Run() from inside a
+// task of the same pool (e.g. a nested ParallelApply) does not wait for the busy workers, the calling thread
+// executes all of it serially.
+class ThreadPool
+{
+public:
+    using Task = std::function<void(size_t workerIndex)>;
+    using IndexedTask = std::function<void(size_t taskIndex)>;
+
+    explicit ThreadPool(const size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u))
+        : m_ThreadCount{std::max<size_t>(threadCount, 1)}
+        , m_Deques{std::make_unique<WorkStealingDeque[]>(m_ThreadCount)}
+    {
+        m_Workers.reserve(m_ThreadCount - 1);
+        for(size_t workerIndex{1}; workerIndex != m_ThreadCount; ++workerIndex)
+        {
+            m_Workers.emplace_back(
+                [this, workerIndex]()
+                {
+                    WorkerLoop(workerIndex);
+                });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            const std::scoped_lock lock{m_Mutex};
+            m_Stop = true;
+        }
+
+        m_WorkAvailable.notify_all();
+        for(std::thread& worker: m_Workers)
+        {
+            worker.join();
+        }
+    }
+
+    // Calls task once per worker with its index in [0, GetThreadCount()) and blocks until all are done.
+    void Run(const Task& task)
+    {
+        if(IsInsideRun())
+        {
+            for(size_t workerIndex{0}; workerIndex != m_ThreadCount; ++workerIndex)
+            {
+                task(workerIndex);
+            }
+
+            return;
+        }
+
+        const std::scoped_lock runLock{m_RunMutex};
+        RunWorkers(task);
+    }
+
+    // Calls task once per index in [0, taskCount) and blocks until all are done.
+    // Each worker starts with a contiguous block of the indices in its own deque, a worker that runs out
+    // of work steals indices from the other workers, which balances tasks of uneven cost.
+    void RunWorkStealing(const size_t taskCount, const IndexedTask& task)
+    {
+        if(IsInsideRun())
+        {
+            for(size_t taskIndex{0}; taskIndex != taskCount; ++taskIndex)
+            {
+                task(taskIndex);
+            }
+
+            return;
+        }
+
+        const std::scoped_lock runLock{m_RunMutex};
+
+        // All deques are filled before any worker starts, otherwise an early worker could find the other
+        // deques still empty and stop stealing
+        const size_t tasksPerWorker{(taskCount + m_ThreadCount - 1) / m_ThreadCount};
+        for(size_t workerIndex{0}; workerIndex != m_ThreadCount; ++workerIndex)
+        {
+            WorkStealingDeque& deque{m_Deques[workerIndex]};
+            deque.Reset(tasksPerWorker);
+
+            // Pushed in reverse so the owner pops its block front to back
+            const size_t begin{std::min(workerIndex * tasksPerWorker, taskCount)};
+            const size_t end{std::min(begin + tasksPerWorker, taskCount)};
+            for(size_t taskIndex{end}; taskIndex != begin; --taskIndex)
+            {
+                deque.Push(taskIndex - 1);
+            }
+        }
+
+        RunWorkers(
+            [this, &task](const size_t workerIndex)
+            {
+                WorkStealingDeque& deque{m_Deques[workerIndex]};
+                while(const std::optional<size_t> taskIndex{deque.Pop()})
+                {
+                    task(*taskIndex);
+                }
+
+                // Steal until a full pass over the other workers finds every deque empty, a lost race
+                // (Abort) retries the same victim
+                bool hasStolen{true};
+                while(hasStolen)
+                {
+                    hasStolen = false;
+                    for(size_t offset{1}; offset != m_ThreadCount; ++offset)
+                    {
+                        WorkStealingDeque& victim{m_Deques[(workerIndex + offset) % m_ThreadCount]};
+                        for(WorkStealingDeque::StealResult result{victim.Steal()};
+                            result.m_Status != WorkStealingDeque::StealStatus::Empty; result = victim.Steal())
+                        {
+                            if(result.m_Status == WorkStealingDeque::StealStatus::Success)
+                            {
+                                task(result.m_Item);
+                                hasStolen = true;
+                            }
+                        }
+                    }
+                }
+            });
+    }
+
+    size_t GetThreadCount() const { return m_ThreadCount; }
+
+    // Worker index of the calling thread in the pool whose task it is executing, std::nullopt outside of a task.
+    // Stays the index of the thread while a nested Run() executes the tasks of all workers serially.
+    static std::optional<size_t> GetCurrentWorkerIndex()
+    {
+        if(!GetCurrentPool())
+            return std::nullopt;
+
+        return GetCurrentWorkerIndexSlot();
+    }
+private:
+    // Pool whose task the current thread is executing
+    static const ThreadPool*& GetCurrentPool()
+    {
+        static thread_local const ThreadPool* currentPool{nullptr};
+        return currentPool;
+    }
+
+    static size_t& GetCurrentWorkerIndexSlot()
+    {
+        static thread_local size_t currentWorkerIndex{0};
+        return currentWorkerIndex;
+    }
+
+    bool IsInsideRun() const { return GetCurrentPool() == this; }
+
+    // m_RunMutex must be held
+    void RunWorkers(const Task& task)
+    {
+        {
+            const std::scoped_lock lock{m_Mutex};
+            m_Task = &task;
+            m_PendingWorkerCount = m_ThreadCount - 1;
+            ++m_Generation;
+        }
+
+        m_WorkAvailable.notify_all();
+        {
+            const ThreadPool* const previousPool{GetCurrentPool()};
+            const size_t previousWorkerIndex{GetCurrentWorkerIndexSlot()};
+            GetCurrentPool() = this;
+            GetCurrentWorkerIndexSlot() = 0;
+            task(0);
+            GetCurrentPool() = previousPool;
+            GetCurrentWorkerIndexSlot() = previousWorkerIndex;
+        }
+
+        std::unique_lock lock{m_Mutex};
+        m_WorkFinished.wait(lock,
+            [this]()
+            {
+                return m_PendingWorkerCount == 0;
+            });
+        m_Task = nullptr;
+    }
+
+    void WorkerLoop(const size_t workerIndex)
+    {
+        GetCurrentPool() = this;
+        GetCurrentWorkerIndexSlot() = workerIndex;
+        uint64_t generation{0};
+        while(true)
+        {
+            const Task* task{nullptr};
+            {
+                std::unique_lock lock{m_Mutex};
+                m_WorkAvailable.wait(lock,
+                    [this, generation]()
+                    {
+                        return m_Stop || m_Generation != generation;
+                    });
+
+                if(m_Stop)
+                    return;
+
+                generation = m_Generation;
+                task = m_Task;
+            }
+
+            (*task)(workerIndex);
+
+            bool isLastWorker{false};
+            {
+                const std::scoped_lock lock{m_Mutex};
+                isLastWorker = --m_PendingWorkerCount == 0;
+            }
+
+            if(isLastWorker)
+                m_WorkFinished.notify_one();
+        }
+    }
+
+    const size_t m_ThreadCount{1};
+    std::unique_ptr<WorkStealingDeque[]> m_Deques{};
+    std::vector<std::thread> m_Workers{};
+    std::mutex m_RunMutex{};
+    std::mutex m_Mutex{};
+    std::condition_variable m_WorkAvailable{};
+    std::condition_variable m_WorkFinished{};
+    const Task* m_Task{nullptr};
+    size_t m_PendingWorkerCount{0};
+    uint64_t m_Generation{0};
+    bool m_Stop{false};
+};
+
+// Shared by every caller that does not pass its own pool, concurrent callers take turns
+inline ThreadPool& GetDefaultThreadPool()
+{
+    static ThreadPool threadPool{};
+    return threadPool;
+}
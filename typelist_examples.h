@@ -0,0 +1,309 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random/random.h>
+#include <array>
+#include <bit>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#include "simd.h"
+#include "strategycollection_examples.h"
+#include "template_examples.h"
+
+namespace Template
+{
+    // Type Lists
+    template<typename... TTypes>
+    struct TypeList
+    {
+        static constexpr size_t Size{sizeof...(TTypes)};
+    };
+
+    template<typename... TOperationStrategies>
+    struct StrategyList
+    {
+    };
+
+    template<template<typename> typename... TValues>
+    struct ValueList
+    {
+    };
+
+    template<typename... TTypeLists>
+    struct ConcatTypeLists;
+
+    template<>
+    struct ConcatTypeLists<>
+    {
+        using Type = TypeList<>;
+    };
+
+    template<typename... TTypes>
+    struct ConcatTypeLists<TypeList<TTypes...>>
+    {
+        using Type = TypeList<TTypes...>;
+    };
+
+    template<typename... TFirstTypes, typename... TSecondTypes, typename... TTypeLists>
+    struct ConcatTypeLists<TypeList<TFirstTypes...>, TypeList<TSecondTypes...>, TTypeLists...>
+    {
+        using Type = typename ConcatTypeLists<TypeList<TFirstTypes..., TSecondTypes...>, TTypeLists...>::Type;
+    };
+
+    template<template<typename> typename TValue, typename... TOperationStrategies>
+    using ApplyStrategies = TypeList<TValue<TOperationStrategies>...>;
+
+    // Every value type combined with every strategy, e.g. ValueList<IntValue, FloatValue> x
+    // StrategyList<A, B> is TypeList<IntValue<A>, IntValue<B>, FloatValue<A>, FloatValue<B>>.
+    template<typename TValueList, typename TStrategyList>
+    struct CartesianProduct;
+
+    template<template<typename> typename... TValues, typename... TOperationStrategies>
+    struct CartesianProduct<ValueList<TValues...>, StrategyList<TOperationStrategies...>>
+    {
+        using Type = typename ConcatTypeLists<ApplyStrategies<TValues, TOperationStrategies...>...>::Type;
+    };
+
+    template<typename TValueList, typename TStrategyList>
+    using CartesianProductType = typename CartesianProduct<TValueList, TStrategyList>::Type;
+
+    template<typename TType, typename TTypeList>
+    struct IndexOf;
+
+    template<typename TType, typename... TTypes>
+    struct IndexOf<TType, TypeList<TTypes...>>
+    {
+        static_assert((std::is_same_v<TType, TTypes> || ...), "Type is not in the TypeList");
+
+        static constexpr size_t Value{
+            []()
+            {
+                constexpr bool matches[]{std::is_same_v<TType, TTypes>...};
+                size_t index{0};
+                while(!matches[index])
+                {
+                    ++index;
+                }
+
+                return index;
+            }()};
+    };
+
+    // Generic Strategies
+    // Apply to any value type, so they can be combined with every entry of a ValueList.
+    class IncrementValueOperationStrategy : public PayloadOperationStrategy<IncrementValueOperationStrategy>
+    {
+    public:
+        using PayloadOperationStrategy<IncrementValueOperationStrategy>::operator();
+
+        void operator()(int32_t& value) { value += 1; }
+        void operator()(float_t& value) { value += 1.0f; }
+        void operator()(const std::span<int32_t> values) { Simd::Add(values, 1); }
+        void operator()(const std::span<float_t> values) { Simd::Add(values, 1.0f); }
+    };
+
+    class DecrementValueOperationStrategy : public PayloadOperationStrategy<DecrementValueOperationStrategy>
+    {
+    public:
+        using PayloadOperationStrategy<DecrementValueOperationStrategy>::operator();
+
+        void operator()(int32_t& value) { value -= 1; }
+        void operator()(float_t& value) { value -= 1.0f; }
+        void operator()(const std::span<int32_t> values) { Simd::Add(values, -1); }
+        void operator()(const std::span<float_t> values) { Simd::Add(values, -1.0f); }
+    };
+
+    // Factory
+    // Construction from a runtime type index is a single lookup in a constexpr table of create functions.
+    template<typename TTypeList>
+    class ValueFactory;
+
+    template<typename... TValueTypes>
+    class ValueFactory<TypeList<TValueTypes...>>
+    {
+    public:
+        using Types = TypeList<TValueTypes...>;
+        using Collection = StrategyCollection<TValueTypes...>;
+
+        static constexpr size_t TypeCount{sizeof...(TValueTypes)};
+
+        template<typename TValue>
+        static constexpr size_t TypeIndex{IndexOf<TValue, Types>::Value};
+
+        static std::unique_ptr<Value> Create(const size_t typeIndex)
+        {
+            return s_CreateTable[typeIndex]();
+        }
+
+        static void Add(Collection& collection, const size_t typeIndex)
+        {
+            s_AddTable[typeIndex](collection);
+        }
+    private:
+        template<typename TValue>
+        static std::unique_ptr<Value> CreateValue()
+        {
+            return std::make_unique<TValue>(typename TValue::ValueType{});
+        }
+
+        template<typename TValue>
+        static void AddValue(Collection& collection)
+        {
+            collection.template Add<TValue>(typename TValue::ValueType{});
+        }
+
+        static constexpr std::array<std::unique_ptr<Value>(*)(), TypeCount> s_CreateTable{
+            &CreateValue<TValueTypes>...};
+        static constexpr std::array<void(*)(Collection&), TypeCount> s_AddTable{
+            &AddValue<TValueTypes>...};
+    };
+
+    // Uniformly distributed type index built from Random::RandomBool() bits
+    size_t GetRandomTypeIndex(const size_t typeCount)
+    {
+        // No index is below 0, the loop would never end
+        if(typeCount == 0)
+            throw std::invalid_argument{"GetRandomTypeIndex needs at least one type"};
+
+        const size_t bitCount{static_cast<size_t>(std::bit_width(typeCount - 1))};
+        while(true)
+        {
+            size_t typeIndex{0};
+            for(size_t bit{0}; bit != bitCount; ++bit)
+            {
+                typeIndex = (typeIndex << 1) | (Random::RandomBool() ? 1 : 0);
+            }
+
+            if(typeIndex < typeCount)
+                return typeIndex;
+        }
+    }
+
+    using ValueTypes = CartesianProductType<
+        ValueList<IntValue, FloatValue>,
+        StrategyList<IncrementValueOperationStrategy, DecrementValueOperationStrategy>>;
+    using ValueTypeFactory = ValueFactory<ValueTypes>;
+
+    std::unique_ptr<Value> CreateRandomValueFromTable()
+    {
+        return ValueTypeFactory::Create(GetRandomTypeIndex(ValueTypeFactory::TypeCount));
+    }
+
+    void AddRandomValueFromTable(ValueTypeFactory::Collection& collection)
+    {
+        ValueTypeFactory::Add(collection, GetRandomTypeIndex(ValueTypeFactory::TypeCount));
+    }
+
+    TEST_CASE("Strategy - Type List - Unit Tests")
+    {
+        SECTION("Cartesian Product")
+        {
+            STATIC_REQUIRE(std::is_same_v<ValueTypes, TypeList<
+                IntValue<IncrementValueOperationStrategy>,
+                IntValue<DecrementValueOperationStrategy>,
+                FloatValue<IncrementValueOperationStrategy>,
+                FloatValue<DecrementValueOperationStrategy>>>);
+            STATIC_REQUIRE(ValueTypeFactory::TypeCount == 4);
+            STATIC_REQUIRE(ValueTypeFactory::TypeIndex<FloatValue<IncrementValueOperationStrategy>> == 2);
+        }
+
+        SECTION("Factory")
+        {
+            const std::unique_ptr<Value> incrementIntValue{ValueTypeFactory::Create(
+                ValueTypeFactory::TypeIndex<IntValue<IncrementValueOperationStrategy>>)};
+            const std::unique_ptr<Value> decrementFloatValue{ValueTypeFactory::Create(
+                ValueTypeFactory::TypeIndex<FloatValue<DecrementValueOperationStrategy>>)};
+            REQUIRE(typeid(*incrementIntValue) == typeid(IntValue<IncrementValueOperationStrategy>));
+            REQUIRE(typeid(*decrementFloatValue) == typeid(FloatValue<DecrementValueOperationStrategy>));
+
+            incrementIntValue->Operation();
+            decrementFloatValue->Operation();
+            REQUIRE(static_cast<IntValue<IncrementValueOperationStrategy>&>(*incrementIntValue)
+                .GetValue() == 1);
+            REQUIRE(static_cast<FloatValue<DecrementValueOperationStrategy>&>(*decrementFloatValue)
+                .GetValue() == -1.0f);
+        }
+
+        SECTION("Collection")
+        {
+            ValueTypeFactory::Collection collection{};
+            for(size_t typeIndex{0}; typeIndex != ValueTypeFactory::TypeCount; ++typeIndex)
+            {
+                ValueTypeFactory::Add(collection, typeIndex);
+            }
+
+            collection.Operation();
+            REQUIRE(collection.GetSize() == 4);
+            REQUIRE(collection.GetPartition<IntValue<IncrementValueOperationStrategy>>()
+                .GetValues()[0] == 1);
+            REQUIRE(collection.GetPartition<IntValue<DecrementValueOperationStrategy>>()
+                .GetValues()[0] == -1);
+            REQUIRE(collection.GetPartition<FloatValue<IncrementValueOperationStrategy>>()
+                .GetValues()[0] == 1.0f);
+            REQUIRE(collection.GetPartition<FloatValue<DecrementValueOperationStrategy>>()
+                .GetValues()[0] == -1.0f);
+        }
+
+        SECTION("Random Type Index")
+        {
+            bool isEveryIndexInRange{true};
+            for(uint32_t i{0}; i != 1'000; ++i)
+            {
+                isEveryIndexInRange &= GetRandomTypeIndex(3) < 3;
+            }
+
+            REQUIRE(isEveryIndexInRange);
+
+            REQUIRE(GetRandomTypeIndex(1) == 0);
+            REQUIRE_THROWS_AS(GetRandomTypeIndex(0), std::invalid_argument);
+        }
+    }
+
+    TEST_CASE("Strategy - Type List - Benchmark")
+    {
+        constexpr uint32_t valueCount{50'000};
+
+        BENCHMARK("Branching Factory")
+        {
+            std::vector<std::unique_ptr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue());
+            }
+
+            return values.size();
+        };
+
+        BENCHMARK("Table Factory")
+        {
+            std::vector<std::unique_ptr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValueFromTable());
+            }
+
+            return values.size();
+        };
+
+        BENCHMARK("Table Collection")
+        {
+            ValueTypeFactory::Collection collection{};
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                AddRandomValueFromTable(collection);
+            }
+
+            collection.Operation();
+            return collection.GetSize();
+        };
+    }
+}
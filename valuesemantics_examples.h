@@ -3,7 +3,18 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <random/random.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <functional>
+#include <memory_resource>
+
+#include "allocationtracking.h"
+#include "arena.h"
+#include "population.h"
+#include "rng.h"
+#include "telemetry.h"
+#include "threadpool.h"
 
 namespace ValueSemantics
 {
@@ -24,16 +35,19 @@ namespace ValueSemantics
             const int32_t value, OperationStrategy&& operationStrategy)
             : m_OperationStrategy{std::move(operationStrategy)}
             , m_Value{value}
+            , m_TelemetrySite{m_OperationStrategy}
         {
         }
 
         void SetOperationStrategy(OperationStrategy&& operationStrategy)
         {
             m_OperationStrategy = std::move(operationStrategy);
+            m_TelemetrySite = Telemetry::DynamicSite<>{m_OperationStrategy};
         }
 
         void Operation() override
         {
+            const Telemetry::ScopedDynamicSample sample{m_TelemetrySite};
             m_OperationStrategy(*this);
         }
 
@@ -42,6 +56,8 @@ namespace ValueSemantics
     private:
         OperationStrategy m_OperationStrategy{};
         int32_t m_Value{0};
+        // Keyed by the target type of the std::function
+        Telemetry::DynamicSite<> m_TelemetrySite{};
     };
 
     class IncrementIntValueOperationStrategy
@@ -72,16 +88,19 @@ namespace ValueSemantics
             const float_t value, OperationStrategy&& operationStrategy)
             : m_OperationStrategy{std::move(operationStrategy)}
             , m_Value{value}
+            , m_TelemetrySite{m_OperationStrategy}
         {
         }
 
         void SetOperationStrategy(OperationStrategy&& operationStrategy)
         {
             m_OperationStrategy = std::move(operationStrategy);
+            m_TelemetrySite = Telemetry::DynamicSite<>{m_OperationStrategy};
         }
 
         void Operation() override
         {
+            const Telemetry::ScopedDynamicSample sample{m_TelemetrySite};
             m_OperationStrategy(*this);
         }
 
@@ -90,6 +109,8 @@ namespace ValueSemantics
     private:
         OperationStrategy m_OperationStrategy{};
         float_t m_Value{0.0f};
+        // Keyed by the target type of the std::function
+        Telemetry::DynamicSite<> m_TelemetrySite{};
     };
 
     class IncrementFloatValueOperationStrategy
@@ -110,20 +131,77 @@ namespace ValueSemantics
             };
     }
 
-    std::unique_ptr<Value> CreateRandomValue()
+    std::unique_ptr<Value> CreateValue(const bool isIntValue, const bool isIncrement)
     {
-        if(Random::RandomBool())
+        if(isIntValue)
         {
             return std::make_unique<IntValue>(0,
-                Random::RandomBool() ?
+                isIncrement ?
                     IncrementIntValueOperationStrategy{} : GetDecrementIntValueOperationStrategy());
         }
 
         return std::make_unique<FloatValue>(0.0f,
-            Random::RandomBool() ?
+            isIncrement ?
+                IncrementFloatValueOperationStrategy{} : GetDecrementFloatValueOperationStrategy());
+    }
+
+    std::unique_ptr<Value> CreateRandomValue()
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    std::unique_ptr<Value> CreateRandomValue(Rng::Generator& generator)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    // std::function has no allocator support, a callable that does not fit its small buffer
+    // is still allocated from the heap.
+    Arena::UniquePtr<Value> CreateValue(
+        const bool isIntValue, const bool isIncrement, std::pmr::memory_resource& memoryResource)
+    {
+        if(isIntValue)
+        {
+            return Arena::MakeUnique<IntValue>(memoryResource, 0,
+                isIncrement ?
+                    IncrementIntValueOperationStrategy{} : GetDecrementIntValueOperationStrategy());
+        }
+
+        return Arena::MakeUnique<FloatValue>(memoryResource, 0.0f,
+            isIncrement ?
                 IncrementFloatValueOperationStrategy{} : GetDecrementFloatValueOperationStrategy());
     }
 
+    Arena::UniquePtr<Value> CreateRandomValue(std::pmr::memory_resource& memoryResource)
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        return CreateValue(isIntValue, isIncrement, memoryResource);
+    }
+
+    Arena::UniquePtr<Value> CreateRandomValue(Rng::Generator& generator, std::pmr::memory_resource& memoryResource)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement, memoryResource);
+    }
+
+    // Same values as count calls of CreateRandomValue(generator) for every thread count
+    ValuePopulation<Arena::UniquePtr<Value>> CreateRandomValues(
+        const size_t count, ThreadPool& threadPool = GetDefaultThreadPool(), const uint64_t seed = Rng::DefaultSeed)
+    {
+        return Population::CreateValues<Arena::UniquePtr<Value>>(count, threadPool, seed,
+            std::max(sizeof(IntValue), sizeof(FloatValue)),
+            [](Rng::Generator& generator, std::pmr::memory_resource& memoryResource)
+            {
+                return CreateRandomValue(generator, memoryResource);
+            });
+    }
+
     TEST_CASE("Strategy - Value Semantics - Unit Tests")
     {
         SECTION("IntValue Operations")
@@ -165,13 +243,39 @@ namespace ValueSemantics
             value->Operation();
             REQUIRE(floatValue.GetValue() == 0.0f);
         }
+
+        SECTION("Arena Allocation")
+        {
+            std::array<std::byte, 1024> buffer{};
+            std::pmr::monotonic_buffer_resource memoryResource{
+                buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+            Arena::UniquePtr<IntValue> intValue{
+                Arena::MakeUnique<IntValue>(memoryResource, 0, IncrementIntValueOperationStrategy{})};
+            REQUIRE(intValue.GetOwnership() == Arena::Ownership::Arena);
+
+            Value* const value{intValue.get()};
+            value->Operation();
+            REQUIRE(intValue->GetValue() == 1);
+
+            const Arena::UniquePtr<Value> randomValue{CreateRandomValue(memoryResource)};
+            const std::byte* const address{reinterpret_cast<const std::byte*>(randomValue.get())};
+            REQUIRE(address >= buffer.data());
+            REQUIRE(address < buffer.data() + buffer.size());
+        }
     }
 
     TEST_CASE("Strategy - Value Semantics - Benchmark")
     {
-        BENCHMARK("Benchmark")
+        constexpr uint32_t valueCount{50'000};
+        constexpr size_t arenaSize{valueCount * sizeof(FloatValue)};
+
+        // Allocations per run, printed with STRATEGY_PATTERN_TRACK_ALLOCATIONS
+        AllocationTracking::BenchmarkReport allocations{};
+
+        BENCHMARK("Construction")
         {
-            constexpr uint32_t valueCount{50'000};
+            const auto run{allocations.Track("Construction")};
             std::vector<std::unique_ptr<Value>> values{};
             values.reserve(valueCount);
 
@@ -180,10 +284,65 @@ namespace ValueSemantics
                 values.push_back(CreateRandomValue());
             }
 
-            for(const std::unique_ptr<Value>& value: values)
+            return values.size();
+        };
+
+        BENCHMARK("Arena Construction")
+        {
+            const auto run{allocations.Track("Arena Construction")};
+            std::pmr::monotonic_buffer_resource memoryResource{arenaSize};
+            std::vector<Arena::UniquePtr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
             {
-                value->Operation();
+                values.push_back(CreateRandomValue(memoryResource));
             }
+
+            return values.size();
+        };
+
+        BENCHMARK_ADVANCED("Operation")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<std::unique_ptr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue());
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("Operation")};
+                    for(const std::unique_ptr<Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
+        };
+
+        BENCHMARK_ADVANCED("Arena Operation")(Catch::Benchmark::Chronometer meter)
+        {
+            std::pmr::monotonic_buffer_resource memoryResource{arenaSize};
+            std::vector<Arena::UniquePtr<Value>> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue(memoryResource));
+            }
+
+            meter.measure(
+                [&values, &allocations]()
+                {
+                    const auto run{allocations.Track("Arena Operation")};
+                    for(const Arena::UniquePtr<Value>& value: values)
+                    {
+                        value->Operation();
+                    }
+                });
         };
     }
 }
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random/random.h>
+#include <memory_resource>
+#include <variant>
+#include <vector>
+
+#include "population.h"
+#include "rng.h"
+#include "threadpool.h"
+
+namespace VariantSemantics
+{
+    class IntValue;
+    class FloatValue;
+
+    // IntValue
+    class IncrementIntValueOperationStrategy
+    {
+    public:
+        void operator()(IntValue& value);
+    };
+
+    class DecrementIntValueOperationStrategy
+    {
+    public:
+        void operator()(IntValue& value);
+    };
+
+    class IntValue final
+    {
+    public:
+        using OperationStrategy = std::variant<
+            IncrementIntValueOperationStrategy,
+            DecrementIntValueOperationStrategy>;
+
+        explicit IntValue(
+            const int32_t value, const OperationStrategy operationStrategy)
+            : m_OperationStrategy{operationStrategy}
+            , m_Value{value}
+        {
+        }
+
+        void SetOperationStrategy(const OperationStrategy operationStrategy)
+        {
+            m_OperationStrategy = operationStrategy;
+        }
+
+        void Operation()
+        {
+            std::visit(
+                [this](auto& operationStrategy)
+                {
+                    operationStrategy(*this);
+                }, m_OperationStrategy);
+        }
+
+        int32_t GetValue() const { return m_Value; }
+        void SetValue(const int32_t value) { m_Value = value; }
+    private:
+        OperationStrategy m_OperationStrategy{};
+        int32_t m_Value{0};
+    };
+
+    void IncrementIntValueOperationStrategy::operator()(IntValue& value)
+    {
+        value.SetValue(value.GetValue() + 1);
+    }
+
+    void DecrementIntValueOperationStrategy::operator()(IntValue& value)
+    {
+        value.SetValue(value.GetValue() - 1);
+    }
+
+    // FloatValue
+    class IncrementFloatValueOperationStrategy
+    {
+    public:
+        void operator()(FloatValue& value);
+    };
+
+    class DecrementFloatValueOperationStrategy
+    {
+    public:
+        void operator()(FloatValue& value);
+    };
+
+    class FloatValue final
+    {
+    public:
+        using OperationStrategy = std::variant<
+            IncrementFloatValueOperationStrategy,
+            DecrementFloatValueOperationStrategy>;
+
+        explicit FloatValue(
+            const float_t value, const OperationStrategy operationStrategy)
+            : m_OperationStrategy{operationStrategy}
+            , m_Value{value}
+        {
+        }
+
+        void SetOperationStrategy(const OperationStrategy operationStrategy)
+        {
+            m_OperationStrategy = operationStrategy;
+        }
+
+        void Operation()
+        {
+            std::visit(
+                [this](auto& operationStrategy)
+                {
+                    operationStrategy(*this);
+                }, m_OperationStrategy);
+        }
+
+        float_t GetValue() const { return m_Value; }
+        void SetValue(const float_t value) { m_Value = value; }
+    private:
+        OperationStrategy m_OperationStrategy{};
+        float_t m_Value{0.0f};
+    };
+
+    void IncrementFloatValueOperationStrategy::operator()(FloatValue& value)
+    {
+        value.SetValue(value.GetValue() + 1.0f);
+    }
+
+    void DecrementFloatValueOperationStrategy::operator()(FloatValue& value)
+    {
+        value.SetValue(value.GetValue() - 1.0f);
+    }
+
+    // Value
+    // The set of values is closed, so they can be stored by value without a common base class.
+    using Value = std::variant<IntValue, FloatValue>;
+
+    void Operation(Value& value)
+    {
+        std::visit(
+            [](auto& concreteValue)
+            {
+                concreteValue.Operation();
+            }, value);
+    }
+
+    Value CreateValue(const bool isIntValue, const bool isIncrement)
+    {
+        if(isIntValue)
+        {
+            return IntValue{0,
+                isIncrement ?
+                    IntValue::OperationStrategy{IncrementIntValueOperationStrategy{}} :
+                    IntValue::OperationStrategy{DecrementIntValueOperationStrategy{}}};
+        }
+
+        return FloatValue{0.0f,
+            isIncrement ?
+                FloatValue::OperationStrategy{IncrementFloatValueOperationStrategy{}} :
+                FloatValue::OperationStrategy{DecrementFloatValueOperationStrategy{}}};
+    }
+
+    Value CreateRandomValue()
+    {
+        const bool isIntValue{Random::RandomBool()};
+        const bool isIncrement{Random::RandomBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    Value CreateRandomValue(Rng::Generator& generator)
+    {
+        const bool isIntValue{generator.NextBool()};
+        const bool isIncrement{generator.NextBool()};
+        return CreateValue(isIntValue, isIncrement);
+    }
+
+    // Values are stored inline in the vector, no arenas are needed
+    ValuePopulation<Value> CreateRandomValues(
+        const size_t count, ThreadPool& threadPool = GetDefaultThreadPool(), const uint64_t seed = Rng::DefaultSeed)
+    {
+        return Population::CreateValues<Value>(count, threadPool, seed, 0,
+            [](Rng::Generator& generator, std::pmr::memory_resource&)
+            {
+                return CreateRandomValue(generator);
+            });
+    }
+
+    TEST_CASE("Strategy - Variant Semantics - Unit Tests")
+    {
+        SECTION("IntValue Operations")
+        {
+            Value value{IntValue{0, IncrementIntValueOperationStrategy{}}};
+            IntValue& intValue{std::get<IntValue>(value)};
+            REQUIRE(intValue.GetValue() == 0);
+
+            Operation(value);
+            REQUIRE(intValue.GetValue() == 1);
+            Operation(value);
+            REQUIRE(intValue.GetValue() == 2);
+
+            intValue.SetOperationStrategy(DecrementIntValueOperationStrategy{});
+            REQUIRE(intValue.GetValue() == 2);
+
+            Operation(value);
+            REQUIRE(intValue.GetValue() == 1);
+            Operation(value);
+            REQUIRE(intValue.GetValue() == 0);
+        }
+
+        SECTION("FloatValue Operations")
+        {
+            Value value{FloatValue{0.0f, IncrementFloatValueOperationStrategy{}}};
+            FloatValue& floatValue{std::get<FloatValue>(value)};
+            REQUIRE(floatValue.GetValue() == 0.0f);
+
+            Operation(value);
+            REQUIRE(floatValue.GetValue() == 1.0f);
+            Operation(value);
+            REQUIRE(floatValue.GetValue() == 2.0f);
+
+            floatValue.SetOperationStrategy(DecrementFloatValueOperationStrategy{});
+            REQUIRE(floatValue.GetValue() == 2.0f);
+
+            Operation(value);
+            REQUIRE(floatValue.GetValue() == 1.0f);
+            Operation(value);
+            REQUIRE(floatValue.GetValue() == 0.0f);
+        }
+    }
+
+    TEST_CASE("Strategy - Variant Semantics - Benchmark")
+    {
+        BENCHMARK("Benchmark")
+        {
+            constexpr uint32_t valueCount{50'000};
+            std::vector<Value> values{};
+            values.reserve(valueCount);
+
+            for(uint32_t i{0}; i != valueCount; ++i)
+            {
+                values.push_back(CreateRandomValue());
+            }
+
+            for(Value& value: values)
+            {
+                Operation(value);
+            }
+        };
+    }
+}
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random/random.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "parallel.h"
+#include "template_examples.h"
+#include "threadpool.h"
+#include "workstealingdeque.h"
+
+namespace Parallel
+{
+    // Deliberately expensive strategy, the cost of one Operation() is many times a cheap increment.
+    class ExpensiveIntValueOperationStrategy
+    {
+    public:
+        static constexpr uint32_t IterationCount{256};
+
+        void operator()(Template::IntValue<ExpensiveIntValueOperationStrategy>& value)
+        {
+            uint32_t state{static_cast<uint32_t>(value.GetValue())};
+            for(uint32_t i{0}; i != IterationCount; ++i)
+            {
+                state = state * 1'664'525u + 1'013'904'223u;
+            }
+
+            value.SetValue(static_cast<int32_t>(state));
+        }
+    };
+
+    // One in eight values uses the expensive strategy, the rest are the cheap Template values.
+    std::unique_ptr<Template::Value> CreateRandomHeterogeneousValue()
+    {
+        if(Random::RandomBool() && Random::RandomBool() && Random::RandomBool())
+            return std::make_unique<Template::IntValue<ExpensiveIntValueOperationStrategy>>(0);
+
+        return Template::CreateRandomValue();
+    }
+
+    TEST_CASE("Strategy - Work Stealing - Unit Tests")
+    {
+        SECTION("Deque Owner")
+        {
+            WorkStealingDeque deque{};
+            deque.Reset(4);
+            REQUIRE_FALSE(deque.Pop());
+
+            deque.Push(1);
+            deque.Push(2);
+            deque.Push(3);
+            REQUIRE(deque.Pop() == 3);
+            const WorkStealingDeque::StealResult result{deque.Steal()};
+            REQUIRE(result.m_Status == WorkStealingDeque::StealStatus::Success);
+            REQUIRE(result.m_Item == 1);
+            REQUIRE(deque.Pop() == 2);
+            REQUIRE_FALSE(deque.Pop());
+            REQUIRE(deque.Steal().m_Status == WorkStealingDeque::StealStatus::Empty);
+        }
+
+        SECTION("Deque Concurrent Steal")
+        {
+            constexpr size_t itemCount{100'000};
+            WorkStealingDeque deque{};
+            deque.Reset(itemCount);
+            for(size_t i{0}; i != itemCount; ++i)
+            {
+                deque.Push(i);
+            }
+
+            std::vector<std::atomic<uint32_t>> taken(itemCount);
+            std::vector<std::thread> thieves{};
+            for(uint32_t i{0}; i != 3; ++i)
+            {
+                thieves.emplace_back(
+                    [&deque, &taken]()
+                    {
+                        for(WorkStealingDeque::StealResult result{deque.Steal()};
+                            result.m_Status != WorkStealingDeque::StealStatus::Empty; result = deque.Steal())
+                        {
+                            if(result.m_Status == WorkStealingDeque::StealStatus::Success)
+                                ++taken[result.m_Item];
+                        }
+                    });
+            }
+
+            while(const std::optional<size_t> item{deque.Pop()})
+            {
+                ++taken[*item];
+            }
+
+            for(std::thread& thief: thieves)
+            {
+                thief.join();
+            }
+
+            REQUIRE(std::ranges::all_of(taken, [](const std::atomic<uint32_t>& count){ return count == 1; }));
+        }
+
+        SECTION("RunWorkStealing")
+        {
+            ThreadPool threadPool{4};
+            for(const size_t taskCount: {0, 1, 3, 4, 1'001})
+            {
+                std::vector<std::atomic<uint32_t>> calls(taskCount);
+                threadPool.RunWorkStealing(taskCount,
+                    [&calls](const size_t taskIndex)
+                    {
+                        ++calls[taskIndex];
+                    });
+
+                REQUIRE(std::ranges::all_of(calls, [](const std::atomic<uint32_t>& count){ return count == 1; }));
+            }
+        }
+
+        SECTION("Idle workers steal from a blocked worker")
+        {
+            // Task 0 only finishes once every other task ran, including task 1 from the same block
+            constexpr size_t taskCount{4};
+            ThreadPool threadPool{2};
+            std::atomic<size_t> finishedCount{0};
+            bool isUnblocked{false};
+            threadPool.RunWorkStealing(taskCount,
+                [&finishedCount, &isUnblocked](const size_t taskIndex)
+                {
+                    if(taskIndex == 0)
+                    {
+                        const auto deadline{std::chrono::steady_clock::now() + std::chrono::seconds{10}};
+                        while(finishedCount != taskCount - 1 && std::chrono::steady_clock::now() < deadline)
+                        {
+                            std::this_thread::yield();
+                        }
+
+                        isUnblocked = finishedCount == taskCount - 1;
+                    }
+
+                    ++finishedCount;
+                });
+
+            REQUIRE(isUnblocked);
+            REQUIRE(finishedCount == taskCount);
+        }
+
+        SECTION("ParallelApply")
+        {
+            using IntValue = Template::IntValue<Template::IncrementIntValueOperationStrategy>;
+
+            ThreadPool threadPool{3};
+            std::vector<IntValue> values(100'003, IntValue{0});
+            ParallelApply(values, {
+                .m_ThreadPool = &threadPool,
+                .m_Scheduling = Scheduling::WorkStealing,
+                .m_WorkStealingChunkSize = 100});
+
+            REQUIRE(std::ranges::all_of(values, [](const IntValue& value){ return value.GetValue() == 1; }));
+        }
+    }
+
+    struct HeterogeneousValues
+    {
+        std::vector<std::unique_ptr<Template::Value>> m_Shuffled{};
+        // Batches built per type place all expensive values next to each other, which leaves the workers
+        // of a static partition with very different amounts of work.
+        std::vector<std::unique_ptr<Template::Value>> m_Grouped{};
+    };
+
+    HeterogeneousValues CreateHeterogeneousValues(const uint32_t valueCount)
+    {
+        HeterogeneousValues values{};
+        values.m_Shuffled.reserve(valueCount);
+        values.m_Grouped.reserve(valueCount);
+
+        for(uint32_t i{0}; i != valueCount; ++i)
+        {
+            values.m_Shuffled.push_back(CreateRandomHeterogeneousValue());
+            values.m_Grouped.push_back(CreateRandomHeterogeneousValue());
+        }
+
+        std::ranges::stable_partition(values.m_Grouped,
+            [](const std::unique_ptr<Template::Value>& value)
+            {
+                return dynamic_cast<const Template::IntValue<ExpensiveIntValueOperationStrategy>*>(value.get());
+            });
+
+        return values;
+    }
+
+    // Median, 99th percentile and maximum of runCount timed ParallelApply() calls
+    void ReportLatency(const std::string& name, std::vector<std::unique_ptr<Template::Value>>& values,
+        const ParallelPolicy& policy, const uint32_t runCount)
+    {
+        std::vector<std::chrono::nanoseconds> durations{};
+        durations.reserve(runCount);
+        for(uint32_t i{0}; i != runCount; ++i)
+        {
+            const std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+            ParallelApply(values, policy);
+            durations.push_back(std::chrono::steady_clock::now() - start);
+        }
+
+        std::ranges::sort(durations);
+        const auto toMicroseconds{
+            [](const std::chrono::nanoseconds duration)
+            {
+                return std::chrono::duration<double, std::micro>{duration}.count();
+            }};
+
+        std::cout << std::left << std::setw(40) << name << std::fixed << std::setprecision(1)
+            << "p50 " << toMicroseconds(durations[durations.size() / 2])
+            << "us, p99 " << toMicroseconds(durations[durations.size() * 99 / 100])
+            << "us, max " << toMicroseconds(durations.back()) << "us\n";
+    }
+
+    TEST_CASE("Strategy - Work Stealing - Benchmark")
+    {
+        constexpr uint32_t valueCount{250'000};
+        HeterogeneousValues values{CreateHeterogeneousValues(valueCount)};
+
+        for(const size_t threadCount: {1, 2, 4, 8, 16, 32})
+        {
+            ThreadPool threadPool{threadCount};
+            const std::string suffix{" - " + std::to_string(threadCount) + " Threads"};
+
+            BENCHMARK("Static Shuffled" + suffix)
+            {
+                ParallelApply(values.m_Shuffled, {.m_ThreadPool = &threadPool});
+            };
+
+            BENCHMARK("Work Stealing Shuffled" + suffix)
+            {
+                ParallelApply(values.m_Shuffled,
+                    {.m_ThreadPool = &threadPool, .m_Scheduling = Scheduling::WorkStealing});
+            };
+
+            BENCHMARK("Static Grouped" + suffix)
+            {
+                ParallelApply(values.m_Grouped, {.m_ThreadPool = &threadPool});
+            };
+
+            BENCHMARK("Work Stealing Grouped" + suffix)
+            {
+                ParallelApply(values.m_Grouped,
+                    {.m_ThreadPool = &threadPool, .m_Scheduling = Scheduling::WorkStealing});
+            };
+        }
+    }
+
+    // Tail latency of single runs, which the mean of the benchmark hides. Run with "[latency]".
+    TEST_CASE("Strategy - Work Stealing - Tail Latency", "[.][latency]")
+    {
+        constexpr uint32_t valueCount{250'000};
+        constexpr uint32_t runCount{200};
+        HeterogeneousValues values{CreateHeterogeneousValues(valueCount)};
+
+        for(const size_t threadCount: {1, 2, 4, 8, 16, 32})
+        {
+            ThreadPool threadPool{threadCount};
+            const std::string suffix{" - " + std::to_string(threadCount) + " Threads"};
+
+            ReportLatency("Static Shuffled" + suffix, values.m_Shuffled, {.m_ThreadPool = &threadPool}, runCount);
+            ReportLatency("Work Stealing Shuffled" + suffix, values.m_Shuffled,
+                {.m_ThreadPool = &threadPool, .m_Scheduling = Scheduling::WorkStealing}, runCount);
+            ReportLatency("Static Grouped" + suffix, values.m_Grouped, {.m_ThreadPool = &threadPool}, runCount);
+            ReportLatency("Work Stealing Grouped" + suffix, values.m_Grouped,
+                {.m_ThreadPool = &threadPool, .m_Scheduling = Scheduling::WorkStealing}, runCount);
+        }
+    }
+}
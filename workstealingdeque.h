@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli - "Correct and Efficient Work-Stealing
+// for Weak Memory Models"). The owning worker pushes and pops at the bottom, other workers steal from
+// the top without taking a lock.
+// The capacity is fixed, Reset() may only be called while no worker is using the deque.
+class WorkStealingDeque
+{
+public:
+    enum class StealStatus : uint8_t
+    {
+        Success,
+        Empty,
+        // Lost the race for the top item against another thief or the owner, the deque may still hold items
+        Abort
+    };
+
+    struct StealResult
+    {
+        StealStatus m_Status{StealStatus::Empty};
+        size_t m_Item{0};
+    };
+
+    void Reset(const size_t capacity)
+    {
+        const size_t newCapacity{std::bit_ceil(std::max<size_t>(capacity, 1))};
+        if(newCapacity > m_Capacity)
+        {
+            m_Buffer = std::make_unique<std::atomic<size_t>[]>(newCapacity);
+            m_Capacity = newCapacity;
+        }
+
+        m_Top.store(0, std::memory_order_relaxed);
+        m_Bottom.store(0, std::memory_order_relaxed);
+    }
+
+    // Owner only, or any thread while no worker is using the deque.
+    // At most the capacity passed to Reset() items may be pushed.
+    void Push(const size_t item)
+    {
+        const int64_t bottom{m_Bottom.load(std::memory_order_relaxed)};
+        m_Buffer[static_cast<size_t>(bottom) & (m_Capacity - 1)].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only
+    std::optional<size_t> Pop()
+    {
+        const int64_t bottom{m_Bottom.load(std::memory_order_relaxed) - 1};
+        m_Bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top{m_Top.load(std::memory_order_relaxed)};
+
+        if(top > bottom)
+        {
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        const size_t item{m_Buffer[static_cast<size_t>(bottom) & (m_Capacity - 1)].load(std::memory_order_relaxed)};
+        if(top != bottom)
+            return item;
+
+        // Last item, race against thieves for it
+        const bool won{m_Top.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)};
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won ? std::optional<size_t>{item} : std::nullopt;
+    }
+
+    // Any thread
+    StealResult Steal()
+    {
+        int64_t top{m_Top.load(std::memory_order_acquire)};
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom{m_Bottom.load(std::memory_order_acquire)};
+
+        if(top >= bottom)
+            return {StealStatus::Empty};
+
+        const size_t item{m_Buffer[static_cast<size_t>(top) & (m_Capacity - 1)].load(std::memory_order_relaxed)};
+        if(!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return {StealStatus::Abort};
+
+        return {StealStatus::Success, item};
+    }
+private:
+    // Top and bottom are written by different threads, keep them on separate cache lines
+    alignas(64) std::atomic<int64_t> m_Top{0};
+    alignas(64) std::atomic<int64_t> m_Bottom{0};
+    std::unique_ptr<std::atomic<size_t>[]> m_Buffer{};
+    size_t m_Capacity{0};
+};